@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/types.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+#ifdef _MSC_VER
+#    include <intrin.h>
+#endif
+
+/**
+ * \file bench.h
+ * \brief Minimal microbenchmark harness.
+ *
+ * Each measurement runs the workload in batches, doubling the batch size until a batch takes long
+ * enough to time reliably, then reports the fastest of several batches. The fastest sample is the
+ * one least disturbed by the rest of the system.
+ */
+
+namespace rk::bench
+{
+/**
+ * \brief Prevent the compiler from optimizing away the computation of \a value.
+ */
+template <typename T>
+inline void do_not_optimize(T const& value)
+{
+#ifdef _MSC_VER
+    static_cast<void>(*static_cast<T const volatile*>(&value));
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * \brief Prevent the compiler from assuming memory is unchanged across this point.
+ */
+inline void clobber_memory()
+{
+#ifdef _MSC_VER
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct Result {
+    f64 ns_per_op = 0.0;
+    f64 gflops = 0.0; //!< 0 for operations without a meaningful flop count
+};
+
+struct Config {
+    f64 min_batch_seconds = 0.01;
+    s32 samples = 5;
+};
+
+/**
+ * \brief Time \a workload.
+ *
+ * \param ops_per_call Number of operations one call of \a workload performs.
+ * \param flops_per_op Floating point operations per operation. Used for GFLOP/s.
+ * \param workload Callable run repeatedly.
+ */
+template <typename F>
+Result measure(s64 ops_per_call, f64 flops_per_op, F&& workload, Config const& config = {})
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto time_batch = [&](s64 calls) {
+        Clock::time_point const start = Clock::now();
+        for (s64 i = 0; i < calls; ++i) {
+            workload();
+            clobber_memory();
+        }
+        return std::chrono::duration<f64>(Clock::now() - start).count();
+    };
+
+    workload(); // warm caches
+
+    s64 calls = 1;
+    while (time_batch(calls) < config.min_batch_seconds) { calls *= 2; }
+
+    f64 best = std::numeric_limits<f64>::max();
+    for (s32 i = 0; i < config.samples; ++i) { best = std::min(best, time_batch(calls)); }
+
+    f64 const ops = static_cast<f64>(calls) * static_cast<f64>(ops_per_call);
+    Result r;
+    r.ns_per_op = best * 1e9 / ops;
+    r.gflops = flops_per_op * ops / best * 1e-9;
+    return r;
+}
+
+inline void print_header()
+{
+    std::printf("%-24s %-8s %10s %12s %10s\n", "operation", "variant", "count", "ns/op", "GFLOP/s");
+}
+
+inline void print_result(char const* operation, char const* variant, s32 count, Result const& r)
+{
+    if (r.gflops > 0.0) {
+        std::printf("%-24s %-8s %10d %12.3f %10.2f\n", operation, variant, count, r.ns_per_op,
+                    r.gflops);
+    } else {
+        std::printf("%-24s %-8s %10d %12.3f %10s\n", operation, variant, count, r.ns_per_op, "-");
+    }
+}
+} // namespace rk::bench
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core/types.h"
+
+/**
+ * \file math_kernels.h
+ * \brief SIMD array kernels equivalent to the `Vector3` operations, for benchmarking.
+ *
+ * Component-wise operations work on `Vector3` arrays viewed as flat arrays of 3 * count floats.
+ * Operations that combine components within a vector (dot, cross, length, normalize) work on
+ * structure of arrays input, the layout SIMD code would use for them.
+ */
+
+namespace rk::bench
+{
+struct Vector3_Soa {
+    f32* x;
+    f32* y;
+    f32* z;
+};
+
+struct Const_Vector3_Soa {
+    f32 const* x;
+    f32 const* y;
+    f32 const* z;
+};
+
+struct Math_Kernels {
+    // n is the number of floats
+    void (*add)(f32 const* a, f32 const* b, f32* out, s32 n);
+    void (*sub)(f32 const* a, f32 const* b, f32* out, s32 n);
+    void (*mul)(f32 const* a, f32 const* b, f32* out, s32 n);
+    void (*div)(f32 const* a, f32 const* b, f32* out, s32 n);
+    void (*scale)(f32 const* a, f32 c, f32* out, s32 n);
+
+    // count is the number of vectors
+    void (*dot)(Const_Vector3_Soa a, Const_Vector3_Soa b, f32* out, s32 count);
+    void (*cross)(Const_Vector3_Soa a, Const_Vector3_Soa b, Vector3_Soa out, s32 count);
+    void (*length)(Const_Vector3_Soa a, f32* out, s32 count);
+    void (*unit_vector)(Const_Vector3_Soa a, Vector3_Soa out, s32 count);
+};
+
+/** \brief SSE kernels, or nullptr if the build doesn't target SSE2. */
+Math_Kernels const* sse_math_kernels() noexcept;
+
+/**
+ * \brief AVX kernels, or nullptr if the build doesn't support AVX. Only call them if
+ * `cpu_supports_avx` is true.
+ */
+Math_Kernels const* avx_math_kernels() noexcept;
+
+/** \brief True if the CPU and OS support AVX. */
+bool cpu_supports_avx() noexcept;
+} // namespace rk::bench
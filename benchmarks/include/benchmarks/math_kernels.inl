@@ -0,0 +1,144 @@
+/**
+ * \file math_kernels.inl
+ * \brief Width agnostic kernel bodies, included once per instruction set.
+ *
+ * The including file defines:
+ * - RK_I_V: vector register type
+ * - RK_I_V_WIDTH: floats per register
+ * - RK_I_V_LOAD(p), RK_I_V_STORE(p, v): unaligned load and store
+ * - RK_I_V_SET1(f), RK_I_V_ADD, RK_I_V_SUB, RK_I_V_MUL, RK_I_V_DIV, RK_I_V_SQRT
+ *
+ * Each kernel handles the remainder that doesn't fill a register with scalar code.
+ */
+
+RK_INTERNAL
+void add_kernel(f32 const* RK_RESTRICT a, f32 const* RK_RESTRICT b, f32* RK_RESTRICT out, s32 n)
+{
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= n; i += RK_I_V_WIDTH) {
+        RK_I_V_STORE(out + i, RK_I_V_ADD(RK_I_V_LOAD(a + i), RK_I_V_LOAD(b + i)));
+    }
+    for (; i < n; ++i) { out[i] = a[i] + b[i]; }
+}
+
+RK_INTERNAL
+void sub_kernel(f32 const* RK_RESTRICT a, f32 const* RK_RESTRICT b, f32* RK_RESTRICT out, s32 n)
+{
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= n; i += RK_I_V_WIDTH) {
+        RK_I_V_STORE(out + i, RK_I_V_SUB(RK_I_V_LOAD(a + i), RK_I_V_LOAD(b + i)));
+    }
+    for (; i < n; ++i) { out[i] = a[i] - b[i]; }
+}
+
+RK_INTERNAL
+void mul_kernel(f32 const* RK_RESTRICT a, f32 const* RK_RESTRICT b, f32* RK_RESTRICT out, s32 n)
+{
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= n; i += RK_I_V_WIDTH) {
+        RK_I_V_STORE(out + i, RK_I_V_MUL(RK_I_V_LOAD(a + i), RK_I_V_LOAD(b + i)));
+    }
+    for (; i < n; ++i) { out[i] = a[i] * b[i]; }
+}
+
+RK_INTERNAL
+void div_kernel(f32 const* RK_RESTRICT a, f32 const* RK_RESTRICT b, f32* RK_RESTRICT out, s32 n)
+{
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= n; i += RK_I_V_WIDTH) {
+        RK_I_V_STORE(out + i, RK_I_V_DIV(RK_I_V_LOAD(a + i), RK_I_V_LOAD(b + i)));
+    }
+    for (; i < n; ++i) { out[i] = a[i] / b[i]; }
+}
+
+RK_INTERNAL
+void scale_kernel(f32 const* RK_RESTRICT a, f32 c, f32* RK_RESTRICT out, s32 n)
+{
+    RK_I_V const vc = RK_I_V_SET1(c);
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= n; i += RK_I_V_WIDTH) {
+        RK_I_V_STORE(out + i, RK_I_V_MUL(RK_I_V_LOAD(a + i), vc));
+    }
+    for (; i < n; ++i) { out[i] = a[i] * c; }
+}
+
+RK_INTERNAL
+void dot_kernel(Const_Vector3_Soa a, Const_Vector3_Soa b, f32* RK_RESTRICT out, s32 count)
+{
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= count; i += RK_I_V_WIDTH) {
+        RK_I_V d = RK_I_V_MUL(RK_I_V_LOAD(a.x + i), RK_I_V_LOAD(b.x + i));
+        d = RK_I_V_ADD(d, RK_I_V_MUL(RK_I_V_LOAD(a.y + i), RK_I_V_LOAD(b.y + i)));
+        d = RK_I_V_ADD(d, RK_I_V_MUL(RK_I_V_LOAD(a.z + i), RK_I_V_LOAD(b.z + i)));
+        RK_I_V_STORE(out + i, d);
+    }
+    for (; i < count; ++i) { out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i]; }
+}
+
+RK_INTERNAL
+void cross_kernel(Const_Vector3_Soa a, Const_Vector3_Soa b, Vector3_Soa out, s32 count)
+{
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= count; i += RK_I_V_WIDTH) {
+        RK_I_V const ax = RK_I_V_LOAD(a.x + i);
+        RK_I_V const ay = RK_I_V_LOAD(a.y + i);
+        RK_I_V const az = RK_I_V_LOAD(a.z + i);
+        RK_I_V const bx = RK_I_V_LOAD(b.x + i);
+        RK_I_V const by = RK_I_V_LOAD(b.y + i);
+        RK_I_V const bz = RK_I_V_LOAD(b.z + i);
+        RK_I_V_STORE(out.x + i, RK_I_V_SUB(RK_I_V_MUL(ay, bz), RK_I_V_MUL(az, by)));
+        RK_I_V_STORE(out.y + i, RK_I_V_SUB(RK_I_V_MUL(az, bx), RK_I_V_MUL(ax, bz)));
+        RK_I_V_STORE(out.z + i, RK_I_V_SUB(RK_I_V_MUL(ax, by), RK_I_V_MUL(ay, bx)));
+    }
+    for (; i < count; ++i) {
+        out.x[i] = a.y[i] * b.z[i] - a.z[i] * b.y[i];
+        out.y[i] = a.z[i] * b.x[i] - a.x[i] * b.z[i];
+        out.z[i] = a.x[i] * b.y[i] - a.y[i] * b.x[i];
+    }
+}
+
+RK_INTERNAL
+void length_kernel(Const_Vector3_Soa a, f32* RK_RESTRICT out, s32 count)
+{
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= count; i += RK_I_V_WIDTH) {
+        RK_I_V const x = RK_I_V_LOAD(a.x + i);
+        RK_I_V const y = RK_I_V_LOAD(a.y + i);
+        RK_I_V const z = RK_I_V_LOAD(a.z + i);
+        RK_I_V const sq =
+            RK_I_V_ADD(RK_I_V_ADD(RK_I_V_MUL(x, x), RK_I_V_MUL(y, y)), RK_I_V_MUL(z, z));
+        RK_I_V_STORE(out + i, RK_I_V_SQRT(sq));
+    }
+    for (; i < count; ++i) {
+        out[i] = std::sqrt(a.x[i] * a.x[i] + a.y[i] * a.y[i] + a.z[i] * a.z[i]);
+    }
+}
+
+RK_INTERNAL
+void unit_vector_kernel(Const_Vector3_Soa a, Vector3_Soa out, s32 count)
+{
+    s32 i = 0;
+    for (; i + RK_I_V_WIDTH <= count; i += RK_I_V_WIDTH) {
+        RK_I_V const x = RK_I_V_LOAD(a.x + i);
+        RK_I_V const y = RK_I_V_LOAD(a.y + i);
+        RK_I_V const z = RK_I_V_LOAD(a.z + i);
+        RK_I_V const sq =
+            RK_I_V_ADD(RK_I_V_ADD(RK_I_V_MUL(x, x), RK_I_V_MUL(y, y)), RK_I_V_MUL(z, z));
+        RK_I_V const len = RK_I_V_SQRT(sq);
+        RK_I_V_STORE(out.x + i, RK_I_V_DIV(x, len));
+        RK_I_V_STORE(out.y + i, RK_I_V_DIV(y, len));
+        RK_I_V_STORE(out.z + i, RK_I_V_DIV(z, len));
+    }
+    for (; i < count; ++i) {
+        f32 const len = std::sqrt(a.x[i] * a.x[i] + a.y[i] * a.y[i] + a.z[i] * a.z[i]);
+        out.x[i] = a.x[i] / len;
+        out.y[i] = a.y[i] / len;
+        out.z[i] = a.z[i] / len;
+    }
+}
+
+RK_INTERNAL
+Math_Kernels const kernels = {
+    add_kernel, sub_kernel,   mul_kernel,    div_kernel,        scale_kernel,
+    dot_kernel, cross_kernel, length_kernel, unit_vector_kernel,
+};
@@ -0,0 +1,181 @@
+#include "core/logging/logging.h"
+#include "core/platform/glfw.h"
+#include "core/platform/input_manager.h"
+#include "core/platform/window_manager.h"
+#include "core/renderer/culling.h"
+#include "core/renderer/indirect_mesh_renderer.h"
+#include "core/renderer/opengl/shader_program.h"
+#include "core/renderer/renderer.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/*
+ * GPU culled, multi-draw indirect mesh drawing of 100k cube instances, in GL calls and CPU time.
+ *
+ * Instances are scattered around and behind the camera so about half are culled. The visible count
+ * found by the compute shader is checked against the CPU `cull_spheres`, and the bench fails if
+ * they disagree by more than spheres touching a plane within float rounding could explain.
+ *
+ * Renders headless into an offscreen framebuffer, but still needs a display and an OpenGL 4.6
+ * driver. Mesa's software rasterizer works: LIBGL_ALWAYS_SOFTWARE=1 rtek_indirect_bench
+ */
+
+using namespace rk;
+using namespace sds;
+
+constexpr s32 instance_count = 100'000;
+constexpr s32 iterations = 20;
+constexpr f32 cube_radius = 0.8660254f; // half diagonal of a unit cube
+
+struct Indirect_Result {
+    f64 cpu_us = 0.0;
+    u32 gpu_visible = 0;
+    Render_Stats stats;
+};
+
+RK_INTERNAL
+Status run_indirect_bench(Window& window, std::vector<Mat4> const& models,
+                          Mat4 const& view_projection, Indirect_Result& result)
+{
+    Renderer renderer;
+    Renderer::Config config;
+    config.headless = true;
+    RK_CHECK(renderer.initialize(config));
+    renderer.set_window(window);
+    RK_CHECK(renderer.setup_gl_api());
+
+    Shader_Program shader("mesh_instanced.vert", "identity.frag");
+    RK_CHECK(shader.compile());
+    renderer.set_view_projection(view_projection);
+
+    Indirect_Mesh_Renderer meshes;
+    RK_CHECK(meshes.initialize({}));
+
+    // clang-format off
+    std::array<f32, 8 * 3> const cube_positions = {
+        -0.5f, -0.5f, -0.5f,   0.5f, -0.5f, -0.5f,   0.5f,  0.5f, -0.5f,  -0.5f,  0.5f, -0.5f,
+        -0.5f, -0.5f,  0.5f,   0.5f, -0.5f,  0.5f,   0.5f,  0.5f,  0.5f,  -0.5f,  0.5f,  0.5f,
+    };
+    std::array<u32, 36> const cube_indices = {
+        0, 2, 1, 0, 3, 2,   4, 5, 6, 4, 6, 7,   0, 1, 5, 0, 5, 4,
+        3, 6, 2, 3, 7, 6,   0, 4, 7, 0, 7, 3,   1, 2, 6, 1, 6, 5,
+    };
+    // clang-format on
+    Indirect_Mesh_Renderer::Mesh_Id cube = 0;
+    RK_CHECK(meshes.add_mesh(cube_positions.data(), 8, cube_indices.data(),
+                             static_cast<s32>(cube_indices.size()), cube));
+    for (Mat4 const& model : models) {
+        Indirect_Mesh_Renderer::Instance_Id instance = 0;
+        RK_CHECK(meshes.add_instance(cube, model, instance));
+    }
+
+    using Clock = std::chrono::steady_clock;
+    f64 best_seconds = 1e9;
+    for (s32 i = 0; i < iterations; ++i) {
+        renderer.reset_stats();
+        RK_CHECK(renderer.begin_frame());
+
+        Clock::time_point const start = Clock::now();
+        RK_CHECK(meshes.draw(shader, view_projection, renderer.gl_state(), renderer.stats()));
+        f64 const seconds = std::chrono::duration<f64>(Clock::now() - start).count();
+        best_seconds = std::min(best_seconds, seconds);
+
+        RK_CHECK(renderer.end_frame());
+        glFinish();
+    }
+
+    result.cpu_us = best_seconds * 1e6;
+    result.stats = renderer.stats();
+    RK_CHECK(meshes.read_visible_count(result.gpu_visible));
+    RK_CHECK(renderer.handle_ogl_error());
+
+    RK_CHECK(meshes.destroy());
+    shader.destroy();
+    return renderer.destroy();
+}
+
+RK_INTERNAL
+Status indirect_bench_main()
+{
+    RK_CHECK(Logger::initialize());
+    RK_CHECK(platform::glfw::initialize());
+
+    Window_Manager window_mgr;
+    Input_Manager input_mgr;
+    RK_CHECK(window_mgr.initialize());
+    RK_CHECK(input_mgr.initialize());
+
+    // The window is only needed for its context
+    Renderer::Config window_config;
+    window_config.headless = true;
+    Renderer window_renderer;
+    RK_CHECK(window_renderer.initialize(window_config));
+    RK_CHECK(
+        window_mgr.create_window("rtek_indirect_bench", 800, 600, window_renderer, input_mgr));
+
+    // The camera sits at the origin looking down -z
+    Mat4 const view_projection = Mat4::perspective(1.0f, 800.0f / 600.0f, 0.1f, 300.0f);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<f32> pos_xy(-150.0f, 150.0f);
+    std::uniform_real_distribution<f32> pos_z(-300.0f, 50.0f);
+    std::vector<Mat4> models(instance_count);
+    std::vector<f32> center_x(instance_count);
+    std::vector<f32> center_y(instance_count);
+    std::vector<f32> center_z(instance_count);
+    std::vector<f32> radius(instance_count, cube_radius);
+    for (s32 i = 0; i < instance_count; ++i) {
+        center_x[i] = pos_xy(rng);
+        center_y[i] = pos_xy(rng);
+        center_z[i] = pos_z(rng);
+        models[i] = Mat4::translation({center_x[i], center_y[i], center_z[i]});
+    }
+
+    Sphere_Soa spheres;
+    spheres.center_x = center_x.data();
+    spheres.center_y = center_y.data();
+    spheres.center_z = center_z.data();
+    spheres.radius = radius.data();
+    spheres.count = instance_count;
+    std::vector<u32> visible(instance_count);
+    s32 const cpu_visible = cull_spheres(Frustum::from_view_projection(view_projection), spheres,
+                                         visible.data());
+
+    Indirect_Result r;
+    RK_CHECK(run_indirect_bench(window_mgr.get_window(), models, view_projection, r));
+    std::printf("%10s %10s %10s %10s %10s %10s %10s\n", "instances", "GPU vis", "CPU vis",
+                "GL calls", "skipped", "draws", "CPU us");
+    std::printf("%10d %10u %10d %10u %10u %10u %10.1f\n", instance_count, r.gpu_visible,
+                cpu_visible, r.stats.gl_calls, r.stats.gl_calls_skipped, r.stats.draw_calls,
+                r.cpu_us);
+
+    input_mgr.destroy();
+    window_mgr.destroy();
+    platform::glfw::destroy();
+
+    s32 const difference = std::abs(static_cast<s32>(r.gpu_visible) - cpu_visible);
+    if (difference > instance_count / 1000) {
+        LOG_ERROR("GPU culling found {} visible instances, expected {}", r.gpu_visible,
+                  cpu_visible);
+        return Status::runtime_error;
+    }
+    return Status::ok;
+}
+
+int main()
+{
+    Status const ret = indirect_bench_main();
+    if (ret != Status::ok) {
+        LOG_ERROR("exited with status: {}", to_string(ret));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,277 @@
+#include "benchmarks/bench.h"
+#include "benchmarks/math_kernels.h"
+#include "core/math/vector.h"
+#include "core/types.h"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Benchmarks every operation in core/math/vector.h.
+ *
+ * Single value: each operation applied to a cache resident set of values, one call at a time.
+ * This is what most engine code does. `Vector3` has no SIMD implementation, so only the scalar
+ * variant exists.
+ *
+ * Arrays: each operation applied to whole arrays, at a cache resident and a memory bound size.
+ * "scalar" loops over `Vector3` arrays calling the `Vector3` operations. "sse" and "avx" run the
+ * kernels in math_kernels.h over the same data.
+ *
+ * Usage: rtek_math_bench [filter]
+ * Only operations whose name contains `filter` are run.
+ */
+
+using namespace rk;
+using namespace rk::bench;
+using namespace sds;
+
+/** Values in the single value benchmarks. Small enough to stay in L1. */
+constexpr s32 single_value_count = 256;
+
+/** Array sizes in vectors: fits in L2, and well past the last level cache. */
+constexpr std::array<s32, 2> array_counts = {4096, 1 << 20};
+
+// Flop counts per operation. Square root and division are counted as one flop.
+constexpr f64 flops_component = 3.0;
+constexpr f64 flops_dot = 5.0;
+constexpr f64 flops_cross = 9.0;
+constexpr f64 flops_length = 6.0;
+constexpr f64 flops_unit_vector = 9.0;
+
+struct Data {
+    explicit Data(s32 count)
+    {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<f32> dist(0.5f, 2.0f); // no zeros, division is well defined
+        for (s32 i = 0; i < count; ++i) {
+            a.emplace_back(dist(rng), dist(rng), dist(rng));
+            b.emplace_back(dist(rng), dist(rng), dist(rng));
+        }
+        out.resize(count);
+        scalars.resize(count);
+
+        for (std::vector<f32>* v : {&ax, &ay, &az, &bx, &by, &bz, &ox, &oy, &oz}) {
+            v->resize(count);
+        }
+        for (s32 i = 0; i < count; ++i) {
+            ax[i] = a[i][0];
+            ay[i] = a[i][1];
+            az[i] = a[i][2];
+            bx[i] = b[i][0];
+            by[i] = b[i][1];
+            bz[i] = b[i][2];
+        }
+    }
+
+    s32 count() const { return static_cast<s32>(a.size()); }
+    s32 components() const { return 3 * count(); }
+
+    f32 const* flat_a() const { return reinterpret_cast<f32 const*>(a.data()); }
+    f32 const* flat_b() const { return reinterpret_cast<f32 const*>(b.data()); }
+    f32* flat_out() { return reinterpret_cast<f32*>(out.data()); }
+
+    Const_Vector3_Soa soa_a() const { return {ax.data(), ay.data(), az.data()}; }
+    Const_Vector3_Soa soa_b() const { return {bx.data(), by.data(), bz.data()}; }
+    Vector3_Soa soa_out() { return {ox.data(), oy.data(), oz.data()}; }
+
+    std::vector<Vector3> a, b, out;
+    std::vector<f32> scalars;
+    std::vector<f32> ax, ay, az, bx, by, bz, ox, oy, oz;
+};
+
+class Runner {
+public:
+    explicit Runner(char const* filter) : m_filter(filter) {}
+
+    bool enabled(char const* operation) const
+    {
+        return !m_filter || std::strstr(operation, m_filter) != nullptr;
+    }
+
+    /**
+     * \brief Benchmark \a op applied to each value in \a d. \a op returns the value to sink.
+     */
+    template <typename F>
+    void single(char const* operation, f64 flops, Data& d, F&& op)
+    {
+        if (!enabled(operation)) { return; }
+        Result const r = measure(d.count(), flops, [&]() {
+            for (s32 i = 0; i < d.count(); ++i) { do_not_optimize(op(d, i)); }
+        });
+        print_result(operation, "scalar", 1, r);
+    }
+
+    /**
+     * \brief Benchmark a whole array operation. \a workload processes all of \a d.
+     */
+    template <typename F>
+    void array(char const* operation, char const* variant, f64 flops, Data& d, F&& workload)
+    {
+        if (!enabled(operation)) { return; }
+        Result const r = measure(d.count(), flops, [&]() { workload(d); });
+        print_result(operation, variant, d.count(), r);
+    }
+
+private:
+    char const* m_filter;
+};
+
+RK_INTERNAL
+void bench_single_values(Runner& run)
+{
+    Data d(single_value_count);
+
+    run.single("unary_plus", 0.0, d, [](Data& d, s32 i) { return +d.a[i]; });
+    run.single("negate", 3.0, d, [](Data& d, s32 i) { return -d.a[i]; });
+    run.single("x_y_z", 0.0, d,
+               [](Data& d, s32 i) { return d.a[i].x() + d.a[i].y() + d.a[i].z(); });
+    run.single("index", 0.0, d, [](Data& d, s32 i) { return d.a[i][i % 3]; });
+
+    run.single("add", flops_component, d, [](Data& d, s32 i) { return d.a[i] + d.b[i]; });
+    run.single("sub", flops_component, d, [](Data& d, s32 i) { return d.a[i] - d.b[i]; });
+    run.single("mul", flops_component, d, [](Data& d, s32 i) { return d.a[i] * d.b[i]; });
+    run.single("div", flops_component, d, [](Data& d, s32 i) { return d.a[i] / d.b[i]; });
+    run.single("scale", flops_component, d, [](Data& d, s32 i) { return d.a[i] * 1.5f; });
+    run.single("scale_lhs", flops_component, d, [](Data& d, s32 i) { return 1.5f * d.a[i]; });
+    run.single("div_scalar", flops_component, d, [](Data& d, s32 i) { return d.a[i] / 1.5f; });
+
+    // Compound assignment on a copy, so values don't drift into infinities or denormals
+    run.single("add_assign", flops_component, d, [](Data& d, s32 i) {
+        Vector3 v = d.a[i];
+        return v += d.b[i];
+    });
+    run.single("sub_assign", flops_component, d, [](Data& d, s32 i) {
+        Vector3 v = d.a[i];
+        return v -= d.b[i];
+    });
+    run.single("mul_assign", flops_component, d, [](Data& d, s32 i) {
+        Vector3 v = d.a[i];
+        return v *= d.b[i];
+    });
+    run.single("div_assign", flops_component, d, [](Data& d, s32 i) {
+        Vector3 v = d.a[i];
+        return v /= d.b[i];
+    });
+    run.single("scale_assign", flops_component, d, [](Data& d, s32 i) {
+        Vector3 v = d.a[i];
+        return v *= 1.5f;
+    });
+    run.single("div_scalar_assign", flops_component, d, [](Data& d, s32 i) {
+        Vector3 v = d.a[i];
+        return v /= 1.5f;
+    });
+
+    run.single("dot", flops_dot, d, [](Data& d, s32 i) { return dot(d.a[i], d.b[i]); });
+    run.single("cross", flops_cross, d, [](Data& d, s32 i) { return cross(d.a[i], d.b[i]); });
+    run.single("length", flops_length, d, [](Data& d, s32 i) { return d.a[i].length(); });
+    run.single("squared_length", flops_dot, d,
+               [](Data& d, s32 i) { return d.a[i].squared_length(); });
+    run.single("unit_vector", flops_unit_vector, d,
+               [](Data& d, s32 i) { return unit_vector(d.a[i]); });
+    run.single("make_unit_vector", flops_unit_vector, d, [](Data& d, s32 i) {
+        Vector3 v = d.a[i];
+        v.make_unit_vector();
+        return v;
+    });
+    run.single("is_nan", 0.0, d, [](Data& d, s32 i) { return d.a[i].is_nan(); });
+    run.single("equal", 0.0, d, [](Data& d, s32 i) { return d.a[i] == d.b[i]; });
+    run.single("not_equal", 0.0, d, [](Data& d, s32 i) { return d.a[i] != d.b[i]; });
+
+    run.single("to_string", 0.0, d, [](Data& d, s32 i) { return d.a[i].to_string().size(); });
+    run.single("ostream", 0.0, d, [](Data& d, s32 i) {
+        std::ostringstream os;
+        os << d.a[i];
+        return os.tellp();
+    });
+    run.single("istream", 0.0, d, [](Data& d, s32 i) {
+        std::istringstream is("1.5 -2.25 3");
+        is >> d.out[i];
+        return d.out[i];
+    });
+}
+
+RK_INTERNAL
+void bench_arrays(Runner& run, s32 count)
+{
+    Data d(count);
+
+    // Scalar reference through the Vector3 interface
+    run.array("array_add", "scalar", flops_component, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.out[i] = d.a[i] + d.b[i]; }
+    });
+    run.array("array_sub", "scalar", flops_component, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.out[i] = d.a[i] - d.b[i]; }
+    });
+    run.array("array_mul", "scalar", flops_component, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.out[i] = d.a[i] * d.b[i]; }
+    });
+    run.array("array_div", "scalar", flops_component, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.out[i] = d.a[i] / d.b[i]; }
+    });
+    run.array("array_scale", "scalar", flops_component, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.out[i] = d.a[i] * 1.5f; }
+    });
+    run.array("array_dot", "scalar", flops_dot, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.scalars[i] = dot(d.a[i], d.b[i]); }
+    });
+    run.array("array_cross", "scalar", flops_cross, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.out[i] = cross(d.a[i], d.b[i]); }
+    });
+    run.array("array_length", "scalar", flops_length, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.scalars[i] = d.a[i].length(); }
+    });
+    run.array("array_unit_vector", "scalar", flops_unit_vector, d, [](Data& d) {
+        for (s32 i = 0; i < d.count(); ++i) { d.out[i] = unit_vector(d.a[i]); }
+    });
+
+    struct Variant {
+        char const* name;
+        Math_Kernels const* kernels;
+    };
+    Variant const variants[] = {
+        {"sse", sse_math_kernels()},
+        {"avx", cpu_supports_avx() ? avx_math_kernels() : nullptr},
+    };
+
+    for (Variant const& v : variants) {
+        if (!v.kernels) {
+            std::printf("%-24s %-8s unavailable\n", "array_*", v.name);
+            continue;
+        }
+        Math_Kernels const& k = *v.kernels;
+
+        run.array("array_add", v.name, flops_component, d,
+                  [&](Data& d) { k.add(d.flat_a(), d.flat_b(), d.flat_out(), d.components()); });
+        run.array("array_sub", v.name, flops_component, d,
+                  [&](Data& d) { k.sub(d.flat_a(), d.flat_b(), d.flat_out(), d.components()); });
+        run.array("array_mul", v.name, flops_component, d,
+                  [&](Data& d) { k.mul(d.flat_a(), d.flat_b(), d.flat_out(), d.components()); });
+        run.array("array_div", v.name, flops_component, d,
+                  [&](Data& d) { k.div(d.flat_a(), d.flat_b(), d.flat_out(), d.components()); });
+        run.array("array_scale", v.name, flops_component, d,
+                  [&](Data& d) { k.scale(d.flat_a(), 1.5f, d.flat_out(), d.components()); });
+        run.array("array_dot", v.name, flops_dot, d,
+                  [&](Data& d) { k.dot(d.soa_a(), d.soa_b(), d.scalars.data(), d.count()); });
+        run.array("array_cross", v.name, flops_cross, d,
+                  [&](Data& d) { k.cross(d.soa_a(), d.soa_b(), d.soa_out(), d.count()); });
+        run.array("array_length", v.name, flops_length, d,
+                  [&](Data& d) { k.length(d.soa_a(), d.scalars.data(), d.count()); });
+        run.array("array_unit_vector", v.name, flops_unit_vector, d,
+                  [&](Data& d) { k.unit_vector(d.soa_a(), d.soa_out(), d.count()); });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Runner run(argc > 1 ? argv[1] : nullptr);
+
+    print_header();
+    bench_single_values(run);
+    for (s32 count : array_counts) { bench_arrays(run, count); }
+
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include "benchmarks/math_kernels.h"
+
+#include "core/math/simd.h"
+#include <cmath>
+
+// Built with AVX code generation enabled (see CMakeLists.txt). Nothing here may run unless
+// `cpu_supports_avx` is true.
+
+using namespace rk;
+using namespace rk::bench;
+using namespace sds;
+
+#if RK_SIMD_AVX
+#    define RK_I_V              __m256
+#    define RK_I_V_WIDTH        8
+#    define RK_I_V_LOAD(p)      _mm256_loadu_ps(p)
+#    define RK_I_V_STORE(p, v)  _mm256_storeu_ps((p), (v))
+#    define RK_I_V_SET1(f)      _mm256_set1_ps(f)
+#    define RK_I_V_ADD(a, b)    _mm256_add_ps((a), (b))
+#    define RK_I_V_SUB(a, b)    _mm256_sub_ps((a), (b))
+#    define RK_I_V_MUL(a, b)    _mm256_mul_ps((a), (b))
+#    define RK_I_V_DIV(a, b)    _mm256_div_ps((a), (b))
+#    define RK_I_V_SQRT(a)      _mm256_sqrt_ps(a)
+#    include "benchmarks/math_kernels.inl"
+
+Math_Kernels const* rk::bench::avx_math_kernels() noexcept { return &kernels; }
+#else
+Math_Kernels const* rk::bench::avx_math_kernels() noexcept { return nullptr; }
+#endif
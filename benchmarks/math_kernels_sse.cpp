@@ -0,0 +1,47 @@
+#include "benchmarks/math_kernels.h"
+
+#include "core/math/simd.h"
+#include <array>
+#include <cmath>
+
+#ifdef _MSC_VER
+#    include <intrin.h>
+#endif
+
+using namespace rk;
+using namespace rk::bench;
+using namespace sds;
+
+#if RK_SIMD_SSE
+#    define RK_I_V              __m128
+#    define RK_I_V_WIDTH        4
+#    define RK_I_V_LOAD(p)      _mm_loadu_ps(p)
+#    define RK_I_V_STORE(p, v)  _mm_storeu_ps((p), (v))
+#    define RK_I_V_SET1(f)      _mm_set1_ps(f)
+#    define RK_I_V_ADD(a, b)    _mm_add_ps((a), (b))
+#    define RK_I_V_SUB(a, b)    _mm_sub_ps((a), (b))
+#    define RK_I_V_MUL(a, b)    _mm_mul_ps((a), (b))
+#    define RK_I_V_DIV(a, b)    _mm_div_ps((a), (b))
+#    define RK_I_V_SQRT(a)      _mm_sqrt_ps(a)
+#    include "benchmarks/math_kernels.inl"
+
+Math_Kernels const* rk::bench::sse_math_kernels() noexcept { return &kernels; }
+#else
+Math_Kernels const* rk::bench::sse_math_kernels() noexcept { return nullptr; }
+#endif
+
+bool rk::bench::cpu_supports_avx() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    std::array<int, 4> info;
+    __cpuid(info.data(), 1);
+    bool const has_avx = (info[2] & (1 << 28)) != 0;
+    bool const has_osxsave = (info[2] & (1 << 27)) != 0;
+    // The OS must save the YMM registers on context switch
+    return has_avx && has_osxsave && (_xgetbv(0) & 0x6) == 0x6;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_cpu_supports("avx");
+#else
+    return false;
+#endif
+}
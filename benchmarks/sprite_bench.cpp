@@ -0,0 +1,146 @@
+#include "core/logging/logging.h"
+#include "core/platform/glfw.h"
+#include "core/platform/input_manager.h"
+#include "core/platform/window_manager.h"
+#include "core/renderer/opengl/shader_program.h"
+#include "core/renderer/renderer.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/*
+ * Sprite submission cost for 100k sprites a frame, in GL calls and CPU time.
+ *
+ * Sprites use a few textures and layers, added in random order like a scene with interleaved
+ * objects. CPU time covers queueing, sorting and submitting the sprites. The GPU is drained between
+ * iterations and that time is excluded.
+ *
+ * Renders headless into an offscreen framebuffer, but still needs a display and an OpenGL 4.6
+ * driver.
+ */
+
+using namespace rk;
+using namespace sds;
+
+constexpr s32 sprite_count = 100'000;
+constexpr s32 texture_count = 4;
+constexpr s32 layer_count = 3;
+constexpr s32 iterations = 50;
+
+struct Sprite_Result {
+    f64 cpu_us = 0.0;
+    Render_Stats stats;
+};
+
+RK_INTERNAL
+Status run_sprite_bench(Window& window, std::vector<Sprite> const& sprites, Sprite_Result& result)
+{
+    Renderer renderer;
+    Renderer::Config config;
+    config.headless = true;
+    config.sprite_batch_capacity = sprite_count;
+    RK_CHECK(renderer.initialize(config));
+    renderer.set_window(window);
+    RK_CHECK(renderer.setup_gl_api());
+
+    Shader_Program shader("sprite.vert", "sprite.frag");
+    RK_CHECK(shader.compile());
+
+    using Clock = std::chrono::steady_clock;
+    f64 best_seconds = 1e9;
+    for (s32 i = 0; i < iterations; ++i) {
+        renderer.reset_stats();
+        RK_CHECK(renderer.begin_frame());
+
+        Clock::time_point const start = Clock::now();
+        for (Sprite const& sprite : sprites) { RK_CHECK(renderer.queue_sprite(sprite)); }
+        RK_CHECK(renderer.flush_sprites(shader));
+        f64 const seconds = std::chrono::duration<f64>(Clock::now() - start).count();
+        best_seconds = std::min(best_seconds, seconds);
+
+        RK_CHECK(renderer.end_frame());
+        glFinish();
+    }
+
+    result.cpu_us = best_seconds * 1e6;
+    result.stats = renderer.stats();
+    RK_CHECK(renderer.handle_ogl_error());
+
+    shader.destroy();
+    return renderer.destroy();
+}
+
+RK_INTERNAL
+Status sprite_bench_main()
+{
+    RK_CHECK(Logger::initialize());
+    RK_CHECK(platform::glfw::initialize());
+
+    Window_Manager window_mgr;
+    Input_Manager input_mgr;
+    RK_CHECK(window_mgr.initialize());
+    RK_CHECK(input_mgr.initialize());
+
+    // The window is only needed for its context
+    Renderer::Config window_config;
+    window_config.headless = true;
+    Renderer window_renderer;
+    RK_CHECK(window_renderer.initialize(window_config));
+    RK_CHECK(window_mgr.create_window("rtek_sprite_bench", 800, 600, window_renderer, input_mgr));
+
+    // Small solid color textures, the texel data doesn't matter
+    std::array<u32, texture_count> textures = {};
+    glGenTextures(texture_count, textures.data());
+    for (u32 texture : textures) {
+        std::array<u8, 4 * 4 * 4> texels;
+        texels.fill(255);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     texels.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<f32> pos_x(0.0f, 800.0f);
+    std::uniform_real_distribution<f32> pos_y(0.0f, 600.0f);
+    std::uniform_int_distribution<s32> pick_texture(0, texture_count - 1);
+    std::uniform_int_distribution<s32> pick_layer(0, layer_count - 1);
+    std::vector<Sprite> sprites(sprite_count);
+    for (Sprite& sprite : sprites) {
+        sprite.position = {pos_x(rng), pos_y(rng)};
+        sprite.size = {8.0f, 8.0f};
+        sprite.texture_id = textures[pick_texture(rng)];
+        sprite.layer = static_cast<s16>(pick_layer(rng));
+    }
+
+    Sprite_Result r;
+    RK_CHECK(run_sprite_bench(window_mgr.get_window(), sprites, r));
+    std::printf("%10s %10s %10s %10s %10s %12s %10s\n", "sprites", "GL calls", "skipped", "draws",
+                "binds", "streamed KB", "CPU us");
+    std::printf("%10u %10u %10u %10u %10u %12u %10.1f\n", r.stats.sprites, r.stats.gl_calls,
+                r.stats.gl_calls_skipped, r.stats.draw_calls, r.stats.texture_binds,
+                r.stats.stream_bytes / 1024, r.cpu_us);
+
+    glDeleteTextures(texture_count, textures.data());
+    input_mgr.destroy();
+    window_mgr.destroy();
+    platform::glfw::destroy();
+    return Status::ok;
+}
+
+int main()
+{
+    Status const ret = sprite_bench_main();
+    if (ret != Status::ok) {
+        LOG_ERROR("exited with status: {}", to_string(ret));
+        return 1;
+    }
+    return 0;
+}
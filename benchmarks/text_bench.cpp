@@ -0,0 +1,178 @@
+#include "core/logging/logging.h"
+#include "core/platform/glfw.h"
+#include "core/platform/input_manager.h"
+#include "core/platform/window_manager.h"
+#include "core/renderer/frame_capture.h"
+#include "core/renderer/opengl/shader_program.h"
+#include "core/renderer/renderer.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Text rendering cost per 1000 glyphs, in GL calls and CPU time.
+ *
+ * "per_glyph" sets the text batch capacity to one glyph, which issues a buffer upload and draw for
+ * every glyph. "batched" uses the default capacity. "layout" draws the same text from cached
+ * `Text_Layout`s, like static HUD text.
+ *
+ * CPU time covers queueing and submitting the text. The GPU is drained between iterations and that
+ * time is excluded.
+ *
+ * With `--dump DIRECTORY`, the last frame of each mode is written to DIRECTORY/text_<mode>.png, for
+ * comparing against golden images.
+ *
+ * Renders headless into an offscreen framebuffer, but still needs a display and an OpenGL 4.6
+ * driver.
+ */
+
+using namespace rk;
+using namespace sds;
+
+constexpr s32 glyph_count = 1000;
+constexpr s32 iterations = 200;
+
+struct Text_Result {
+    f64 cpu_us = 0.0;
+    Render_Stats stats;
+};
+
+RK_INTERNAL
+Status run_text_bench(Window& window, s32 batch_capacity, bool use_layouts,
+                      std::string const& text, char const* dump_path, Text_Result& result)
+{
+    Renderer renderer;
+    Renderer::Config config;
+    config.headless = true;
+    config.text_batch_capacity = batch_capacity;
+    RK_CHECK(renderer.initialize(config));
+    renderer.set_window(window);
+    RK_CHECK(renderer.setup_gl_api());
+    RK_CHECK(renderer.load_font_glyphs());
+
+    Shader_Program shader("font_glyphs.vert", renderer.text_fragment_shader());
+    RK_CHECK(shader.compile());
+
+    constexpr s32 line_count = glyph_count / 100;
+    Text_Layout layouts[line_count];
+
+    using Clock = std::chrono::steady_clock;
+    f64 best_seconds = 1e9;
+    for (s32 i = 0; i < iterations; ++i) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        renderer.reset_stats();
+        RK_CHECK(renderer.begin_frame());
+
+        Clock::time_point const start = Clock::now();
+        // Ten lines of 100 glyphs, like a busy debug overlay
+        for (s32 line = 0; line < line_count; ++line) {
+            std::string_view const line_text = std::string_view(text).substr(line * 100, 100);
+            glm::vec3 const color(1.0f, 1.0f, 1.0f);
+            if (use_layouts) {
+                RK_CHECK(renderer.layout_text(layouts[line], line_text, 0.0f, 20.0f * line, 0.25f,
+                                              color));
+                RK_CHECK(renderer.draw_text_layout(shader, layouts[line]));
+            } else {
+                RK_CHECK(renderer.queue_text(line_text, 0.0f, 20.0f * line, 0.25f, color));
+            }
+        }
+        RK_CHECK(renderer.flush_text(shader));
+        f64 const seconds = std::chrono::duration<f64>(Clock::now() - start).count();
+        best_seconds = std::min(best_seconds, seconds);
+
+        RK_CHECK(renderer.end_frame());
+        glFinish();
+    }
+
+    result.cpu_us = best_seconds * 1e6;
+    result.stats = renderer.stats();
+    RK_CHECK(renderer.handle_ogl_error());
+
+    if (dump_path) {
+        std::vector<u8> frame;
+        s32 width = 0;
+        s32 height = 0;
+        RK_CHECK(renderer.read_frame(frame, width, height));
+        RK_CHECK(write_image(dump_path, Image_Format::png, frame.data(), width, height));
+    }
+
+    for (Text_Layout& layout : layouts) { renderer.destroy_text_layout(layout); }
+    shader.destroy();
+    return renderer.destroy();
+}
+
+RK_INTERNAL
+Status text_bench_main(char const* dump_dir)
+{
+    RK_CHECK(Logger::initialize());
+    RK_CHECK(platform::glfw::initialize());
+
+    Window_Manager window_mgr;
+    Input_Manager input_mgr;
+    RK_CHECK(window_mgr.initialize());
+    RK_CHECK(input_mgr.initialize());
+
+    // The window is only needed for its context
+    Renderer::Config window_config;
+    window_config.headless = true;
+    Renderer window_renderer;
+    RK_CHECK(window_renderer.initialize(window_config));
+    RK_CHECK(window_mgr.create_window("rtek_text_bench", 800, 600, window_renderer, input_mgr));
+
+    // Printable ASCII, no spaces so every character is a drawn glyph
+    std::string text;
+    for (s32 i = 0; i < glyph_count; ++i) { text.push_back(static_cast<char>('!' + i % 94)); }
+
+    std::printf("%-10s %14s %12s %12s %12s %12s %14s\n", "mode", "GL calls/1k", "skipped/1k",
+                "draws/1k", "binds/1k", "uploads/1k", "CPU us/1k");
+    struct Mode {
+        char const* name;
+        s32 batch_capacity;
+        bool use_layouts;
+    };
+    s32 const default_capacity = Renderer::Config{}.text_batch_capacity;
+    Mode const modes[] = {
+        {"per_glyph", 1, false},
+        {"batched", default_capacity, false},
+        {"layout", default_capacity, true},
+    };
+    for (Mode const& mode : modes) {
+        std::string dump_path;
+        if (dump_dir) { dump_path = std::string(dump_dir) + "/text_" + mode.name + ".png"; }
+
+        Text_Result r;
+        RK_CHECK(run_text_bench(window_mgr.get_window(), mode.batch_capacity, mode.use_layouts,
+                                text, dump_dir ? dump_path.c_str() : nullptr, r));
+        std::printf("%-10s %14u %12u %12u %12u %12u %14.1f\n", mode.name, r.stats.gl_calls,
+                    r.stats.gl_calls_skipped, r.stats.draw_calls, r.stats.texture_binds,
+                    r.stats.buffer_uploads, r.cpu_us);
+    }
+
+    input_mgr.destroy();
+    window_mgr.destroy();
+    platform::glfw::destroy();
+    return Status::ok;
+}
+
+int main(int argc, char* argv[])
+{
+    char const* dump_dir = nullptr;
+    if (argc == 3 && std::strcmp(argv[1], "--dump") == 0) {
+        dump_dir = argv[2];
+    } else if (argc != 1) {
+        std::fprintf(stderr, "usage: rtek_text_bench [--dump DIRECTORY]\n");
+        return 2;
+    }
+
+    Status const ret = text_bench_main(dump_dir);
+    if (ret != Status::ok) {
+        LOG_ERROR("exited with status: {}", to_string(ret));
+        return 1;
+    }
+    return 0;
+}
@@ -1,12 +1,12 @@
-#version 330 core
+#version 460 core
 in vec2 tex_coords;
+in vec4 text_color;
 out vec4 color;
 
 uniform sampler2D glyph_bitmap;
-uniform vec3 text_color;
 
 void main()
 {
     vec4 sampled = vec4(1.0, 1.0, 1.0, texture(glyph_bitmap, tex_coords).r);
-    color = vec4(text_color, 1.0) * sampled;
+    color = text_color * sampled;
 }
\ No newline at end of file
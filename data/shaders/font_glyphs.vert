@@ -1,11 +1,19 @@
-#version 330 core
+#version 460 core
 layout (location = 0) in vec4 vertex; // vec2 pos, vec2 tex
+layout (location = 1) in vec4 color;
 out vec2 tex_coords;
+out vec4 text_color;
 
-uniform mat4 projection;
+// Frame_Uniforms, shared by every program
+layout (std140, binding = 0) uniform Frame {
+    mat4 screen_projection;
+    mat4 view_projection;
+    vec4 viewport; // xy size in pixels, zw 1 / size
+};
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
+    gl_Position = screen_projection * vec4(vertex.xy, 0.0, 1.0);
     tex_coords = vertex.zw;
+    text_color = color;
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 460 core
+in vec2 tex_coords;
+in vec4 text_color;
+out vec4 color;
+
+uniform sampler2D glyph_bitmap;
+
+void main()
+{
+    // Signed distance field, 0.5 on the glyph outline and increasing inwards
+    float distance = texture(glyph_bitmap, tex_coords).r;
+    // Antialias over about one screen pixel, whatever the text scale
+    float smoothing = 0.7 * fwidth(distance);
+    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    color = vec4(text_color.rgb, text_color.a * alpha);
+}
\ No newline at end of file
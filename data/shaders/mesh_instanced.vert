@@ -0,0 +1,14 @@
+#version 460 core
+layout (location = 0) in vec3 a_pos;
+layout (location = 3) in mat4 a_model; // per instance, locations 3 to 6
+
+// Frame_Uniforms, shared by every program
+layout (std140, binding = 0) uniform Frame {
+    mat4 screen_projection;
+    mat4 view_projection;
+    vec4 viewport; // xy size in pixels, zw 1 / size
+};
+
+void main() {
+    gl_Position = view_projection * a_model * vec4(a_pos, 1.0);
+}
\ No newline at end of file
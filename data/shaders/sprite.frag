@@ -0,0 +1,11 @@
+#version 460 core
+in vec2 tex_coords;
+in vec4 sprite_color;
+out vec4 color;
+
+uniform sampler2D sprite_texture;
+
+void main()
+{
+    color = sprite_color * texture(sprite_texture, tex_coords);
+}
\ No newline at end of file
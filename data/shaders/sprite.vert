@@ -0,0 +1,22 @@
+#version 460 core
+layout (location = 0) in vec4 rect;    // vec2 pos, vec2 size
+layout (location = 1) in vec4 uv_rect; // vec2 uv min, vec2 uv max
+layout (location = 2) in vec4 color;
+out vec2 tex_coords;
+out vec4 sprite_color;
+
+// Frame_Uniforms, shared by every program
+layout (std140, binding = 0) uniform Frame {
+    mat4 screen_projection;
+    mat4 view_projection;
+    vec4 viewport; // xy size in pixels, zw 1 / size
+};
+
+void main()
+{
+    // Per instance quad drawn as a triangle strip: (0, 0), (1, 0), (0, 1), (1, 1)
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    gl_Position = screen_projection * vec4(rect.xy + corner * rect.zw, 0.0, 1.0);
+    tex_coords = mix(uv_rect.xy, uv_rect.zw, corner);
+    sprite_color = color;
+}
\ No newline at end of file
@@ -1,25 +1,31 @@
 #include "core/core.h"
 
 #include "core/assert.h"
+#include "core/ecs/systems/mesh_render_system.h"
 #include "core/logging/logging.h"
 #include "core/platform/glfw.h"
 #include "core/renderer/opengl/shader_program.h"
-#include "core/utility/fixme.h"
+#include "core/utility/frame_pipeline.h"
 #include "core/utility/no_exception.h"
 #include "core/utility/stb_image.h"
 #include <sds/array/array.h>
 #include <sds/array/make_array.h>
-#include <glm/ext/matrix_clip_space.hpp>
-#include <glm/mat4x4.hpp>
+#include <array>
+#include <thread>
 
 using namespace rk;
 using namespace sds;
 
 
-Status Rtek_Engine::initialize() noexcept
+Status Rtek_Engine::initialize(Config config) noexcept
 {
     RK_CHECK(Logger::initialize());
     LOG_INFO("Logger initialized");
+    if (config.frame_pipeline_depth <= 0) {
+        LOG_ERROR("Frame pipeline depth must be positive, got {}", config.frame_pipeline_depth);
+        return Status::invalid_value;
+    }
+    m_config = config;
     LOG_INFO("Initializing engine...");
 
     LOG_INFO("Initializing GLFW...");
@@ -45,6 +51,8 @@ Status Rtek_Engine::initialize() noexcept
         return Status::ok;
     }));
     Renderer::Config renderer_config = {};
+    renderer_config.gpu_profiler.log_interval = 600; // about every 10 seconds at 60 fps
+    renderer_config.frame_pacing.log_interval = 600;
 #ifdef RK_OGL_DEBUG
     // TODO: set based on CLI args
     renderer_config.enable_debug = true;
@@ -84,22 +92,13 @@ Status Rtek_Engine::destroy() noexcept
 
 Status Rtek_Engine::run() noexcept
 {
-    Shader_Program simple_shader("identity.vert", "identity.frag");
-    RK_CHECK(simple_shader.compile());
-
-    Shader_Program text_shader("font_glyphs.vert", "font_glyphs.frag");
-    {
-        RK_CHECK(text_shader.compile());
-
-        // ortho projection (text always renders in screen space... for now)
-        // Setup matrix so that vertex coodinates are 1:1 with screen space
-        s32 win_w = 0;
-        s32 win_h = 0;
-        RK_CHECK(m_window_mgr->get_window().get_window_size(win_w, win_h));
-        g_renderer_state.screen_ortho_projection = glm::ortho(0.0f, static_cast<f32>(win_w), 0.0f, static_cast<f32>(win_h));
-        text_shader.use();
-        text_shader.set_mat4("projection", g_renderer_state.screen_ortho_projection);
-    }
+    // Projections come from the renderer's frame uniforms, no per program uniforms to set
+    Shader_Program mesh_shader("mesh_instanced.vert", "identity.frag");
+    RK_CHECK(mesh_shader.compile());
+    Shader_Program text_shader("font_glyphs.vert", m_renderer->text_fragment_shader());
+    RK_CHECK(text_shader.compile());
+    // The rectangles are placed in clip space
+    m_renderer->set_view_projection(Mat4::identity());
 
     constexpr auto vertices =
         sds::make_array<f32>(-0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f, 0.0f, 0.5f, 0.0f);
@@ -117,74 +116,184 @@ Status Rtek_Engine::run() noexcept
     u32 rectangle_vao = 0;
     u32 rectangle_vbo = 0;
     u32 rectangle_ebo = 0;
-    glGenVertexArrays(1, &rectangle_vao);
-    glGenBuffers(1, &rectangle_vbo);
-    glGenBuffers(1, &rectangle_ebo);
+    glCreateVertexArrays(1, &rectangle_vao);
+    glCreateBuffers(1, &rectangle_vbo);
+    glCreateBuffers(1, &rectangle_ebo);
 
     { // Config rectangle vao
-        glBindVertexArray(rectangle_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, rectangle_vbo);
-        glBufferData(GL_ARRAY_BUFFER, sds::byte_size(rectangle_vertices), rectangle_vertices.data(),
-                     GL_STATIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rectangle_ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sds::byte_size(rectangle_indicies),
-                     rectangle_indicies.data(), GL_STATIC_DRAW);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(f32), nullptr);
-        glEnableVertexAttribArray(0);
-
-        // glVertexAttribPointer registered the vbo as the vertex attributes buffer. Can safely
-        // unbind.
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        glNamedBufferData(rectangle_vbo, sds::byte_size(rectangle_vertices),
+                          rectangle_vertices.data(), GL_STATIC_DRAW);
+        glNamedBufferData(rectangle_ebo, sds::byte_size(rectangle_indicies),
+                          rectangle_indicies.data(), GL_STATIC_DRAW);
+        glVertexArrayVertexBuffer(rectangle_vao, 0, rectangle_vbo, 0, 3 * sizeof(f32));
+        glVertexArrayElementBuffer(rectangle_vao, rectangle_ebo);
+        glEnableVertexArrayAttrib(rectangle_vao, 0);
+        glVertexArrayAttribFormat(rectangle_vao, 0, 3, GL_FLOAT, GL_FALSE, 0);
+        glVertexArrayAttribBinding(rectangle_vao, 0, 0);
+    }
+
+    // A row of rectangles, drawn with one instanced call
+    constexpr u8 world_layer = 0;
+    ecs::Mesh_Render_System mesh_render_system;
+    ecs::Mesh_Render_System::Mesh_Id rectangle_mesh = 0;
+    ecs::Mesh_Render_System::Material_Id mesh_material = 0;
+    RK_CHECK(mesh_render_system.add_mesh(
+        {rectangle_vao, static_cast<s32>(rectangle_indicies.size()), false}, rectangle_mesh));
+    RK_CHECK(mesh_render_system.add_material({&mesh_shader, 0}, mesh_material));
+
+    constexpr s32 rectangle_count = 3;
+    using Rectangle_Transforms = std::array<ecs::Transform_Component, rectangle_count>;
+    // Simulated on the main thread, and copied into the frame packet for the renderer
+    Rectangle_Transforms rectangle_transforms;
+    // Copy of the packet's transforms the render system reads, owned by the rendering thread
+    Rectangle_Transforms render_transforms;
+    std::array<ecs::Mesh_Renderer_Component, rectangle_count> rectangle_renderers;
+    for (s32 i = 0; i < rectangle_count; ++i) {
+        rectangle_transforms[i].position = Vector3(-0.6f + 0.6f * i, 0.0f, 0.0f);
+        rectangle_transforms[i].scale = Vector3(0.4f, 0.4f, 1.0f);
+        render_transforms[i] = rectangle_transforms[i];
+        rectangle_renderers[i].mesh = rectangle_mesh;
+        rectangle_renderers[i].material = mesh_material;
+        RK_CHECK(mesh_render_system.add_entity(
+            {{}, &render_transforms[i], &rectangle_renderers[i]}));
     }
 
     glClearColor(0.4f, 0.4f, 0.7f, 1.0f);
 
-    Window& window = m_window_mgr->get_window();
+    struct Frame_Packet {
+        Rectangle_Transforms rectangle_transforms;
+        bool wireframe = false;
+    };
 
-    bool running = true;
-    while (!window.should_close_window() && running) {
-        { // Input
-            RK_CHECK(m_input_mgr->process_new_input());
+    Window& window = m_window_mgr->get_window();
 
-            Game_Input const& input = m_input_mgr->get_input();
-            Window_Settings const& window_settings = input.settings.window;
-            Graphics_Settings const& graphics_settings = input.settings.graphics;
+    Text_Layout hello_text;
+    Text_Layout symbol_text;
 
-            running = !input.state.request_quit;
-            if (!running) { break; }
+    Gpu_Profiler& gpu_profiler = m_renderer->gpu_profiler();
+    Gpu_Profiler::Pass_Id clear_pass = 0;
+    Gpu_Profiler::Pass_Id scene_pass = 0;
+    Gpu_Profiler::Pass_Id overlay_pass = 0;
+    RK_CHECK(gpu_profiler.add_pass("clear", clear_pass));
+    RK_CHECK(gpu_profiler.add_pass("scene", scene_pass));
+    RK_CHECK(gpu_profiler.add_pass("overlay", overlay_pass));
 
-            RK_CHECK(window.set_fullscreen(window_settings.fullscreen));
-            m_renderer->draw_wireframe(graphics_settings.wireframe);
-        }
+    // Draws a frame from its packet, on whichever thread owns the context
+    auto render_frame = [&](Frame_Packet const& packet) -> Status {
+        m_renderer->draw_wireframe(packet.wireframe);
 
         { // Rendering
+            m_renderer->reset_stats();
+            RK_CHECK(m_renderer->begin_frame());
+            gpu_profiler.begin_pass(clear_pass);
             glClear(GL_COLOR_BUFFER_BIT);
+            gpu_profiler.end_pass(clear_pass);
+
+            gpu_profiler.begin_pass(scene_pass);
+            render_transforms = packet.rectangle_transforms;
+            mesh_render_system.update(0.0f);
+            RK_CHECK(mesh_render_system.submit(m_renderer->render_queue(), world_layer,
+                                               m_renderer->stats()));
+            RK_CHECK(m_renderer->flush_render_queue());
+            gpu_profiler.end_pass(scene_pass);
+        }
 
-            simple_shader.use();
+        { // Overlay
+            gpu_profiler.begin_pass(overlay_pass);
+            // Static text, only laid out again if it changes
+            RK_CHECK(m_renderer->layout_text(hello_text, "Hello world!", 25.0f, 25.0f, 1.0f, glm::vec3(.5f, .8f, .2f)));
+            RK_CHECK(m_renderer->layout_text(symbol_text, "!@#$%^&*()_+", 575.0f, 560.0f, .5f, glm::vec3(.5f, .8f, .2f)));
+            RK_CHECK(m_renderer->draw_text_layout(text_shader, hello_text));
+            RK_CHECK(m_renderer->draw_text_layout(text_shader, symbol_text));
+            gpu_profiler.end_pass(overlay_pass);
+        }
 
-            glBindVertexArray(rectangle_vao);
-            glDrawElements(
-                GL_TRIANGLES,
-                fixme::scast<s32>(rectangle_indicies.size(), "replace std::array and avoid size_t"),
-                GL_UNSIGNED_INT, nullptr);
+        return m_renderer->swap_buffers();
+    };
 
-            glBindVertexArray(0);
-        }
+    // Polls input and fills the next frame's packet. Clears running once the engine should stop.
+    auto update_frame = [&](Frame_Packet& packet, bool& running) -> Status {
+        RK_CHECK(m_input_mgr->process_new_input());
 
-        { // Overlay
-            RK_CHECK(m_renderer->render_text(text_shader, "Hello world!", 25.0f, 25.0f, 1.0f, glm::vec3(.5f, .8f, .2f)));
-            RK_CHECK(m_renderer->render_text(text_shader, "!@#$%^&*()_+", 575.0f, 560.0f, .5f, glm::vec3(.5f, .8f, .2f)));
+        Game_Input const& input = m_input_mgr->get_input();
+        Window_Settings const& window_settings = input.settings.window;
+        Graphics_Settings const& graphics_settings = input.settings.graphics;
+
+        running = !input.state.request_quit && !window.should_close_window();
+        if (!running) { return Status::ok; }
+
+        RK_CHECK(window.set_fullscreen(window_settings.fullscreen));
+        packet.wireframe = graphics_settings.wireframe;
+        packet.rectangle_transforms = rectangle_transforms;
+        return Status::ok;
+    };
+
+    if (m_config.render_thread) {
+        Frame_Pipeline<Frame_Packet> pipeline;
+        RK_CHECK(pipeline.initialize(m_config.frame_pipeline_depth));
+
+        // Hand the context over to the render thread until it's done
+        RK_CHECK(window.release_current_context());
+        Status render_status = Status::ok;
+        auto render_thread_main = [&]() {
+            render_status = window.make_current_context();
+            if (render_status == Status::ok) {
+                while (Frame_Packet const* packet = pipeline.begin_read()) {
+                    render_status = render_frame(*packet);
+                    pipeline.end_read();
+                    if (render_status != Status::ok) { break; }
+                }
+                Status const release_status = window.release_current_context();
+                if (render_status == Status::ok) { render_status = release_status; }
+            }
+            // Unblock the main thread if rendering failed
+            pipeline.close();
+        };
+        std::thread render_thread;
+        auto const started = exception_boundary([&]() {
+            render_thread = std::thread(render_thread_main);
+            return Status::ok;
+        });
+        if (Status const* status = std::get_if<Status>(&started); status && *status != Status::ok) {
+            LOG_ERROR("Failed to start the render thread");
+            RK_CHECK(window.make_current_context());
+            return *status;
         }
 
-        RK_CHECK(m_renderer->swap_buffers());
-        Logger::flush(); // @perf: do this on an async thread
+        Status update_status = Status::ok;
+        bool running = true;
+        while (running) {
+            Frame_Packet* packet = pipeline.begin_write();
+            if (!packet) { break; }
+            update_status = update_frame(*packet, running);
+            if (update_status != Status::ok || !running) { break; }
+            pipeline.end_write();
+            Logger::flush(); // @perf: do this on an async thread
+        }
+        pipeline.close();
+        render_thread.join();
+
+        RK_CHECK(window.make_current_context());
+        RK_CHECK(update_status);
+        RK_CHECK(render_status);
+    } else {
+        Frame_Packet packet;
+        bool running = true;
+        while (running) {
+            RK_CHECK(update_frame(packet, running));
+            if (!running) { break; }
+            RK_CHECK(render_frame(packet));
+            Logger::flush(); // @perf: do this on an async thread
+        }
     }
 
+    mesh_render_system.destroy();
     glDeleteVertexArrays(1, &rectangle_vao);
     glDeleteBuffers(1, &rectangle_vbo);
+    m_renderer->destroy_text_layout(hello_text);
+    m_renderer->destroy_text_layout(symbol_text);
     // not explicitly necessary to destory these shaders, but good practice
-    simple_shader.destroy();
+    mesh_shader.destroy();
     text_shader.destroy();
 
     return Status::ok;
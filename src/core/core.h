@@ -11,13 +11,27 @@ namespace rk
 {
 class Rtek_Engine {
 public:
-    Status initialize() noexcept;
+    struct Config {
+        /**
+         * Submit GL work and swap buffers on a dedicated render thread. The main thread polls input
+         * and builds the next frame while the previous one renders.
+         */
+        bool render_thread = false;
+        /**
+         * Frames the main thread can be ahead of the render thread, see `Frame_Pipeline`. Higher
+         * hides more driver stalls, at a frame of input latency each.
+         */
+        s32 frame_pipeline_depth = 2;
+    };
+
+    Status initialize(Config config) noexcept;
     Status destroy() noexcept;
 
     Status run() noexcept;
 
 private:
     static bool m_initialized;
+    Config m_config = {};
     std::unique_ptr<Window_Manager> m_window_mgr;
     std::unique_ptr<Input_Manager> m_input_mgr;
     std::unique_ptr<Renderer> m_renderer;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "core/ecs/components/component.h"
+
+#include "core/types.h"
+
+namespace rk::ecs
+{
+/**
+ * \brief Draws the entity's mesh with a material, at its `Transform_Component`.
+ *
+ * \see Mesh_Render_System
+ */
+struct Mesh_Renderer_Component : public Component {
+    u32 mesh = 0;     //!< Mesh_Render_System::Mesh_Id
+    u32 material = 0; //!< Mesh_Render_System::Material_Id
+};
+} // namespace rk::ecs
@@ -1,10 +1,15 @@
+#pragma once
+
 #include "core/ecs/components/component.h"
 
+#include "core/math/quaternion.h"
 #include "core/math/vector.h"
 
 namespace rk::ecs
 {
 struct Transform_Component : public Component {
     Vector3 position;
+    Quat rotation;
+    Vector3 scale = {1.0f, 1.0f, 1.0f};
 };
 } // namespace rk::ecs
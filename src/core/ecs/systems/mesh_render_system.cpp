@@ -0,0 +1,272 @@
+#include "core/ecs/systems/mesh_render_system.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/utility/no_exception.h"
+#include "core/utility/parallel_for.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <limits>
+
+using namespace rk;
+using namespace rk::ecs;
+using namespace sds;
+
+// The instance buffer of the group being drawn is bound here. Same index as the first model matrix
+// location, which the matrix attributes take over from the mesh.
+constexpr u32 instance_binding = Mesh_Render_System::model_attribute_location;
+
+Status Mesh_Instances::add(Transform_Component const* transform) noexcept
+{
+    RK_ASSERT(transform);
+    if (m_transforms.size() >= static_cast<size_t>(std::numeric_limits<s32>::max())) {
+        LOG_ERROR("Too many instances of a mesh");
+        return Status::buffer_length_error;
+    }
+
+    Transform_Component const& t = *transform;
+    // Grow all three together up front, so the appends can't leave them different sizes
+    if (m_transforms.size() == m_transforms.capacity()) {
+        size_t const capacity = std::max<size_t>(16, 2 * m_transforms.capacity());
+        RK_CHECK_EXB(exception_boundary([&]() {
+            m_transforms.reserve(capacity);
+            m_cached.reserve(capacity);
+            m_models.reserve(capacity);
+            return Status::ok;
+        }));
+    }
+    m_transforms.push_back(&t);
+    m_cached.push_back({t.position, t.rotation, t.scale});
+    m_models.push_back(Mat4::from_trs(t.position, t.rotation, t.scale));
+    mark_dirty(count() - 1);
+    return Status::ok;
+}
+
+bool Mesh_Instances::remove(Transform_Component const* transform) noexcept
+{
+    auto it = std::find(m_transforms.begin(), m_transforms.end(), transform);
+    if (it == m_transforms.end()) { return false; }
+
+    // Move the last instance into the gap, only that matrix needs uploading
+    s32 const index = static_cast<s32>(it - m_transforms.begin());
+    s32 const last = count() - 1;
+    if (index != last) {
+        m_transforms[index] = m_transforms[last];
+        m_cached[index] = m_cached[last];
+        m_models[index] = m_models[last];
+        mark_dirty(index);
+    }
+    m_transforms.pop_back();
+    m_cached.pop_back();
+    m_models.pop_back();
+    m_dirty_end = std::min(m_dirty_end, last);
+    m_dirty_begin = std::min(m_dirty_begin, m_dirty_end);
+    return true;
+}
+
+void Mesh_Instances::update() noexcept
+{
+    s32 const num_instances = count();
+    for (s32 i = 0; i < num_instances; ++i) {
+        Transform_Component const& t = *m_transforms[i];
+        Cached_Transform& cached = m_cached[i];
+        if (t.position == cached.position && t.rotation == cached.rotation &&
+            t.scale == cached.scale) {
+            continue;
+        }
+        cached = {t.position, t.rotation, t.scale};
+        m_models[i] = Mat4::from_trs(t.position, t.rotation, t.scale);
+        mark_dirty(i);
+    }
+}
+
+void Mesh_Instances::mark_all_dirty() noexcept
+{
+    m_dirty_begin = 0;
+    m_dirty_end = count();
+}
+
+void Mesh_Instances::mark_dirty(s32 index) noexcept
+{
+    if (m_dirty_begin == m_dirty_end) {
+        m_dirty_begin = index;
+        m_dirty_end = index + 1;
+    } else {
+        m_dirty_begin = std::min(m_dirty_begin, index);
+        m_dirty_end = std::max(m_dirty_end, index + 1);
+    }
+}
+
+Status Mesh_Render_System::destroy() noexcept
+{
+    for (Group& group : m_groups) { glDeleteBuffers(1, &group.instance_vbo); }
+    m_groups.clear();
+    m_meshes.clear();
+    m_materials.clear();
+    return Status::ok;
+}
+
+Status Mesh_Render_System::add_mesh(Mesh mesh, Mesh_Id& out_mesh) noexcept
+{
+    RK_ASSERT(mesh.vao != 0);
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_meshes.push_back(mesh);
+        return Status::ok;
+    }));
+    out_mesh = static_cast<Mesh_Id>(m_meshes.size() - 1);
+
+    // A mat4 attribute is four vec4 columns. They read from the instance binding, advancing once
+    // per instance.
+    for (u32 column = 0; column < 4; ++column) {
+        u32 const location = model_attribute_location + column;
+        glEnableVertexArrayAttrib(mesh.vao, location);
+        glVertexArrayAttribFormat(mesh.vao, location, 4, GL_FLOAT, GL_FALSE,
+                                  column * 4 * sizeof(f32));
+        glVertexArrayAttribBinding(mesh.vao, location, instance_binding);
+    }
+    glVertexArrayBindingDivisor(mesh.vao, instance_binding, 1);
+    return Status::ok;
+}
+
+Status Mesh_Render_System::add_material(Material material, Material_Id& out_material) noexcept
+{
+    RK_ASSERT(material.shader);
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_materials.push_back(material);
+        return Status::ok;
+    }));
+    out_material = static_cast<Material_Id>(m_materials.size() - 1);
+    return Status::ok;
+}
+
+Mesh_Render_System::Group* Mesh_Render_System::find_group(Mesh_Id mesh,
+                                                          Material_Id material) noexcept
+{
+    for (Group& group : m_groups) {
+        if (group.mesh == mesh && group.material == material) { return &group; }
+    }
+    return nullptr;
+}
+
+Status Mesh_Render_System::add_entity(Mesh_Render_Component_Tuple entity) noexcept
+{
+    RK_ASSERT(entity.transform && entity.mesh_renderer);
+    Mesh_Id const mesh = entity.mesh_renderer->mesh;
+    Material_Id const material = entity.mesh_renderer->material;
+    RK_ASSERT(mesh < m_meshes.size() && material < m_materials.size());
+
+    Group* group = find_group(mesh, material);
+    if (!group) {
+        // Keep groups ordered by material and mesh, so they're submitted mostly in key order
+        auto it = std::find_if(m_groups.begin(), m_groups.end(), [&](Group const& g) {
+            return g.material > material || (g.material == material && g.mesh > mesh);
+        });
+        RK_CHECK_EXB(exception_boundary([&]() {
+            it = m_groups.emplace(it);
+            return Status::ok;
+        }));
+        group = &*it;
+        group->mesh = mesh;
+        group->material = material;
+    }
+
+    return group->instances.add(entity.transform);
+}
+
+void Mesh_Render_System::remove_entity(Mesh_Render_Component_Tuple entity) noexcept
+{
+    RK_ASSERT(entity.transform && entity.mesh_renderer);
+    Group* group = find_group(entity.mesh_renderer->mesh, entity.mesh_renderer->material);
+    if (group) { group->instances.remove(entity.transform); }
+}
+
+void Mesh_Render_System::update([[maybe_unused]] Time_Step time_step) noexcept
+{
+    for (Group& group : m_groups) { group.instances.update(); }
+}
+
+Status Mesh_Render_System::submit(Render_Queue& queue, u8 layer, Render_Stats& stats) noexcept
+{
+    for (Group& group : m_groups) {
+        Mesh_Instances& instances = group.instances;
+        s32 const count = instances.count();
+        if (count == 0) { continue; }
+
+        if (count > group.instance_capacity) {
+            // Grow geometrically and upload everything, the old contents are gone
+            s32 const capacity = std::max(count, 2 * group.instance_capacity);
+            if (group.instance_vbo == 0) {
+                glCreateBuffers(1, &group.instance_vbo);
+                ++stats.gl_calls;
+            }
+            glNamedBufferData(group.instance_vbo, capacity * sizeof(Mat4), nullptr,
+                              GL_DYNAMIC_DRAW);
+            group.instance_capacity = capacity;
+            instances.mark_all_dirty();
+            ++stats.gl_calls;
+            ++stats.buffer_uploads;
+        }
+        if (instances.dirty_begin() < instances.dirty_end()) {
+            s32 const dirty_count = instances.dirty_end() - instances.dirty_begin();
+            glNamedBufferSubData(group.instance_vbo, instances.dirty_begin() * sizeof(Mat4),
+                                 dirty_count * sizeof(Mat4),
+                                 &instances.models()[instances.dirty_begin()]);
+            instances.clear_dirty();
+            ++stats.gl_calls;
+            ++stats.buffer_uploads;
+        }
+
+        stats.instances += static_cast<u32>(count);
+    }
+
+    // Record the draws on worker threads, each into its own command buffer. Only worth the threads
+    // for many groups, fewer are recorded here.
+    s32 const group_count = static_cast<s32>(m_groups.size());
+    s32 const max_chunks =
+        std::clamp(group_count / min_groups_per_chunk, 1, worker_thread_count());
+    if (static_cast<s32>(m_command_buffers.size()) < max_chunks) {
+        RK_CHECK_EXB(exception_boundary([&]() {
+            m_command_buffers.resize(max_chunks);
+            m_chunk_status.resize(max_chunks, Status::ok);
+            return Status::ok;
+        }));
+    }
+    s32 const num_chunks =
+        parallel_for_chunks(group_count, max_chunks, [&](s32 chunk, s32 begin, s32 end) {
+            m_chunk_status[chunk] = record(m_command_buffers[chunk], layer, begin, end);
+        });
+
+    // In chunk order, so the draw order doesn't depend on thread scheduling
+    for (s32 chunk = 0; chunk < num_chunks; ++chunk) {
+        RK_CHECK(m_chunk_status[chunk]);
+        RK_CHECK(queue.merge(m_command_buffers[chunk]));
+    }
+    return Status::ok;
+}
+
+Status Mesh_Render_System::record(Render_Command_Buffer& buffer, u8 layer, s32 group_begin,
+                                  s32 group_end) const noexcept
+{
+    buffer.clear();
+    for (s32 i = group_begin; i < group_end; ++i) {
+        Group const& group = m_groups[i];
+        if (group.instances.count() == 0) { continue; }
+
+        Material const& material = m_materials[group.material];
+        Mesh const& mesh = m_meshes[group.mesh];
+        Draw_Packet packet;
+        packet.program = material.shader->handle();
+        packet.vao = mesh.vao;
+        packet.texture = material.texture_id;
+        packet.instance_buffer = group.instance_vbo;
+        packet.instance_binding = instance_binding;
+        packet.instance_stride = sizeof(Mat4);
+        packet.count = mesh.index_count;
+        packet.instance_count = group.instances.count();
+        packet.index_type =
+            mesh.u16_indices ? Draw_Packet::Index_Type::u16 : Draw_Packet::Index_Type::u32;
+        // Opaque. A group spans the scene, so there is no depth to order it by.
+        RK_CHECK(buffer.submit(packet, layer, 0.0f));
+    }
+    return Status::ok;
+}
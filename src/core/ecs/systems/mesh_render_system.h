@@ -0,0 +1,183 @@
+#pragma once
+
+#include "core/ecs/systems/system.h"
+
+#include "core/ecs/components/component.h"
+#include "core/ecs/components/mesh_renderer_component.h"
+#include "core/ecs/components/transform_component.h"
+#include "core/math/matrix.h"
+#include "core/renderer/opengl/shader_program.h"
+#include "core/renderer/render_queue.h"
+#include "core/renderer/render_stats.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <vector>
+
+namespace rk::ecs
+{
+struct Mesh_Render_Component_Tuple : public Component_Tuple {
+    Transform_Component const* transform;
+    Mesh_Renderer_Component const* mesh_renderer;
+};
+
+/**
+ * \brief Model matrices of the instances of a mesh, and the range of them changed since they were
+ * last uploaded. No GL calls.
+ */
+class Mesh_Instances {
+public:
+    /**
+     * \brief Add an instance with \a transform, at the end.
+     */
+    [[nodiscard]] Status add(Transform_Component const* transform) noexcept;
+
+    /**
+     * \brief Remove the instance with \a transform by moving the last instance into its place.
+     * Linear in the number of instances.
+     *
+     * \return Whether there was an instance with \a transform.
+     */
+    bool remove(Transform_Component const* transform) noexcept;
+
+    /**
+     * \brief Rebuild the model matrices of instances whose transform changed.
+     */
+    void update() noexcept;
+
+    [[nodiscard]] s32 count() const noexcept { return static_cast<s32>(m_models.size()); }
+    [[nodiscard]] std::vector<Mat4> const& models() const noexcept { return m_models; }
+
+    /** Start of the range of model matrices changed since `clear_dirty`. */
+    [[nodiscard]] s32 dirty_begin() const noexcept { return m_dirty_begin; }
+    /** End of the changed range. Same as `dirty_begin` if nothing changed. */
+    [[nodiscard]] s32 dirty_end() const noexcept { return m_dirty_end; }
+
+    /** Mark every model matrix changed, for when the buffer they were uploaded to is replaced. */
+    void mark_all_dirty() noexcept;
+    /** Mark the model matrices as uploaded. */
+    void clear_dirty() noexcept { m_dirty_begin = m_dirty_end = 0; }
+
+private:
+    struct Cached_Transform {
+        Vector3 position;
+        Quat rotation;
+        Vector3 scale;
+    };
+
+    void mark_dirty(s32 index) noexcept;
+
+    std::vector<Transform_Component const*> m_transforms;
+    std::vector<Cached_Transform> m_cached; // transform each model matrix was built from
+    std::vector<Mat4> m_models;
+    s32 m_dirty_begin = 0;
+    s32 m_dirty_end = 0;
+};
+
+/**
+ * \brief Draws entities with a `Mesh_Renderer_Component` as instances of their mesh.
+ *
+ * Entities are grouped by mesh and material. Each group keeps the model matrices of its entities in
+ * its own instance buffer and is drawn with one instanced call, queued on the `Render_Queue`, so
+ * drawing many copies of a mesh costs GL calls per group, not per entity.
+ *
+ * `update` compares every transform with the one its matrix was last built from, so transforms can
+ * be written directly by other systems. Only the range of changed matrices is uploaded by `submit`,
+ * and static entities cost a comparison a frame.
+ *
+ * Mesh shaders get the model matrix as a per instance `mat4` at `model_attribute_location` (and the
+ * three locations after it). See "mesh_instanced.vert".
+ *
+ * Requires a current OpenGL context.
+ */
+class Mesh_Render_System : public System {
+    using Time_Step = time::Time_Step;
+
+public:
+    using Mesh_Id = u32;
+    using Material_Id = u32;
+
+    static constexpr u32 model_attribute_location = 3;
+
+    /** Indexed geometry. */
+    struct Mesh {
+        u32 vao = 0; //!< Vertex array with the vertex attributes and index buffer bound
+        s32 index_count = 0;
+        bool u16_indices = false; //!< Otherwise u32
+    };
+
+    struct Material {
+        Shader_Program const* shader = nullptr;
+        u32 texture_id = 0; //!< Bound to texture unit 0, if not 0
+    };
+
+    Mesh_Render_System() = default;
+
+    Status destroy() noexcept;
+
+    /**
+     * \brief Register \a mesh for drawing. Adds the per instance model matrix attributes to its
+     * vertex array.
+     */
+    [[nodiscard]] Status add_mesh(Mesh mesh, Mesh_Id& out_mesh) noexcept;
+    [[nodiscard]] Status add_material(Material material, Material_Id& out_material) noexcept;
+
+    /**
+     * \brief Start drawing the entity with the given components. They must outlive the entity's
+     * registration.
+     */
+    [[nodiscard]] Status add_entity(Mesh_Render_Component_Tuple entity) noexcept;
+
+    /**
+     * \brief Stop drawing the entity with \a transform. Linear in the size of its group.
+     */
+    void remove_entity(Mesh_Render_Component_Tuple entity) noexcept;
+
+    /**
+     * \brief Rebuild the model matrices of entities whose transform changed.
+     */
+    void update(Time_Step time_step) noexcept override;
+
+    /**
+     * \brief Upload the changed model matrices and queue a draw of every group in \a layer.
+     *
+     * The draws of many groups are recorded on worker threads. The uploads and the merge into
+     * \a queue happen on the calling thread, which must own the GL context.
+     *
+     * Per frame uniforms, like the view and projection, must be set on the material shaders before
+     * the queue is flushed.
+     */
+    [[nodiscard]] Status submit(Render_Queue& queue, u8 layer, Render_Stats& stats) noexcept;
+
+private:
+    struct Group {
+        Mesh_Id mesh = 0;
+        Material_Id material = 0;
+        Mesh_Instances instances;
+        u32 instance_vbo = 0;
+        s32 instance_capacity = 0; // size of the instance buffer, in matrices
+    };
+
+    /**
+     * \brief Group of \a mesh and \a material, or null if there isn't one.
+     */
+    [[nodiscard]] Group* find_group(Mesh_Id mesh, Material_Id material) noexcept;
+
+    /**
+     * \brief Record the draws of groups [\a group_begin, \a group_end) into \a buffer, replacing
+     * its contents. No GL calls, safe to run concurrently on disjoint ranges.
+     */
+    [[nodiscard]] Status record(Render_Command_Buffer& buffer, u8 layer, s32 group_begin,
+                                s32 group_end) const noexcept;
+
+    /** Fewest groups worth recording on their own thread. */
+    static constexpr s32 min_groups_per_chunk = 256;
+
+    std::vector<Mesh> m_meshes;
+    std::vector<Material> m_materials;
+    std::vector<Group> m_groups; // sorted by material, then mesh
+
+    // Reused every frame, one per recording thread
+    std::vector<Render_Command_Buffer> m_command_buffers;
+    std::vector<Status> m_chunk_status;
+};
+} // namespace rk::ecs
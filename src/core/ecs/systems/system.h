@@ -1,3 +1,5 @@
+#pragma once
+
 #include "core/utility/time.h"
 
 namespace rk::ecs
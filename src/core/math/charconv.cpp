@@ -0,0 +1,102 @@
+#include "core/math/charconv.h"
+
+#include "core/assert.h"
+
+using namespace rk;
+using namespace sds;
+
+/**
+ * \brief Write \a count space separated floats to [first, last).
+ */
+RK_INTERNAL
+std::to_chars_result f32s_to_chars(char* first, char* last, f32 const* values, s32 count) noexcept
+{
+    RK_ASSERT(first);
+    RK_ASSERT(values);
+
+    std::to_chars_result r = {first, std::errc()};
+    for (s32 i = 0; i < count; ++i) {
+        if (i > 0) {
+            if (r.ptr == last) { return {last, std::errc::value_too_large}; }
+            *r.ptr++ = ' ';
+        }
+
+        r = std::to_chars(r.ptr, last, values[i]);
+        if (r.ec != std::errc()) { return r; }
+    }
+    return r;
+}
+
+RK_INTERNAL
+constexpr bool is_space(char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * \brief Parse \a count whitespace separated floats from [first, last) into \a out.
+ *
+ * \a out is written even on failure. Callers parse into a temporary.
+ */
+RK_INTERNAL
+std::from_chars_result f32s_from_chars(char const* first, char const* last, f32* out,
+                                       s32 count) noexcept
+{
+    RK_ASSERT(first);
+    RK_ASSERT(out);
+
+    std::from_chars_result r = {first, std::errc()};
+    for (s32 i = 0; i < count; ++i) {
+        char const* p = r.ptr;
+        while (p != last && is_space(*p)) { ++p; }
+        if (i > 0 && p == r.ptr) {
+            // Components must be separated
+            return {p, std::errc::invalid_argument};
+        }
+
+        r = std::from_chars(p, last, out[i]);
+        if (r.ec != std::errc()) { return r; }
+    }
+    return r;
+}
+
+std::to_chars_result rk::to_chars(char* first, char* last, Vector3 const& v) noexcept
+{
+    std::array<f32, 3> const values = {v[0], v[1], v[2]};
+    return f32s_to_chars(first, last, values.data(), static_cast<s32>(values.size()));
+}
+
+std::to_chars_result rk::to_chars(char* first, char* last, Quat const& q) noexcept
+{
+    return f32s_to_chars(first, last, q.data(), 4);
+}
+
+std::to_chars_result rk::to_chars(char* first, char* last, Mat4 const& m) noexcept
+{
+    return f32s_to_chars(first, last, m.data(), 16);
+}
+
+std::from_chars_result rk::from_chars(char const* first, char const* last, Vector3& v) noexcept
+{
+    std::array<f32, 3> values;
+    std::from_chars_result const r =
+        f32s_from_chars(first, last, values.data(), static_cast<s32>(values.size()));
+    if (r.ec == std::errc()) { v = Vector3(values[0], values[1], values[2]); }
+    return r;
+}
+
+std::from_chars_result rk::from_chars(char const* first, char const* last, Quat& q) noexcept
+{
+    Quat tmp;
+    std::from_chars_result const r = f32s_from_chars(first, last, tmp.data(), 4);
+    if (r.ec == std::errc()) { q = tmp; }
+    return r;
+}
+
+std::from_chars_result rk::from_chars(char const* first, char const* last, Mat4& m) noexcept
+{
+    Mat4 tmp;
+    std::from_chars_result const r = f32s_from_chars(first, last, tmp.data(), 16);
+    if (r.ec == std::errc()) { m = tmp; }
+    return r;
+}
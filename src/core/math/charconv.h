@@ -0,0 +1,77 @@
+#pragma once
+
+#include "core/math/matrix.h"
+#include "core/math/quaternion.h"
+#include "core/math/vector.h"
+#include "core/types.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+
+/**
+ * \file charconv.h
+ * \brief Allocation free text conversion of the math types, in the style of `<charconv>`.
+ *
+ * Values are written as space separated components using the shortest representation that
+ * round-trips, so `from_chars(to_chars(v)) == v` exactly. Matrices are written in column-major
+ * order, the same order as `Mat4::data`.
+ *
+ * fmt formatters are provided so math types can be logged directly without an intermediate
+ * string.
+ */
+
+namespace rk
+{
+/** Maximum characters needed to write an f32 in its shortest round-trip form. */
+constexpr s32 max_f32_chars = 16;
+/** Maximum characters needed to write a `Vector3`. */
+constexpr s32 max_vector3_chars = 3 * max_f32_chars + 2;
+/** Maximum characters needed to write a `Quat`. */
+constexpr s32 max_quat_chars = 4 * max_f32_chars + 3;
+/** Maximum characters needed to write a `Mat4`. */
+constexpr s32 max_mat4_chars = 16 * max_f32_chars + 15;
+
+/**
+ * \brief Write the vector to [first, last).
+ *
+ * On failure `ec` is `std::errc::value_too_large` and the contents of the buffer are unspecified.
+ * A buffer of \a max_vector3_chars never fails.
+ */
+std::to_chars_result to_chars(char* first, char* last, Vector3 const& v) noexcept;
+std::to_chars_result to_chars(char* first, char* last, Quat const& q) noexcept;
+std::to_chars_result to_chars(char* first, char* last, Mat4 const& m) noexcept;
+
+/**
+ * \brief Parse a vector from [first, last).
+ *
+ * Components are separated by whitespace. Leading whitespace is skipped. On failure `ec` is set and
+ * \a v is unmodified.
+ */
+std::from_chars_result from_chars(char const* first, char const* last, Vector3& v) noexcept;
+std::from_chars_result from_chars(char const* first, char const* last, Quat& q) noexcept;
+std::from_chars_result from_chars(char const* first, char const* last, Mat4& m) noexcept;
+
+/**
+ * \brief fmt formatter for the math types, writing through `to_chars` on the stack.
+ */
+template <typename T, s32 Max_Chars>
+struct Math_Formatter {
+    constexpr auto parse(fmt::format_parse_context& ctx) { return ctx.begin(); }
+
+    template <typename Format_Context>
+    auto format(T const& v, Format_Context& ctx) const
+    {
+        std::array<char, Max_Chars> buf;
+        std::to_chars_result const r = to_chars(buf.data(), buf.data() + buf.size(), v);
+        return std::copy(buf.data(), r.ptr, ctx.out());
+    }
+};
+} // namespace rk
+
+template <>
+struct fmt::formatter<rk::Vector3> : rk::Math_Formatter<rk::Vector3, rk::max_vector3_chars> {};
+template <>
+struct fmt::formatter<rk::Quat> : rk::Math_Formatter<rk::Quat, rk::max_quat_chars> {};
+template <>
+struct fmt::formatter<rk::Mat4> : rk::Math_Formatter<rk::Mat4, rk::max_mat4_chars> {};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/math/matrix.h"
+#include "core/math/quaternion.h"
+#include "core/math/vector.h"
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * \file glm_bridge.h
+ * \brief Conversions between the engine math types and glm.
+ *
+ * The engine types share glm's memory layout, so an engine value can be viewed as its glm
+ * equivalent in place. Going the other way is a copy: glm types are only 4 byte aligned, while
+ * `Mat4` and `Quat` are 16 byte aligned for SIMD loads, so a glm object can't be aliased as an
+ * engine type.
+ */
+
+namespace rk
+{
+RK_STATIC_ASSERT_MSG(sizeof(Mat4) == sizeof(glm::mat4), "Mat4 must match the glm::mat4 layout");
+RK_STATIC_ASSERT_MSG(sizeof(Quat) == sizeof(glm::quat), "Quat must match the glm::quat layout");
+RK_STATIC_ASSERT_MSG(sizeof(Vector3) == sizeof(glm::vec3),
+                     "Vector3 must match the glm::vec3 layout");
+RK_STATIC_ASSERT(std::is_standard_layout_v<Mat4>);
+RK_STATIC_ASSERT(std::is_standard_layout_v<Quat>);
+RK_STATIC_ASSERT(std::is_standard_layout_v<Vector3>);
+RK_STATIC_ASSERT(alignof(Mat4) % alignof(glm::mat4) == 0);
+RK_STATIC_ASSERT(alignof(Quat) % alignof(glm::quat) == 0);
+RK_STATIC_ASSERT(alignof(Vector3) % alignof(glm::vec3) == 0);
+
+/**
+ * \brief View the matrix as a `glm::mat4` without copying.
+ */
+inline glm::mat4 const& as_glm(Mat4 const& m) noexcept
+{
+    return *reinterpret_cast<glm::mat4 const*>(m.data());
+}
+inline glm::mat4& as_glm(Mat4& m) noexcept { return *reinterpret_cast<glm::mat4*>(m.data()); }
+
+/**
+ * \brief View the quaternion as a `glm::quat` without copying.
+ *
+ * NOTE(sdsmith): Requires glm's default (x, y, z, w) storage. Don't define
+ * GLM_FORCE_QUAT_DATA_WXYZ.
+ */
+inline glm::quat const& as_glm(Quat const& q) noexcept
+{
+    return *reinterpret_cast<glm::quat const*>(q.data());
+}
+inline glm::quat& as_glm(Quat& q) noexcept { return *reinterpret_cast<glm::quat*>(q.data()); }
+
+/**
+ * \brief View the vector as a `glm::vec3` without copying.
+ */
+inline glm::vec3 const& as_glm(Vector3 const& v) noexcept
+{
+    return *reinterpret_cast<glm::vec3 const*>(&v);
+}
+inline glm::vec3& as_glm(Vector3& v) noexcept { return *reinterpret_cast<glm::vec3*>(&v); }
+
+/**
+ * \brief Copy a glm matrix into an engine matrix.
+ */
+inline Mat4 to_mat4(glm::mat4 const& m) noexcept
+{
+    Mat4 r;
+    std::memcpy(r.data(), &m, sizeof(r));
+    return r;
+}
+
+/**
+ * \brief Copy a glm quaternion into an engine quaternion.
+ */
+inline Quat to_quat(glm::quat const& q) noexcept { return {q.x, q.y, q.z, q.w}; }
+
+/**
+ * \brief Copy a glm vector into an engine vector.
+ */
+inline Vector3 to_vector3(glm::vec3 const& v) noexcept { return {v.x, v.y, v.z}; }
+} // namespace rk
@@ -0,0 +1,351 @@
+#include "core/math/matrix.h"
+
+#include "core/assert.h"
+#include "core/math/quaternion.h"
+#include "core/math/simd.h"
+#include <cmath>
+
+using namespace rk;
+using namespace sds;
+
+#if RK_SIMD_SSE
+/**
+ * \brief Broadcast lane \a i of \a v to all lanes.
+ */
+#    define RK_SPLAT(v, i) _mm_shuffle_ps((v), (v), RK_SIMD_SHUFFLE_MASK(i, i, i, i))
+
+/**
+ * \brief Linear combination of the columns of \a a using the 4 lanes of \a b as weights.
+ */
+RK_INTERNAL
+__m128 linear_combine(__m128 b, __m128 const (&a)[4])
+{
+    __m128 r = _mm_mul_ps(RK_SPLAT(b, 0), a[0]);
+    r = _mm_add_ps(r, _mm_mul_ps(RK_SPLAT(b, 1), a[1]));
+    r = _mm_add_ps(r, _mm_mul_ps(RK_SPLAT(b, 2), a[2]));
+    r = _mm_add_ps(r, _mm_mul_ps(RK_SPLAT(b, 3), a[3]));
+    return r;
+}
+
+/*
+ * 2x2 matrix helpers for the block inverse. A 2x2 matrix is packed into one register as
+ * (m00, m01, m10, m11).
+ *
+ * ref: https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+ */
+
+/** A * B */
+RK_INTERNAL
+__m128 mat2_mul(__m128 a, __m128 b)
+{
+    return _mm_add_ps(
+        _mm_mul_ps(a, _mm_shuffle_ps(b, b, RK_SIMD_SHUFFLE_MASK(0, 3, 0, 3))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, RK_SIMD_SHUFFLE_MASK(1, 0, 3, 2)),
+                   _mm_shuffle_ps(b, b, RK_SIMD_SHUFFLE_MASK(2, 1, 2, 1))));
+}
+
+/** adj(A) * B */
+RK_INTERNAL
+__m128 mat2_adj_mul(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, RK_SIMD_SHUFFLE_MASK(3, 3, 0, 0)), b),
+                      _mm_mul_ps(_mm_shuffle_ps(a, a, RK_SIMD_SHUFFLE_MASK(1, 1, 2, 2)),
+                                 _mm_shuffle_ps(b, b, RK_SIMD_SHUFFLE_MASK(2, 3, 0, 1))));
+}
+
+/** A * adj(B) */
+RK_INTERNAL
+__m128 mat2_mul_adj(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(a, _mm_shuffle_ps(b, b, RK_SIMD_SHUFFLE_MASK(3, 0, 3, 0))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, RK_SIMD_SHUFFLE_MASK(1, 0, 3, 2)),
+                   _mm_shuffle_ps(b, b, RK_SIMD_SHUFFLE_MASK(2, 1, 2, 1))));
+}
+#endif
+
+Mat4 Mat4::identity()
+{
+    return Mat4({1.0f, 0.0f, 0.0f, 0.0f, //
+                 0.0f, 1.0f, 0.0f, 0.0f, //
+                 0.0f, 0.0f, 1.0f, 0.0f, //
+                 0.0f, 0.0f, 0.0f, 1.0f});
+}
+
+Mat4 Mat4::orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 z_near, f32 z_far)
+{
+    RK_ASSERT(right != left);
+    RK_ASSERT(top != bottom);
+    RK_ASSERT(z_far != z_near);
+
+    Mat4 r = identity();
+    r(0, 0) = 2.0f / (right - left);
+    r(1, 1) = 2.0f / (top - bottom);
+    r(2, 2) = -2.0f / (z_far - z_near);
+    r(0, 3) = -(right + left) / (right - left);
+    r(1, 3) = -(top + bottom) / (top - bottom);
+    r(2, 3) = -(z_far + z_near) / (z_far - z_near);
+    return r;
+}
+
+Mat4 Mat4::perspective(f32 fov_y, f32 aspect, f32 z_near, f32 z_far)
+{
+    RK_ASSERT(aspect != 0.0f);
+    RK_ASSERT(z_far != z_near);
+
+    f32 const f = 1.0f / std::tan(fov_y / 2.0f);
+
+    Mat4 r;
+    r(0, 0) = f / aspect;
+    r(1, 1) = f;
+    r(2, 2) = -(z_far + z_near) / (z_far - z_near);
+    r(3, 2) = -1.0f;
+    r(2, 3) = -(2.0f * z_far * z_near) / (z_far - z_near);
+    return r;
+}
+
+Mat4 Mat4::translation(Vector3 const& t)
+{
+    Mat4 r = identity();
+    r(0, 3) = t.x();
+    r(1, 3) = t.y();
+    r(2, 3) = t.z();
+    return r;
+}
+
+Mat4 Mat4::scaling(Vector3 const& s)
+{
+    Mat4 r = identity();
+    r(0, 0) = s.x();
+    r(1, 1) = s.y();
+    r(2, 2) = s.z();
+    return r;
+}
+
+Mat4 Mat4::rotation(Quat const& r) { return r.to_mat4(); }
+
+Mat4 Mat4::from_trs(Vector3 const& t, Quat const& r, Vector3 const& s)
+{
+    Mat4 m = r.to_mat4();
+    for (s32 row = 0; row < 3; ++row) {
+        m(row, 0) *= s.x();
+        m(row, 1) *= s.y();
+        m(row, 2) *= s.z();
+    }
+    m(0, 3) = t.x();
+    m(1, 3) = t.y();
+    m(2, 3) = t.z();
+    return m;
+}
+
+f32 Mat4::operator()(s32 row, s32 col) const
+{
+    RK_ASSERT(row >= 0 && row < dimension);
+    RK_ASSERT(col >= 0 && col < dimension);
+    return m[col * dimension + row];
+}
+
+f32& Mat4::operator()(s32 row, s32 col)
+{
+    RK_ASSERT(row >= 0 && row < dimension);
+    RK_ASSERT(col >= 0 && col < dimension);
+    return m[col * dimension + row];
+}
+
+Mat4& Mat4::operator*=(Mat4 const& o)
+{
+    *this = *this * o;
+    return *this;
+}
+
+Mat4 Mat4::transposed() const
+{
+#if RK_SIMD_SSE
+    __m128 c0 = _mm_load_ps(&m[0]);
+    __m128 c1 = _mm_load_ps(&m[4]);
+    __m128 c2 = _mm_load_ps(&m[8]);
+    __m128 c3 = _mm_load_ps(&m[12]);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    Mat4 r;
+    _mm_store_ps(&r.m[0], c0);
+    _mm_store_ps(&r.m[4], c1);
+    _mm_store_ps(&r.m[8], c2);
+    _mm_store_ps(&r.m[12], c3);
+    return r;
+#else
+    Mat4 r;
+    for (s32 row = 0; row < dimension; ++row) {
+        for (s32 col = 0; col < dimension; ++col) { r(col, row) = (*this)(row, col); }
+    }
+    return r;
+#endif
+}
+
+Mat4 Mat4::inverse() const
+{
+#if RK_SIMD_SSE
+    // Block-wise inverse using 2x2 sub-matrices. The algorithm is written for row-major storage,
+    // but since inverse(transpose(M)) == transpose(inverse(M)) it works unchanged on column-major
+    // data.
+    __m128 const c0 = _mm_load_ps(&m[0]);
+    __m128 const c1 = _mm_load_ps(&m[4]);
+    __m128 const c2 = _mm_load_ps(&m[8]);
+    __m128 const c3 = _mm_load_ps(&m[12]);
+
+    __m128 const a = _mm_movelh_ps(c0, c1);
+    __m128 const b = _mm_movehl_ps(c1, c0);
+    __m128 const c = _mm_movelh_ps(c2, c3);
+    __m128 const d = _mm_movehl_ps(c3, c2);
+
+    // (|A|, |B|, |C|, |D|)
+    __m128 const det_sub =
+        _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(c0, c2, RK_SIMD_SHUFFLE_MASK(0, 2, 0, 2)),
+                              _mm_shuffle_ps(c1, c3, RK_SIMD_SHUFFLE_MASK(1, 3, 1, 3))),
+                   _mm_mul_ps(_mm_shuffle_ps(c0, c2, RK_SIMD_SHUFFLE_MASK(1, 3, 1, 3)),
+                              _mm_shuffle_ps(c1, c3, RK_SIMD_SHUFFLE_MASK(0, 2, 0, 2))));
+    __m128 const det_a = RK_SPLAT(det_sub, 0);
+    __m128 const det_b = RK_SPLAT(det_sub, 1);
+    __m128 const det_c = RK_SPLAT(det_sub, 2);
+    __m128 const det_d = RK_SPLAT(det_sub, 3);
+
+    __m128 const d_c = mat2_adj_mul(d, c);
+    __m128 const a_b = mat2_adj_mul(a, b);
+
+    __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), mat2_mul(b, d_c));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), mat2_mul(c, a_b));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), mat2_mul_adj(d, a_b));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), mat2_mul_adj(a, d_c));
+
+    // |M| = |A|*|D| + |B|*|C| - tr(adj(A)B * adj(D)C)
+    __m128 tr = _mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, RK_SIMD_SHUFFLE_MASK(0, 2, 1, 3)));
+    tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, RK_SIMD_SHUFFLE_MASK(1, 0, 3, 2)));
+    tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, RK_SIMD_SHUFFLE_MASK(2, 3, 0, 1)));
+    __m128 det_m = _mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c));
+    det_m = _mm_sub_ps(det_m, tr);
+
+    __m128 const r_det_m = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_m);
+    x = _mm_mul_ps(x, r_det_m);
+    y = _mm_mul_ps(y, r_det_m);
+    z = _mm_mul_ps(z, r_det_m);
+    w = _mm_mul_ps(w, r_det_m);
+
+    Mat4 r;
+    _mm_store_ps(&r.m[0], _mm_shuffle_ps(x, y, RK_SIMD_SHUFFLE_MASK(3, 1, 3, 1)));
+    _mm_store_ps(&r.m[4], _mm_shuffle_ps(x, y, RK_SIMD_SHUFFLE_MASK(2, 0, 2, 0)));
+    _mm_store_ps(&r.m[8], _mm_shuffle_ps(z, w, RK_SIMD_SHUFFLE_MASK(3, 1, 3, 1)));
+    _mm_store_ps(&r.m[12], _mm_shuffle_ps(z, w, RK_SIMD_SHUFFLE_MASK(2, 0, 2, 0)));
+    return r;
+#else
+    // Cofactor expansion
+    std::array<f32, 16> inv{};
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
+             m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] -
+             m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] +
+             m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] -
+              m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] -
+             m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] +
+             m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] -
+             m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] +
+              m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] +
+             m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] -
+             m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] +
+              m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] -
+              m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] -
+             m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] +
+             m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] -
+              m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] +
+              m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    f32 const det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    RK_ASSERT(det != 0.0f);
+    f32 const inv_det = 1.0f / det;
+    for (f32& v : inv) { v *= inv_det; }
+    return Mat4(inv);
+#endif
+}
+
+f32 Mat4::determinant() const
+{
+    // Expansion along the first column using 2x2 minors of the bottom two rows
+    f32 const s0 = m[0] * m[5] - m[4] * m[1];
+    f32 const s1 = m[0] * m[9] - m[8] * m[1];
+    f32 const s2 = m[0] * m[13] - m[12] * m[1];
+    f32 const s3 = m[4] * m[9] - m[8] * m[5];
+    f32 const s4 = m[4] * m[13] - m[12] * m[5];
+    f32 const s5 = m[8] * m[13] - m[12] * m[9];
+
+    f32 const c5 = m[10] * m[15] - m[14] * m[11];
+    f32 const c4 = m[6] * m[15] - m[14] * m[7];
+    f32 const c3 = m[6] * m[11] - m[10] * m[7];
+    f32 const c2 = m[2] * m[15] - m[14] * m[3];
+    f32 const c1 = m[2] * m[11] - m[10] * m[3];
+    f32 const c0 = m[2] * m[7] - m[6] * m[3];
+
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+bool rk::operator==(Mat4 const& lhs, Mat4 const& rhs)
+{
+    for (s32 i = 0; i < 16; ++i) {
+        if (lhs.data()[i] != rhs.data()[i]) { return false; }
+    }
+    return true;
+}
+
+bool rk::operator!=(Mat4 const& lhs, Mat4 const& rhs) { return !(lhs == rhs); }
+
+Mat4 rk::operator*(Mat4 const& lhs, Mat4 const& rhs)
+{
+    Mat4 r;
+#if RK_SIMD_SSE
+    f32 const* const a = lhs.data();
+    f32 const* const b = rhs.data();
+    __m128 const a_cols[4] = {_mm_load_ps(a), _mm_load_ps(a + 4), _mm_load_ps(a + 8),
+                              _mm_load_ps(a + 12)};
+    for (s32 col = 0; col < 4; ++col) {
+        _mm_store_ps(r.data() + col * 4, linear_combine(_mm_load_ps(b + col * 4), a_cols));
+    }
+#else
+    for (s32 col = 0; col < Mat4::dimension; ++col) {
+        for (s32 row = 0; row < Mat4::dimension; ++row) {
+            f32 sum = 0.0f;
+            for (s32 k = 0; k < Mat4::dimension; ++k) { sum += lhs(row, k) * rhs(k, col); }
+            r(row, col) = sum;
+        }
+    }
+#endif
+    return r;
+}
+
+Vector3 rk::transform_point(Mat4 const& m, Vector3 const& p)
+{
+    f32 const x = m(0, 0) * p.x() + m(0, 1) * p.y() + m(0, 2) * p.z() + m(0, 3);
+    f32 const y = m(1, 0) * p.x() + m(1, 1) * p.y() + m(1, 2) * p.z() + m(1, 3);
+    f32 const z = m(2, 0) * p.x() + m(2, 1) * p.y() + m(2, 2) * p.z() + m(2, 3);
+    f32 const w = m(3, 0) * p.x() + m(3, 1) * p.y() + m(3, 2) * p.z() + m(3, 3);
+    RK_ASSERT(w != 0.0f);
+    return {x / w, y / w, z / w};
+}
+
+Vector3 rk::transform_vector(Mat4 const& m, Vector3 const& v)
+{
+    return {m(0, 0) * v.x() + m(0, 1) * v.y() + m(0, 2) * v.z(),
+            m(1, 0) * v.x() + m(1, 1) * v.y() + m(1, 2) * v.z(),
+            m(2, 0) * v.x() + m(2, 1) * v.y() + m(2, 2) * v.z()};
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/math/vector.h"
+#include "core/types.h"
+#include <array>
+
+namespace rk
+{
+class Quat;
+
+/**
+ * \brief 4x4 single precision matrix.
+ *
+ * Stored column-major, matching OpenGL and glm, so the data can be handed to the graphics API (or
+ * viewed as a `glm::mat4`) without conversion. Aligned so columns can be loaded directly into SIMD
+ * registers.
+ *
+ * \see glm_bridge.h
+ */
+class alignas(16) Mat4 {
+public:
+    static constexpr s32 dimension = 4; //!< Number of rows and columns.
+
+    /**
+     * \brief Zero matrix.
+     */
+    Mat4() = default;
+
+    /**
+     * \brief Construct from 16 values in column-major order.
+     */
+    explicit Mat4(std::array<f32, 16> const& column_major) : m(column_major) {}
+
+    [[nodiscard]] static Mat4 identity();
+
+    /**
+     * \brief Orthographic projection. Equivalent to `glm::ortho`.
+     */
+    [[nodiscard]] static Mat4 orthographic(f32 left, f32 right, f32 bottom, f32 top,
+                                           f32 z_near = -1.0f, f32 z_far = 1.0f);
+
+    /**
+     * \brief Right handed perspective projection with a [-1, 1] depth range. Equivalent to
+     * `glm::perspective`.
+     *
+     * \param fov_y Vertical field of view in radians.
+     */
+    [[nodiscard]] static Mat4 perspective(f32 fov_y, f32 aspect, f32 z_near, f32 z_far);
+
+    [[nodiscard]] static Mat4 translation(Vector3 const& t);
+    [[nodiscard]] static Mat4 scaling(Vector3 const& s);
+    [[nodiscard]] static Mat4 rotation(Quat const& r);
+
+    /**
+     * \brief Compose a translation, rotation and scale into a single transform. Equivalent to
+     * `translation(t) * rotation(r) * scaling(s)`, but without the matrix multiplies.
+     */
+    [[nodiscard]] static Mat4 from_trs(Vector3 const& t, Quat const& r, Vector3 const& s);
+
+    /**
+     * \brief Element at the given row and column.
+     */
+    [[nodiscard]] f32 operator()(s32 row, s32 col) const;
+    f32& operator()(s32 row, s32 col);
+
+    /**
+     * \brief Pointer to the 16 elements in column-major order.
+     */
+    [[nodiscard]] f32 const* data() const { return m.data(); }
+    [[nodiscard]] f32* data() { return m.data(); }
+
+    Mat4& operator*=(Mat4 const& o);
+
+    [[nodiscard]] Mat4 transposed() const;
+
+    /**
+     * \brief General inverse. Result is undefined if the matrix is singular.
+     */
+    [[nodiscard]] Mat4 inverse() const;
+
+    [[nodiscard]] f32 determinant() const;
+
+private:
+    std::array<f32, 16> m{};
+};
+
+bool operator==(Mat4 const& lhs, Mat4 const& rhs);
+bool operator!=(Mat4 const& lhs, Mat4 const& rhs);
+
+Mat4 operator*(Mat4 const& lhs, Mat4 const& rhs);
+
+/**
+ * \brief Transform a point (w = 1), including the perspective divide.
+ */
+Vector3 transform_point(Mat4 const& m, Vector3 const& p);
+
+/**
+ * \brief Transform a direction (w = 0). Translation is ignored.
+ */
+Vector3 transform_vector(Mat4 const& m, Vector3 const& v);
+} // namespace rk
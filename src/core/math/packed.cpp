@@ -0,0 +1,561 @@
+#include "core/math/packed.h"
+
+#include "core/assert.h"
+#include "core/math/simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace rk;
+using namespace sds;
+
+RK_STATIC_ASSERT(sizeof(Vector3) == 3 * sizeof(f32));
+RK_STATIC_ASSERT(sizeof(Half_Vector3) == 3 * sizeof(u16));
+RK_STATIC_ASSERT(sizeof(Snorm16_Vector3) == 3 * sizeof(s16));
+RK_STATIC_ASSERT(sizeof(Octahedral_Vector3) == 2 * sizeof(s16));
+RK_STATIC_ASSERT(sizeof(Fixed16_Vector3) == 3 * sizeof(u16));
+
+constexpr f32 snorm16_max = 32767.0f;
+constexpr f32 fixed16_max = 65535.0f;
+
+RK_INTERNAL
+u32 f32_bits(f32 f) noexcept
+{
+    u32 u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+RK_INTERNAL
+f32 bits_f32(u32 u) noexcept
+{
+    f32 f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/*
+ * Half conversions. Normal values are rebiased and rounded with integer arithmetic. Subnormal
+ * halves are rounded by adding a magic float whose exponent lines the half's mantissa bits up with
+ * the bottom of the float's mantissa, letting the FPU do round to nearest even.
+ */
+
+u16 rk::f32_to_half(f32 f) noexcept
+{
+    constexpr u32 f32_infinity = 255U << 23;
+    constexpr u32 f16_max = (127U + 16U) << 23; // Everything from here up is inf or NaN
+    constexpr u32 min_normal = (127U - 14U) << 23;
+    constexpr u32 subnormal_magic = ((127U - 15U) + (23U - 10U) + 1U) << 23;
+
+    u32 u = f32_bits(f);
+    u32 const sign = u & 0x80000000U;
+    u ^= sign;
+
+    u32 h;
+    if (u >= f16_max) {
+        h = (u > f32_infinity) ? 0x7e00U : 0x7c00U;
+    } else if (u < min_normal) {
+        h = f32_bits(bits_f32(u) + bits_f32(subnormal_magic)) - subnormal_magic;
+    } else {
+        u32 const mantissa_odd = (u >> 13) & 1U;
+        u += ((15U - 127U) << 23) + 0xfffU + mantissa_odd;
+        h = u >> 13;
+    }
+    return static_cast<u16>(h | (sign >> 16));
+}
+
+f32 rk::half_to_f32(u16 h) noexcept
+{
+    constexpr u32 shifted_exponent = 0x7c00U << 13;
+    constexpr u32 magic = 113U << 23;
+
+    u32 u = (h & 0x7fffU) << 13;
+    u32 const exponent = u & shifted_exponent;
+    u += (127U - 15U) << 23;
+
+    if (exponent == shifted_exponent) {
+        u += (128U - 16U) << 23; // Inf or NaN
+    } else if (exponent == 0) {
+        u += 1U << 23; // Zero or subnormal, renormalize
+        u = f32_bits(bits_f32(u) - bits_f32(magic));
+    }
+    return bits_f32(u | (static_cast<u32>(h & 0x8000U) << 16));
+}
+
+RK_INTERNAL
+s16 f32_to_snorm16(f32 f) noexcept
+{
+    // lrint rounds to nearest even like cvtps2dq. NaN maps to 0.
+    f32 const clamped = std::isnan(f) ? 0.0f : std::clamp(f, -1.0f, 1.0f);
+    return static_cast<s16>(std::lrint(clamped * snorm16_max));
+}
+
+RK_INTERNAL
+f32 snorm16_to_f32(s16 s) noexcept
+{
+    return std::max(static_cast<f32>(s) / snorm16_max, -1.0f);
+}
+
+Half_Vector3 rk::pack_half(Vector3 const& v) noexcept
+{
+    return {{f32_to_half(v[0]), f32_to_half(v[1]), f32_to_half(v[2])}};
+}
+
+Vector3 rk::unpack(Half_Vector3 const& v) noexcept
+{
+    return {half_to_f32(v.v[0]), half_to_f32(v.v[1]), half_to_f32(v.v[2])};
+}
+
+Snorm16_Vector3 rk::pack_snorm16(Vector3 const& v) noexcept
+{
+    return {{f32_to_snorm16(v[0]), f32_to_snorm16(v[1]), f32_to_snorm16(v[2])}};
+}
+
+Vector3 rk::unpack(Snorm16_Vector3 const& v) noexcept
+{
+    return {snorm16_to_f32(v.v[0]), snorm16_to_f32(v.v[1]), snorm16_to_f32(v.v[2])};
+}
+
+Octahedral_Vector3 rk::pack_octahedral(Vector3 const& v) noexcept
+{
+    f32 const l1 = std::abs(v[0]) + std::abs(v[1]) + std::abs(v[2]);
+    if (!(l1 > 0.0f)) { return {}; }
+
+    f32 x = v[0] / l1;
+    f32 y = v[1] / l1;
+    if (v[2] < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        f32 const folded_x = (1.0f - std::abs(y)) * std::copysign(1.0f, x);
+        f32 const folded_y = (1.0f - std::abs(x)) * std::copysign(1.0f, y);
+        x = folded_x;
+        y = folded_y;
+    }
+    return {{f32_to_snorm16(x), f32_to_snorm16(y)}};
+}
+
+Vector3 rk::unpack(Octahedral_Vector3 const& v) noexcept
+{
+    f32 x = snorm16_to_f32(v.v[0]);
+    f32 y = snorm16_to_f32(v.v[1]);
+    f32 const z = 1.0f - std::abs(x) - std::abs(y);
+    f32 const t = std::max(-z, 0.0f);
+    x -= std::copysign(t, x);
+    y -= std::copysign(t, y);
+
+    f32 const len = std::sqrt(x * x + y * y + z * z);
+    return {x / len, y / len, z / len};
+}
+
+RK_INTERNAL
+u16 f32_to_fixed16(f32 f, f32 origin, f32 inv_step) noexcept
+{
+    f32 const scaled = (f - origin) * inv_step;
+    f32 const clamped = std::isnan(scaled) ? 0.0f : std::clamp(scaled, 0.0f, fixed16_max);
+    return static_cast<u16>(std::lrint(clamped));
+}
+
+Fixed16_Vector3 rk::pack_fixed16(Vector3 const& v, Fixed_Point_Cell const& cell) noexcept
+{
+    RK_ASSERT(cell.size > 0.0f);
+    f32 const inv_step = fixed16_max / cell.size;
+    return {{f32_to_fixed16(v[0], cell.origin[0], inv_step),
+             f32_to_fixed16(v[1], cell.origin[1], inv_step),
+             f32_to_fixed16(v[2], cell.origin[2], inv_step)}};
+}
+
+Vector3 rk::unpack(Fixed16_Vector3 const& v, Fixed_Point_Cell const& cell) noexcept
+{
+    f32 const step = cell.size / fixed16_max;
+    return {cell.origin[0] + static_cast<f32>(v.v[0]) * step,
+            cell.origin[1] + static_cast<f32>(v.v[1]) * step,
+            cell.origin[2] + static_cast<f32>(v.v[2]) * step};
+}
+
+/*
+ * Array kernels. Vector3 and the packed formats are tightly packed, so half, snorm16 and fixed16
+ * are converted as flat arrays of 3 * count components. Octahedral encoding needs whole vectors
+ * and deinterleaves four at a time.
+ */
+
+RK_INTERNAL
+f32 const* components(Vector3 const* v) noexcept
+{
+    return reinterpret_cast<f32 const*>(v);
+}
+
+RK_INTERNAL
+f32* components(Vector3* v) noexcept
+{
+    return reinterpret_cast<f32*>(v);
+}
+
+#if RK_SIMD_SSE
+RK_INTERNAL
+__m128i f32x4_to_half(__m128 f) noexcept
+{
+#    if RK_SIMD_F16C
+    return _mm_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+#    else
+    // Four lane version of f32_to_half. Each lane ends up as an s32 whose low 16 bits are the half
+    // (negative values are sign extended), so a signed pack returns exactly those bits.
+    __m128 const sign = _mm_and_ps(f, _mm_set1_ps(-0.0f));
+    __m128 const abs_f = _mm_xor_ps(f, sign);
+    __m128i const abs_u = _mm_castps_si128(abs_f);
+
+    __m128i const subnormal_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    __m128i const is_regular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), abs_u);
+    __m128i const is_subnormal = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), abs_u);
+    __m128i const is_nan = _mm_castps_si128(_mm_cmpunord_ps(abs_f, abs_f));
+    __m128i const inf_or_nan =
+        _mm_or_si128(_mm_and_si128(is_nan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+    __m128i const subnormal = _mm_sub_epi32(
+        _mm_castps_si128(_mm_add_ps(abs_f, _mm_castsi128_ps(subnormal_magic))), subnormal_magic);
+
+    __m128i const mantissa_odd = _mm_srai_epi32(_mm_slli_epi32(abs_u, 31 - 13), 31); // 0 or -1
+    __m128i normal = _mm_add_epi32(abs_u, _mm_set1_epi32(0xfff - ((127 - 15) << 23)));
+    normal = _mm_srli_epi32(_mm_sub_epi32(normal, mantissa_odd), 13);
+
+    __m128i h = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal),
+                             _mm_andnot_si128(is_subnormal, normal));
+    h = _mm_or_si128(_mm_and_si128(is_regular, h), _mm_andnot_si128(is_regular, inf_or_nan));
+    h = _mm_or_si128(h, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+    return _mm_packs_epi32(h, h);
+#    endif
+}
+
+RK_INTERNAL
+__m128 half_to_f32x4(__m128i h) noexcept
+{
+#    if RK_SIMD_F16C
+    return _mm_cvtph_ps(h);
+#    else
+    // Scaling by 2^112 rebiases the exponent and renormalizes subnormals in one multiply
+    __m128i const h32 = _mm_unpacklo_epi16(h, _mm_setzero_si128());
+    __m128i const exp_mantissa = _mm_and_si128(h32, _mm_set1_epi32(0x7fff));
+    __m128i const sign = _mm_slli_epi32(_mm_xor_si128(h32, exp_mantissa), 16);
+    __m128 const scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exp_mantissa, 13)),
+                                     _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+    __m128i const was_inf_nan = _mm_cmpgt_epi32(exp_mantissa, _mm_set1_epi32(0x7bff));
+    __m128i const inf_nan_exponent = _mm_and_si128(was_inf_nan, _mm_set1_epi32(255 << 23));
+    return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, inf_nan_exponent)));
+#    endif
+}
+
+/**
+ * \brief Clamp to [lo, hi]. NaN becomes 0, as in the scalar code.
+ */
+RK_INTERNAL
+__m128 clamp_ps(__m128 v, __m128 lo, __m128 hi) noexcept
+{
+    v = _mm_and_ps(_mm_cmpord_ps(v, v), v);
+    return _mm_min_ps(_mm_max_ps(v, lo), hi);
+}
+
+/**
+ * \brief Signed pack of u16 values held in s32 lanes without SSE4.1's `_mm_packus_epi32`.
+ */
+RK_INTERNAL
+__m128i pack_u16(__m128i a, __m128i b) noexcept
+{
+    __m128i const bias = _mm_set1_epi32(0x8000);
+    __m128i const packed = _mm_packs_epi32(_mm_sub_epi32(a, bias), _mm_sub_epi32(b, bias));
+    return _mm_xor_si128(packed, _mm_set1_epi16(static_cast<s16>(0x8000)));
+}
+
+/**
+ * \brief Deinterleave four consecutive Vector3s into x, y and z lanes.
+ */
+RK_INTERNAL
+void load_vector3x4(f32 const* p, __m128& x, __m128& y, __m128& z) noexcept
+{
+    __m128 const a = _mm_loadu_ps(p);     // x0 y0 z0 x1
+    __m128 const b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+    __m128 const c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, RK_SIMD_SHUFFLE_MASK(2, 0, 1, 0)),
+                       RK_SIMD_SHUFFLE_MASK(0, 3, 0, 2));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, RK_SIMD_SHUFFLE_MASK(1, 0, 0, 0)),
+                       _mm_shuffle_ps(b, c, RK_SIMD_SHUFFLE_MASK(3, 0, 2, 0)),
+                       RK_SIMD_SHUFFLE_MASK(0, 2, 0, 2));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, RK_SIMD_SHUFFLE_MASK(2, 0, 1, 0)),
+                       _mm_shuffle_ps(c, c, RK_SIMD_SHUFFLE_MASK(0, 0, 3, 0)),
+                       RK_SIMD_SHUFFLE_MASK(0, 2, 0, 2));
+}
+
+/**
+ * \brief Interleave x, y and z lanes into four consecutive Vector3s.
+ */
+RK_INTERNAL
+void store_vector3x4(f32* p, __m128 x, __m128 y, __m128 z) noexcept
+{
+    __m128 const xy_lo = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+    __m128 const xy_hi = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+    __m128 const yz_lo = _mm_unpacklo_ps(y, z); // y0 z0 y1 z1
+    __m128 const zx = _mm_shuffle_ps(z, x, RK_SIMD_SHUFFLE_MASK(0, 0, 1, 1));
+    __m128 const zxy = _mm_shuffle_ps(z, xy_hi, RK_SIMD_SHUFFLE_MASK(2, 3, 2, 3));
+
+    _mm_storeu_ps(p, _mm_shuffle_ps(xy_lo, zx, RK_SIMD_SHUFFLE_MASK(0, 1, 0, 2)));
+    _mm_storeu_ps(p + 4, _mm_shuffle_ps(yz_lo, xy_hi, RK_SIMD_SHUFFLE_MASK(2, 3, 0, 1)));
+    _mm_storeu_ps(p + 8, _mm_shuffle_ps(zxy, zxy, RK_SIMD_SHUFFLE_MASK(0, 2, 3, 1)));
+}
+
+RK_INTERNAL
+__m128 abs_ps(__m128 v) noexcept
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+RK_INTERNAL
+__m128 copysign_ps(__m128 magnitude, __m128 sign) noexcept
+{
+    __m128 const sign_mask = _mm_set1_ps(-0.0f);
+    return _mm_or_ps(_mm_andnot_ps(sign_mask, magnitude), _mm_and_ps(sign_mask, sign));
+}
+#endif
+
+void rk::pack_half(Vector3 const* in, Half_Vector3* out, s32 count) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT((in && out) || count == 0);
+
+    f32 const* RK_RESTRICT src = components(in);
+    u16* RK_RESTRICT dst = reinterpret_cast<u16*>(out);
+    s32 const n = 3 * count;
+    s32 i = 0;
+
+#if RK_SIMD_SSE
+    for (; i + 4 <= n; i += 4) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), f32x4_to_half(_mm_loadu_ps(src + i)));
+    }
+#endif
+
+    for (; i < n; ++i) { dst[i] = f32_to_half(src[i]); }
+}
+
+void rk::unpack(Half_Vector3 const* in, Vector3* out, s32 count) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT((in && out) || count == 0);
+
+    u16 const* RK_RESTRICT src = reinterpret_cast<u16 const*>(in);
+    f32* RK_RESTRICT dst = components(out);
+    s32 const n = 3 * count;
+    s32 i = 0;
+
+#if RK_SIMD_SSE
+    for (; i + 4 <= n; i += 4) {
+        __m128i const h = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(src + i));
+        _mm_storeu_ps(dst + i, half_to_f32x4(h));
+    }
+#endif
+
+    for (; i < n; ++i) { dst[i] = half_to_f32(src[i]); }
+}
+
+void rk::pack_snorm16(Vector3 const* in, Snorm16_Vector3* out, s32 count) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT((in && out) || count == 0);
+
+    f32 const* RK_RESTRICT src = components(in);
+    s16* RK_RESTRICT dst = reinterpret_cast<s16*>(out);
+    s32 const n = 3 * count;
+    s32 i = 0;
+
+#if RK_SIMD_SSE
+    __m128 const lo = _mm_set1_ps(-1.0f);
+    __m128 const hi = _mm_set1_ps(1.0f);
+    __m128 const scale = _mm_set1_ps(snorm16_max);
+    for (; i + 8 <= n; i += 8) {
+        __m128i const a =
+            _mm_cvtps_epi32(_mm_mul_ps(clamp_ps(_mm_loadu_ps(src + i), lo, hi), scale));
+        __m128i const b =
+            _mm_cvtps_epi32(_mm_mul_ps(clamp_ps(_mm_loadu_ps(src + i + 4), lo, hi), scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+    }
+#endif
+
+    for (; i < n; ++i) { dst[i] = f32_to_snorm16(src[i]); }
+}
+
+void rk::unpack(Snorm16_Vector3 const* in, Vector3* out, s32 count) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT((in && out) || count == 0);
+
+    s16 const* RK_RESTRICT src = reinterpret_cast<s16 const*>(in);
+    f32* RK_RESTRICT dst = components(out);
+    s32 const n = 3 * count;
+    s32 i = 0;
+
+#if RK_SIMD_SSE
+    __m128 const scale = _mm_set1_ps(snorm16_max);
+    __m128 const lo = _mm_set1_ps(-1.0f);
+    for (; i + 8 <= n; i += 8) {
+        __m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+        // Sign extend by unpacking into the high halves and shifting down
+        __m128i const a = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i const b = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(dst + i, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(a), scale), lo));
+        _mm_storeu_ps(dst + i + 4, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(b), scale), lo));
+    }
+#endif
+
+    for (; i < n; ++i) { dst[i] = snorm16_to_f32(src[i]); }
+}
+
+void rk::pack_octahedral(Vector3 const* in, Octahedral_Vector3* out, s32 count) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT((in && out) || count == 0);
+
+    s32 i = 0;
+
+#if RK_SIMD_SSE
+    f32 const* RK_RESTRICT src = components(in);
+    s16* RK_RESTRICT dst = reinterpret_cast<s16*>(out);
+    __m128 const zero = _mm_setzero_ps();
+    __m128 const one = _mm_set1_ps(1.0f);
+    __m128 const lo = _mm_set1_ps(-1.0f);
+    __m128 const scale = _mm_set1_ps(snorm16_max);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        load_vector3x4(src + 3 * i, x, y, z);
+
+        __m128 const l1 = _mm_add_ps(_mm_add_ps(abs_ps(x), abs_ps(y)), abs_ps(z));
+        __m128 const valid = _mm_cmpgt_ps(l1, zero);
+        __m128 const px = _mm_and_ps(valid, _mm_div_ps(x, l1));
+        __m128 const py = _mm_and_ps(valid, _mm_div_ps(y, l1));
+
+        __m128 const lower = _mm_cmplt_ps(z, zero);
+        __m128 const folded_x = _mm_mul_ps(_mm_sub_ps(one, abs_ps(py)), copysign_ps(one, px));
+        __m128 const folded_y = _mm_mul_ps(_mm_sub_ps(one, abs_ps(px)), copysign_ps(one, py));
+        __m128 const ox = _mm_or_ps(_mm_and_ps(lower, folded_x), _mm_andnot_ps(lower, px));
+        __m128 const oy = _mm_or_ps(_mm_and_ps(lower, folded_y), _mm_andnot_ps(lower, py));
+
+        __m128i const qx = _mm_cvtps_epi32(_mm_mul_ps(clamp_ps(ox, lo, one), scale));
+        __m128i const qy = _mm_cvtps_epi32(_mm_mul_ps(clamp_ps(oy, lo, one), scale));
+        __m128i const packed =
+            _mm_packs_epi32(_mm_unpacklo_epi32(qx, qy), _mm_unpackhi_epi32(qx, qy));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), packed);
+    }
+#endif
+
+    for (; i < count; ++i) { out[i] = pack_octahedral(in[i]); }
+}
+
+void rk::unpack(Octahedral_Vector3 const* in, Vector3* out, s32 count) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT((in && out) || count == 0);
+
+    s32 i = 0;
+
+#if RK_SIMD_SSE
+    s16 const* RK_RESTRICT src = reinterpret_cast<s16 const*>(in);
+    f32* RK_RESTRICT dst = components(out);
+    __m128 const zero = _mm_setzero_ps();
+    __m128 const one = _mm_set1_ps(1.0f);
+    __m128 const lo = _mm_set1_ps(-1.0f);
+    __m128 const scale = _mm_set1_ps(snorm16_max);
+    for (; i + 4 <= count; i += 4) {
+        __m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 2 * i));
+        __m128 const a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+        __m128 const b = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+        __m128 x = _mm_max_ps(_mm_div_ps(_mm_shuffle_ps(a, b, RK_SIMD_SHUFFLE_MASK(0, 2, 0, 2)),
+                                         scale),
+                              lo);
+        __m128 y = _mm_max_ps(_mm_div_ps(_mm_shuffle_ps(a, b, RK_SIMD_SHUFFLE_MASK(1, 3, 1, 3)),
+                                         scale),
+                              lo);
+
+        __m128 const z = _mm_sub_ps(_mm_sub_ps(one, abs_ps(x)), abs_ps(y));
+        __m128 const t = _mm_max_ps(_mm_sub_ps(zero, z), zero);
+        x = _mm_sub_ps(x, copysign_ps(t, x));
+        y = _mm_sub_ps(y, copysign_ps(t, y));
+
+        __m128 const len = _mm_sqrt_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        store_vector3x4(dst + 3 * i, _mm_div_ps(x, len), _mm_div_ps(y, len), _mm_div_ps(z, len));
+    }
+#endif
+
+    for (; i < count; ++i) { out[i] = unpack(in[i]); }
+}
+
+void rk::pack_fixed16(Vector3 const* in, Fixed16_Vector3* out, s32 count,
+                      Fixed_Point_Cell const& cell) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT((in && out) || count == 0);
+    RK_ASSERT(cell.size > 0.0f);
+
+    f32 const* RK_RESTRICT src = components(in);
+    u16* RK_RESTRICT dst = reinterpret_cast<u16*>(out);
+    f32 const inv_step = fixed16_max / cell.size;
+    s32 const n = 3 * count;
+    s32 i = 0;
+
+#if RK_SIMD_SSE
+    // Twelve components are four whole vectors, so the origin repeats with a period of three
+    // registers
+    f32 const ox = cell.origin[0];
+    f32 const oy = cell.origin[1];
+    f32 const oz = cell.origin[2];
+    __m128 const origin0 = _mm_setr_ps(ox, oy, oz, ox);
+    __m128 const origin1 = _mm_setr_ps(oy, oz, ox, oy);
+    __m128 const origin2 = _mm_setr_ps(oz, ox, oy, oz);
+    __m128 const scale = _mm_set1_ps(inv_step);
+    __m128 const lo = _mm_setzero_ps();
+    __m128 const hi = _mm_set1_ps(fixed16_max);
+    for (; i + 12 <= n; i += 12) {
+        __m128 const a = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + i), origin0), scale);
+        __m128 const b = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + i + 4), origin1), scale);
+        __m128 const c = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + i + 8), origin2), scale);
+        __m128i const qa = _mm_cvtps_epi32(clamp_ps(a, lo, hi));
+        __m128i const qb = _mm_cvtps_epi32(clamp_ps(b, lo, hi));
+        __m128i const qc = _mm_cvtps_epi32(clamp_ps(c, lo, hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), pack_u16(qa, qb));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i + 8), pack_u16(qc, qc));
+    }
+#endif
+
+    for (; i < n; ++i) { dst[i] = f32_to_fixed16(src[i], cell.origin[i % 3], inv_step); }
+}
+
+void rk::unpack(Fixed16_Vector3 const* in, Vector3* out, s32 count,
+                Fixed_Point_Cell const& cell) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT((in && out) || count == 0);
+
+    u16 const* RK_RESTRICT src = reinterpret_cast<u16 const*>(in);
+    f32* RK_RESTRICT dst = components(out);
+    f32 const step = cell.size / fixed16_max;
+    s32 const n = 3 * count;
+    s32 i = 0;
+
+#if RK_SIMD_SSE
+    f32 const ox = cell.origin[0];
+    f32 const oy = cell.origin[1];
+    f32 const oz = cell.origin[2];
+    __m128 const origin0 = _mm_setr_ps(ox, oy, oz, ox);
+    __m128 const origin1 = _mm_setr_ps(oy, oz, ox, oy);
+    __m128 const origin2 = _mm_setr_ps(oz, ox, oy, oz);
+    __m128 const scale = _mm_set1_ps(step);
+    __m128i const zero = _mm_setzero_si128();
+    for (; i + 12 <= n; i += 12) {
+        __m128i const ab = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+        __m128i const c = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(src + i + 8));
+        __m128 const fa = _mm_cvtepi32_ps(_mm_unpacklo_epi16(ab, zero));
+        __m128 const fb = _mm_cvtepi32_ps(_mm_unpackhi_epi16(ab, zero));
+        __m128 const fc = _mm_cvtepi32_ps(_mm_unpacklo_epi16(c, zero));
+        _mm_storeu_ps(dst + i, _mm_add_ps(origin0, _mm_mul_ps(fa, scale)));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(origin1, _mm_mul_ps(fb, scale)));
+        _mm_storeu_ps(dst + i + 8, _mm_add_ps(origin2, _mm_mul_ps(fc, scale)));
+    }
+#endif
+
+    for (; i < n; ++i) { dst[i] = cell.origin[i % 3] + static_cast<f32>(src[i]) * step; }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/math/vector.h"
+#include "core/types.h"
+#include <array>
+
+/**
+ * \file packed.h
+ * \brief Quantized vector formats for memory and bandwidth bound data.
+ *
+ * | Format               | Size     | Use                                 | GL vertex format     |
+ * |----------------------|----------|-------------------------------------|----------------------|
+ * | `Vector3`            | 12 bytes | Reference                           | `GL_FLOAT`           |
+ * | `Half_Vector3`       | 6 bytes  | General values, ~3 decimal digits   | `GL_HALF_FLOAT`      |
+ * | `Snorm16_Vector3`    | 6 bytes  | Values in [-1, 1], e.g. normals     | `GL_SHORT`, norm.    |
+ * | `Octahedral_Vector3` | 4 bytes  | Unit vectors                        | 2 x `GL_SHORT`, norm.|
+ * | `Fixed16_Vector3`    | 6 bytes  | Positions in a `Fixed_Point_Cell`   | `GL_UNSIGNED_SHORT`  |
+ *
+ * Scalar functions convert one value, array functions convert \a count values with SIMD kernels
+ * where available. Both pack to identical bits. Rounding is to nearest even throughout.
+ */
+
+namespace rk
+{
+/** \brief Three IEEE 754 binary16 floats. */
+struct Half_Vector3 {
+    std::array<u16, 3> v{};
+};
+
+/** \brief Three signed normalized 16-bit values. -32767 is -1, 32767 is 1. */
+struct Snorm16_Vector3 {
+    std::array<s16, 3> v{};
+};
+
+/**
+ * \brief Unit vector in octahedral encoding, two snorm16 values.
+ *
+ * The unit sphere is projected onto an octahedron which is unfolded onto a square. The error is
+ * under 0.0001 radians and spread evenly over the sphere.
+ */
+struct Octahedral_Vector3 {
+    std::array<s16, 2> v{};
+};
+
+/** \brief Position quantized to 16 bits per axis relative to a `Fixed_Point_Cell`. */
+struct Fixed16_Vector3 {
+    std::array<u16, 3> v{};
+};
+
+/**
+ * \brief Cube of space that `Fixed16_Vector3` positions are relative to.
+ *
+ * Positions in [origin, origin + size] are represented with a step of `size / 65535`, e.g. a 64
+ * unit cell has about 1/1000 unit precision. Positions outside the cell are clamped.
+ */
+struct Fixed_Point_Cell {
+    Vector3 origin;
+    f32 size = 1.0f;
+};
+
+/** \brief Convert to binary16. Out of range values become infinity, NaN stays NaN. */
+[[nodiscard]] u16 f32_to_half(f32 f) noexcept;
+/** \brief Convert from binary16. Exact. */
+[[nodiscard]] f32 half_to_f32(u16 h) noexcept;
+
+[[nodiscard]] Half_Vector3 pack_half(Vector3 const& v) noexcept;
+[[nodiscard]] Vector3 unpack(Half_Vector3 const& v) noexcept;
+
+/** \brief Components are clamped to [-1, 1]. */
+[[nodiscard]] Snorm16_Vector3 pack_snorm16(Vector3 const& v) noexcept;
+[[nodiscard]] Vector3 unpack(Snorm16_Vector3 const& v) noexcept;
+
+/** \brief \a v should be unit length. The zero vector packs to +z. */
+[[nodiscard]] Octahedral_Vector3 pack_octahedral(Vector3 const& v) noexcept;
+/** \brief The result is unit length. */
+[[nodiscard]] Vector3 unpack(Octahedral_Vector3 const& v) noexcept;
+
+[[nodiscard]] Fixed16_Vector3 pack_fixed16(Vector3 const& v, Fixed_Point_Cell const& cell) noexcept;
+[[nodiscard]] Vector3 unpack(Fixed16_Vector3 const& v, Fixed_Point_Cell const& cell) noexcept;
+
+/**
+ * \brief Array versions of the above. \a in and \a out hold \a count values and must not overlap.
+ */
+void pack_half(Vector3 const* in, Half_Vector3* out, s32 count) noexcept;
+void unpack(Half_Vector3 const* in, Vector3* out, s32 count) noexcept;
+void pack_snorm16(Vector3 const* in, Snorm16_Vector3* out, s32 count) noexcept;
+void unpack(Snorm16_Vector3 const* in, Vector3* out, s32 count) noexcept;
+void pack_octahedral(Vector3 const* in, Octahedral_Vector3* out, s32 count) noexcept;
+void unpack(Octahedral_Vector3 const* in, Vector3* out, s32 count) noexcept;
+void pack_fixed16(Vector3 const* in, Fixed16_Vector3* out, s32 count,
+                  Fixed_Point_Cell const& cell) noexcept;
+void unpack(Fixed16_Vector3 const* in, Vector3* out, s32 count,
+            Fixed_Point_Cell const& cell) noexcept;
+} // namespace rk
@@ -0,0 +1,123 @@
+#include "core/math/quaternion.h"
+
+#include "core/assert.h"
+#include "core/math/matrix.h"
+#include "core/math/simd.h"
+#include <cmath>
+
+using namespace rk;
+using namespace sds;
+
+Quat Quat::from_axis_angle(Vector3 const& axis, f32 radians)
+{
+    f32 const half = radians * 0.5f;
+    f32 const s = std::sin(half);
+    return {axis.x() * s, axis.y() * s, axis.z() * s, std::cos(half)};
+}
+
+f32 Quat::x() const { return q[0]; }
+f32 Quat::y() const { return q[1]; }
+f32 Quat::z() const { return q[2]; }
+f32 Quat::w() const { return q[3]; }
+
+f32 Quat::operator[](size_t i) const { return q[i]; }
+f32& Quat::operator[](size_t i) { return q[i]; }
+
+Quat& Quat::operator*=(Quat const& o)
+{
+    *this = *this * o;
+    return *this;
+}
+
+f32 Quat::length() const { return std::sqrt(squared_length()); }
+
+f32 Quat::squared_length() const { return dot(*this, *this); }
+
+Quat Quat::conjugate() const { return {-q[0], -q[1], -q[2], q[3]}; }
+
+Quat Quat::inverse() const
+{
+    f32 const len2 = squared_length();
+    RK_ASSERT(len2 > 0.0f);
+    f32 const k = 1.0f / len2;
+    return {-q[0] * k, -q[1] * k, -q[2] * k, q[3] * k};
+}
+
+Vector3 Quat::rotate(Vector3 const& v) const
+{
+    // v' = v + 2w(u x v) + 2(u x (u x v)), where u is the vector part
+    Vector3 const u(q[0], q[1], q[2]);
+    Vector3 const t = 2.0f * cross(u, v);
+    return v + q[3] * t + cross(u, t);
+}
+
+Mat4 Quat::to_mat4() const
+{
+    f32 const xx = q[0] * q[0];
+    f32 const yy = q[1] * q[1];
+    f32 const zz = q[2] * q[2];
+    f32 const xy = q[0] * q[1];
+    f32 const xz = q[0] * q[2];
+    f32 const yz = q[1] * q[2];
+    f32 const wx = q[3] * q[0];
+    f32 const wy = q[3] * q[1];
+    f32 const wz = q[3] * q[2];
+
+    return Mat4({1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f, //
+                 2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f, //
+                 2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f, //
+                 0.0f, 0.0f, 0.0f, 1.0f});
+}
+
+bool rk::operator==(Quat const& lhs, Quat const& rhs)
+{
+    return (lhs[0] == rhs[0]) && (lhs[1] == rhs[1]) && (lhs[2] == rhs[2]) && (lhs[3] == rhs[3]);
+}
+
+bool rk::operator!=(Quat const& lhs, Quat const& rhs) { return !(lhs == rhs); }
+
+Quat rk::operator*(Quat const& lhs, Quat const& rhs)
+{
+#if RK_SIMD_SSE
+    // Hamilton product as a sum of the lhs components scaling signed permutations of rhs:
+    //   w1 * ( x2,  y2,  z2,  w2)
+    //   x1 * ( w2, -z2,  y2, -x2)
+    //   y1 * ( z2,  w2, -x2, -y2)
+    //   z1 * (-y2,  x2,  w2, -z2)
+    __m128 const a = _mm_load_ps(lhs.data());
+    __m128 const b = _mm_load_ps(rhs.data());
+
+    __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, RK_SIMD_SHUFFLE_MASK(3, 3, 3, 3)), b);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, RK_SIMD_SHUFFLE_MASK(0, 0, 0, 0)),
+                                            _mm_shuffle_ps(b, b, RK_SIMD_SHUFFLE_MASK(3, 2, 1, 0))),
+                                 _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, RK_SIMD_SHUFFLE_MASK(1, 1, 1, 1)),
+                                            _mm_shuffle_ps(b, b, RK_SIMD_SHUFFLE_MASK(2, 3, 0, 1))),
+                                 _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, RK_SIMD_SHUFFLE_MASK(2, 2, 2, 2)),
+                                            _mm_shuffle_ps(b, b, RK_SIMD_SHUFFLE_MASK(1, 0, 3, 2))),
+                                 _mm_setr_ps(-1.0f, 1.0f, 1.0f, -1.0f)));
+
+    Quat out;
+    _mm_store_ps(out.data(), r);
+    return out;
+#else
+    f32 const x1 = lhs[0], y1 = lhs[1], z1 = lhs[2], w1 = lhs[3];
+    f32 const x2 = rhs[0], y2 = rhs[1], z2 = rhs[2], w2 = rhs[3];
+    return {w1 * x2 + x1 * w2 + y1 * z2 - z1 * y2, w1 * y2 - x1 * z2 + y1 * w2 + z1 * x2,
+            w1 * z2 + x1 * y2 - y1 * x2 + z1 * w2, w1 * w2 - x1 * x2 - y1 * y2 - z1 * z2};
+#endif
+}
+
+f32 rk::dot(Quat const& q1, Quat const& q2)
+{
+    return q1[0] * q2[0] + q1[1] * q2[1] + q1[2] * q2[2] + q1[3] * q2[3];
+}
+
+Quat rk::normalize(Quat const& q)
+{
+    f32 const len = q.length();
+    RK_ASSERT(len > 0.0f);
+    f32 const k = 1.0f / len;
+    return {q[0] * k, q[1] * k, q[2] * k, q[3] * k};
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/math/vector.h"
+#include "core/types.h"
+#include <array>
+
+namespace rk
+{
+class Mat4;
+
+/**
+ * \brief Rotation quaternion.
+ *
+ * Stored as (x, y, z, w), matching the default `glm::quat` layout.
+ */
+class alignas(16) Quat {
+public:
+    /**
+     * \brief Identity rotation.
+     */
+    Quat() = default;
+    Quat(f32 x, f32 y, f32 z, f32 w) : q{{x, y, z, w}} {}
+
+    /**
+     * \brief Rotation of \a radians about \a axis. The axis must be normalized.
+     */
+    [[nodiscard]] static Quat from_axis_angle(Vector3 const& axis, f32 radians);
+
+    [[nodiscard]] f32 x() const;
+    [[nodiscard]] f32 y() const;
+    [[nodiscard]] f32 z() const;
+    [[nodiscard]] f32 w() const;
+
+    f32 operator[](size_t i) const;
+    f32& operator[](size_t i);
+
+    [[nodiscard]] f32 const* data() const { return q.data(); }
+    [[nodiscard]] f32* data() { return q.data(); }
+
+    /**
+     * \brief Compose rotations. `a * b` applies \a b first, then \a a.
+     */
+    Quat& operator*=(Quat const& o);
+
+    [[nodiscard]] f32 length() const;
+    [[nodiscard]] f32 squared_length() const;
+    [[nodiscard]] Quat conjugate() const;
+
+    /**
+     * \brief Inverse rotation. Equal to the conjugate for unit quaternions.
+     */
+    [[nodiscard]] Quat inverse() const;
+
+    /**
+     * \brief Rotate a vector.
+     */
+    [[nodiscard]] Vector3 rotate(Vector3 const& v) const;
+
+    [[nodiscard]] Mat4 to_mat4() const;
+
+private:
+    std::array<f32, 4> q{{0.0f, 0.0f, 0.0f, 1.0f}};
+};
+
+bool operator==(Quat const& lhs, Quat const& rhs);
+bool operator!=(Quat const& lhs, Quat const& rhs);
+
+Quat operator*(Quat const& lhs, Quat const& rhs);
+
+f32 dot(Quat const& q1, Quat const& q2);
+Quat normalize(Quat const& q);
+} // namespace rk
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/types.h"
+
+/**
+ * \file simd.h
+ * \brief SIMD instruction set detection for the math library.
+ *
+ * Instruction sets are detected from the compiler's target flags. Code paths are selected at
+ * compile time; there is no runtime dispatch here.
+ *
+ * Define \a RK_SIMD_DISABLED to force the scalar code paths (useful for validating the SIMD paths
+ * against a reference).
+ */
+
+/**
+ * \def RK_SIMD_SSE
+ * \brief 1 if SSE2 is available, 0 otherwise.
+ */
+#if !defined(RK_SIMD_DISABLED) &&                                           \
+    (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) ||           \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#    define RK_SIMD_SSE 1
+#    include <emmintrin.h>
+#    include <xmmintrin.h>
+#else
+#    define RK_SIMD_SSE 0
+#endif
+
+/**
+ * \def RK_SIMD_AVX
+ * \brief 1 if AVX is available, 0 otherwise.
+ */
+#if !defined(RK_SIMD_DISABLED) && defined(__AVX__)
+#    define RK_SIMD_AVX 1
+#    include <immintrin.h>
+#else
+#    define RK_SIMD_AVX 0
+#endif
+
+/**
+ * \def RK_SIMD_F16C
+ * \brief 1 if the F16C half-float conversion instructions are available, 0 otherwise.
+ */
+#if !defined(RK_SIMD_DISABLED) && defined(__F16C__)
+#    define RK_SIMD_F16C 1
+#    include <immintrin.h>
+#else
+#    define RK_SIMD_F16C 0
+#endif
+
+/**
+ * \def RK_SIMD_SHUFFLE_MASK
+ * \brief Build a shuffle immediate for `_mm_shuffle_ps`. Lane indices are in memory order.
+ */
+#define RK_SIMD_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
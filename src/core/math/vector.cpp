@@ -1,9 +1,10 @@
 #include "core/math/vector.h"
 
 #include "core/assert.h"
+#include "core/math/charconv.h"
+#include <array>
 #include <cassert>
 #include <cmath>
-#include <sstream>
 
 using namespace rk;
 using namespace sds;
@@ -83,16 +84,20 @@ bool Vector3::is_nan() const
 
 std::string Vector3::to_string() const
 {
-    std::stringstream ss;
-    ss << vec[0] << " " << vec[1] << " " << vec[2];
-    return ss.str();
+    std::array<char, max_vector3_chars> buf;
+    std::to_chars_result const r = rk::to_chars(buf.data(), buf.data() + buf.size(), *this);
+    RK_ASSERT(r.ec == std::errc());
+    return std::string(buf.data(), r.ptr);
 }
 
 std::istream& rk::operator>>(std::istream& is, Vector3& v) { return is >> v[0] >> v[1] >> v[2]; }
 
 std::ostream& rk::operator<<(std::ostream& os, Vector3 const& v)
 {
-    return os << v[0] << " " << v[1] << " " << v[2];
+    std::array<char, max_vector3_chars> buf;
+    std::to_chars_result const r = rk::to_chars(buf.data(), buf.data() + buf.size(), v);
+    RK_ASSERT(r.ec == std::errc());
+    return os.write(buf.data(), r.ptr - buf.data());
 }
 
 bool rk::operator==(Vector3 const& lhs, Vector3 const& rhs)
@@ -68,6 +68,8 @@ bool fs::Path::is_windows_unc_path() const noexcept
     return unicode::ascii_cmp(m_path.data(), prefix, 8);
 }
 
+fs::Mapped_File::~Mapped_File() noexcept { close(); }
+
 fs::Image::~Image() noexcept { free_data(); }
 
 void fs::Image::free_data() noexcept
@@ -119,6 +119,37 @@ struct Image {
     void free_data() noexcept;
 };
 
+/**
+ * \brief Read only memory mapping of a whole file.
+ *
+ * Pages are loaded by the OS as they are touched, so opening a large file is cheap and only the
+ * parts that are read cost I/O. The mapping is released on `close` or destruction.
+ */
+class Mapped_File {
+public:
+    Mapped_File() noexcept = default;
+    ~Mapped_File() noexcept;
+    Mapped_File(Mapped_File const&) = delete;
+    Mapped_File& operator=(Mapped_File const&) = delete;
+
+    /**
+     * \brief Map the file at \a path. Closes the currently mapped file, if any.
+     *
+     * An empty file maps successfully with a null `data`.
+     */
+    Status open(char const* path) noexcept;
+    void close() noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept { return m_open; }
+    [[nodiscard]] u8 const* data() const noexcept { return m_data; }
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+private:
+    u8 const* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+};
+
 /**
  * \brief Load an image from the given path.
  *
@@ -134,7 +165,7 @@ Status load_image(char const* path, Image& img) noexcept;
 Status get_current_directory(Path& path) noexcept;
 
 /**
- * \brief Create directory.
+ * \brief Create directory. Succeeds if the directory already exists.
  */
 Status create_directory(char const* directory) noexcept;
 
@@ -5,6 +5,8 @@
 #include "sds/types.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -59,3 +61,63 @@ Status fs::directory_exists(char const* path, bool& exists) noexcept {
 
     return Status::ok;
 }
+
+Status fs::file_exists(char const* path, bool& exists) noexcept
+{
+    RK_ASSERT(path);
+
+    struct stat st = {0};
+    if (stat(path, &st) == -1) {
+        exists = false;
+        if (errno == ENOENT || errno == ENOTDIR) { return Status::ok; }
+        LOG_OS_LAST_ERROR("stat");
+        return Status::platform_error;
+    }
+
+    exists = S_ISREG(st.st_mode);
+    return Status::ok;
+}
+
+Status fs::Mapped_File::open(char const* path) noexcept
+{
+    RK_ASSERT(path);
+    close();
+
+    int const fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        LOG_OS_LAST_ERROR("open");
+        return Status::io_error;
+    }
+
+    struct stat st = {0};
+    if (fstat(fd, &st) == -1) {
+        LOG_OS_LAST_ERROR("fstat");
+        ::close(fd);
+        return Status::io_error;
+    }
+
+    size_t const size = static_cast<size_t>(st.st_size);
+    if (size > 0) {
+        void* const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            LOG_OS_LAST_ERROR("mmap");
+            ::close(fd);
+            return Status::io_error;
+        }
+        m_data = static_cast<u8 const*>(data);
+    }
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+
+    m_size = size;
+    m_open = true;
+    return Status::ok;
+}
+
+void fs::Mapped_File::close() noexcept
+{
+    if (m_data) { munmap(const_cast<u8*>(m_data), m_size); }
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
@@ -41,7 +41,8 @@ Status fs::create_directory(char const* directory) noexcept
         return Status::unicode_error;
     }
 
-    if (!CreateDirectoryW(buf.data(), nullptr)) {
+    // Succeeds if the directory exists, like the Linux version
+    if (!CreateDirectoryW(buf.data(), nullptr) && GetLastError() != ERROR_ALREADY_EXISTS) {
         platform::windows::log_last_error("CreateDirectoryW");
         return Status::generic_error;
     }
@@ -208,3 +209,59 @@ Status fs::path_compact(char const* path_in, Path& path_out, s32 max_len) noexce
         return Status::buffer_length_error;
     }
 }
+
+Status fs::Mapped_File::open(char const* path) noexcept
+{
+    RK_ASSERT(path);
+    close();
+
+    wpath_buf buf;
+    if (!unicode::widen(buf.data(), buf.size(), path)) { return Status::unicode_error; }
+
+    HANDLE const file = CreateFileW(buf.data(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        platform::windows::log_last_error("CreateFileW");
+        return Status::io_error;
+    }
+
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(file, &file_size)) {
+        platform::windows::log_last_error("GetFileSizeEx");
+        CloseHandle(file);
+        return Status::io_error;
+    }
+
+    size_t const size = static_cast<size_t>(file_size.QuadPart);
+    if (size > 0) {
+        HANDLE const mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            platform::windows::log_last_error("CreateFileMappingW");
+            CloseHandle(file);
+            return Status::io_error;
+        }
+
+        void const* const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        // The view keeps the mapping and the file open
+        CloseHandle(mapping);
+        if (!data) {
+            platform::windows::log_last_error("MapViewOfFile");
+            CloseHandle(file);
+            return Status::io_error;
+        }
+        m_data = static_cast<u8 const*>(data);
+    }
+    CloseHandle(file);
+
+    m_size = size;
+    m_open = true;
+    return Status::ok;
+}
+
+void fs::Mapped_File::close() noexcept
+{
+    if (m_data) { UnmapViewOfFile(m_data); }
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
@@ -110,3 +110,57 @@ bool unicode::ascii_cmp(char const* s, char const* ascii) noexcept
 {
     return ascii_cmp(s, ascii, sds::str_size(ascii));
 }
+
+u32 unicode::decode_utf8(std::string_view s, size_t& pos) noexcept
+{
+    RK_ASSERT(pos < s.size());
+
+    u8 const lead = static_cast<u8>(s[pos]);
+    if (lead < 0x80) {
+        ++pos;
+        return lead;
+    }
+
+    // Sequence length and the smallest code point that needs that length
+    s32 len = 0;
+    u32 cp = 0;
+    u32 min_cp = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        len = 2;
+        cp = lead & 0x1F;
+        min_cp = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        len = 3;
+        cp = lead & 0x0F;
+        min_cp = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        len = 4;
+        cp = lead & 0x07;
+        min_cp = 0x10000;
+    } else {
+        // Continuation byte or invalid lead byte
+        ++pos;
+        return replacement_character;
+    }
+
+    if (s.size() - pos < static_cast<size_t>(len)) {
+        ++pos;
+        return replacement_character;
+    }
+    for (s32 i = 1; i < len; ++i) {
+        u8 const cont = static_cast<u8>(s[pos + i]);
+        if ((cont & 0xC0) != 0x80) {
+            ++pos;
+            return replacement_character;
+        }
+        cp = (cp << 6) | (cont & 0x3F);
+    }
+
+    if (cp < min_cp || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        ++pos;
+        return replacement_character;
+    }
+
+    pos += len;
+    return cp;
+}
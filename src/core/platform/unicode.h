@@ -152,4 +152,20 @@ bool ascii_cmp(char const* s, char const* ascii, s32 len) noexcept;
  */
 bool ascii_cmp(char const* s, char const* ascii) noexcept;
 
+/**
+ * \brief Code point substituted for invalid UTF-8 sequences (U+FFFD).
+ */
+constexpr u32 replacement_character = 0xFFFD;
+
+/**
+ * \brief Decode the UTF-8 encoded code point at \a pos in \a s and advance \a pos past it.
+ *
+ * Invalid sequences (overlong encodings, surrogates, values past U+10FFFF, truncated sequences
+ * and stray continuation bytes) decode to #replacement_character and advance \a pos by one byte,
+ * so decoding always makes progress.
+ *
+ * \param pos Byte offset of the code point. Must be less than `s.size()`.
+ */
+u32 decode_utf8(std::string_view s, size_t& pos) noexcept;
+
 } // namespace rk::unicode
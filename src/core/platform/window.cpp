@@ -126,6 +126,13 @@ Status Window::make_current_context() const noexcept
     return platform::glfw::handle_error();
 }
 
+Status Window::release_current_context() const noexcept
+{
+    RK_ASSERT(m_window == glfwGetCurrentContext());
+    glfwMakeContextCurrent(nullptr);
+    return platform::glfw::handle_error();
+}
+
 Status Window::set_framebuffer_size_callback(GLFWframebuffersizefun callback) const noexcept
 {
     glfwSetFramebufferSizeCallback(m_window, callback);
@@ -146,6 +153,12 @@ Status Window::get_window_size(s32& width, s32& height) const noexcept
     return platform::glfw::handle_error();
 }
 
+Status Window::get_framebuffer_size(s32& width, s32& height) const noexcept
+{
+    glfwGetFramebufferSize(m_window, &width, &height);
+    return platform::glfw::handle_error();
+}
+
 Status Window::swap_buffers() const noexcept
 {
     glfwSwapBuffers(m_window);
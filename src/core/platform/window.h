@@ -22,6 +22,11 @@ public:
 
     [[nodiscard]] Status make_current_context() const noexcept;
 
+    /**
+     * \brief Detach the context from the calling thread, so another thread can make it current.
+     */
+    [[nodiscard]] Status release_current_context() const noexcept;
+
     [[nodiscard]] Status set_framebuffer_size_callback(
         GLFWframebuffersizefun callback) const noexcept;
 
@@ -31,6 +36,12 @@ public:
 
     [[nodiscard]] Status get_window_size(s32& width, s32& height) const noexcept;
 
+    /**
+     * \brief Size of the window's framebuffer in pixels. Differs from the window size, which is
+     * in screen coordinates, on high DPI displays.
+     */
+    [[nodiscard]] Status get_framebuffer_size(s32& width, s32& height) const noexcept;
+
     [[nodiscard]] Status swap_buffers() const noexcept;
 
 private:
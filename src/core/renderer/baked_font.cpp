@@ -0,0 +1,96 @@
+#include "core/renderer/baked_font.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/utility/no_exception.h"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace rk;
+using namespace sds;
+
+Status rk::parse_baked_font(u8 const* data, size_t size, Baked_Font& out) noexcept
+{
+    if (!data || size < sizeof(Baked_Font_Header)) {
+        LOG_ERROR("Baked font is truncated: {} bytes", size);
+        return Status::invalid_value;
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(Baked_Font_Header) != 0) {
+        LOG_ERROR("Baked font data isn't aligned");
+        return Status::invalid_value;
+    }
+
+    auto const* header = reinterpret_cast<Baked_Font_Header const*>(data);
+    if (header->magic != Baked_Font_Header::expected_magic) {
+        LOG_ERROR("Not a baked font");
+        return Status::invalid_value;
+    }
+    if (header->version != Baked_Font_Header::current_version) {
+        LOG_ERROR("Baked font version {} isn't supported, expected {}", header->version,
+                  Baked_Font_Header::current_version);
+        return Status::invalid_value;
+    }
+    if (header->pixel_size == 0 || header->atlas_size == 0 ||
+        header->atlas_size > std::numeric_limits<u16>::max()) {
+        LOG_ERROR("Baked font has invalid pixel size {} or atlas size {}", header->pixel_size,
+                  header->atlas_size);
+        return Status::invalid_value;
+    }
+
+    // Sizes are at most 2^32 * 20 and 2^32, no overflow in 64 bits
+    u64 const glyphs_size = static_cast<u64>(header->glyph_count) * sizeof(Baked_Glyph);
+    u64 const atlas_size = static_cast<u64>(header->atlas_size) * header->atlas_size;
+    u64 const expected_size = sizeof(Baked_Font_Header) + glyphs_size + atlas_size;
+    if (size != expected_size) {
+        LOG_ERROR("Baked font is {} bytes, expected {}", size, expected_size);
+        return Status::invalid_value;
+    }
+
+    auto const* glyphs = reinterpret_cast<Baked_Glyph const*>(data + sizeof(Baked_Font_Header));
+    for (u32 i = 0; i < header->glyph_count; ++i) {
+        Baked_Glyph const& g = glyphs[i];
+        if (i > 0 && g.codepoint <= glyphs[i - 1].codepoint) {
+            LOG_ERROR("Baked font glyphs aren't sorted by code point");
+            return Status::invalid_value;
+        }
+        if (g.codepoint > 0x10FFFF) {
+            LOG_ERROR("Baked glyph U+{:04X} is past the last code point", g.codepoint);
+            return Status::invalid_value;
+        }
+        if (static_cast<u32>(g.x) + g.width > header->atlas_size ||
+            static_cast<u32>(g.y) + g.height > header->atlas_size) {
+            LOG_ERROR("Baked glyph U+{:04X} is outside the atlas", g.codepoint);
+            return Status::invalid_value;
+        }
+    }
+
+    out.header = header;
+    out.glyphs = glyphs;
+    out.atlas = data + sizeof(Baked_Font_Header) + glyphs_size;
+    return Status::ok;
+}
+
+Status rk::serialize_baked_font(Baked_Font_Header header, std::vector<Baked_Glyph> const& glyphs,
+                                u8 const* atlas, std::vector<u8>& out) noexcept
+{
+    RK_ASSERT(atlas);
+    header.magic = Baked_Font_Header::expected_magic;
+    header.version = Baked_Font_Header::current_version;
+    header.glyph_count = static_cast<u32>(glyphs.size());
+
+    size_t const glyphs_size = glyphs.size() * sizeof(Baked_Glyph);
+    size_t const atlas_size = static_cast<size_t>(header.atlas_size) * header.atlas_size;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        out.resize(sizeof(header) + glyphs_size + atlas_size);
+        return Status::ok;
+    }));
+
+    u8* dst = out.data();
+    std::memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+    if (glyphs_size > 0) { std::memcpy(dst, glyphs.data(), glyphs_size); }
+    dst += glyphs_size;
+    std::memcpy(dst, atlas, atlas_size);
+    return Status::ok;
+}
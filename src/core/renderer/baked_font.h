@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/status.h"
+#include "core/types.h"
+#include <array>
+#include <vector>
+
+/**
+ * \file baked_font.h
+ * \brief Binary format for fonts rasterized ahead of time by the `rtek_font_baker` tool.
+ *
+ * Layout, little endian:
+ * - `Baked_Font_Header`
+ * - `Baked_Glyph[glyph_count]`, sorted by code point
+ * - Single channel atlas, `atlas_size * atlas_size` bytes, rows top to bottom
+ *
+ * Every section is 4 byte aligned, so a memory mapped file can be read in place.
+ */
+
+namespace rk
+{
+struct Baked_Font_Header {
+    static constexpr std::array<char, 4> expected_magic = {'R', 'K', 'B', 'F'};
+    static constexpr u32 current_version = 1;
+
+    std::array<char, 4> magic = expected_magic;
+    u32 version = current_version;
+    u32 pixel_size = 0;  // size the glyphs were rasterized at
+    u32 render_mode = 0; // Glyph_Cache::Render_Mode
+    u32 sdf_spread = 0;  // only meaningful for SDF glyphs
+    u32 atlas_size = 0;  // width and height of the atlas in texels
+    u32 glyph_count = 0;
+    u32 reserved = 0;
+};
+
+struct Baked_Glyph {
+    u32 codepoint;
+    u16 x, y;          // top left in the atlas
+    u16 width, height; // bitmap size
+    s16 bearing_x;     // offset from the pen position to the left of the bitmap
+    s16 bearing_y;     // offset from the baseline to the top of the bitmap
+    s32 advance;       // offset to the next glyph, in 1/64 pixels
+};
+
+RK_STATIC_ASSERT(sizeof(Baked_Font_Header) == 32);
+RK_STATIC_ASSERT(sizeof(Baked_Glyph) == 20);
+
+/**
+ * \brief View of a baked font in memory. Doesn't own the data.
+ */
+struct Baked_Font {
+    Baked_Font_Header const* header = nullptr;
+    Baked_Glyph const* glyphs = nullptr;
+    u8 const* atlas = nullptr;
+};
+
+/**
+ * \brief Validate the baked font in \a data and point \a out into it.
+ *
+ * \a data must be 4 byte aligned and outlive \a out.
+ *
+ * \return `invalid_value` if the data isn't a baked font of the current version or is corrupt.
+ */
+[[nodiscard]] Status parse_baked_font(u8 const* data, size_t size, Baked_Font& out) noexcept;
+
+/**
+ * \brief Write a baked font to \a out.
+ *
+ * The magic, version and glyph count of \a header are filled in. \a glyphs must be sorted by code
+ * point and \a atlas be `header.atlas_size` squared bytes.
+ */
+[[nodiscard]] Status serialize_baked_font(Baked_Font_Header header,
+                                          std::vector<Baked_Glyph> const& glyphs, u8 const* atlas,
+                                          std::vector<u8>& out) noexcept;
+} // namespace rk
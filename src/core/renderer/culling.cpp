@@ -0,0 +1,215 @@
+#include "core/renderer/culling.h"
+
+#include "core/assert.h"
+#include "core/math/simd.h"
+#include "core/utility/parallel_for.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace rk;
+using namespace sds;
+
+Frustum Frustum::from_view_projection(Mat4 const& view_proj) noexcept
+{
+    Mat4 const& m = view_proj;
+
+    // Clip space is -w <= x, y, z <= w. Each plane is row 3 +/- row N.
+    constexpr std::array<s32, num_planes> row = {0, 0, 1, 1, 2, 2};
+    constexpr std::array<f32, num_planes> sign = {1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f};
+
+    Frustum f;
+    for (s32 p = 0; p < num_planes; ++p) {
+        f.a[p] = m(3, 0) + sign[p] * m(row[p], 0);
+        f.b[p] = m(3, 1) + sign[p] * m(row[p], 1);
+        f.c[p] = m(3, 2) + sign[p] * m(row[p], 2);
+        f.d[p] = m(3, 3) + sign[p] * m(row[p], 3);
+
+        f32 const len = std::sqrt(f.a[p] * f.a[p] + f.b[p] * f.b[p] + f.c[p] * f.c[p]);
+        RK_ASSERT(len > 0.0f);
+        f32 const inv_len = 1.0f / len;
+        f.a[p] *= inv_len;
+        f.b[p] *= inv_len;
+        f.c[p] *= inv_len;
+        f.d[p] *= inv_len;
+    }
+    return f;
+}
+
+/**
+ * \brief Append \a index to \a out if the low bit of \a visible is set. Branchless; always writes.
+ */
+#define RK_APPEND_IF_VISIBLE(out, n, index, visible) \
+    do {                                             \
+        (out)[(n)] = (index);                        \
+        (n) += (visible)&1;                          \
+    } while (0)
+
+/**
+ * \brief Cull the boxes in [begin, end) and write the visible indices to \a out.
+ *
+ * A box is outside a plane when its center is further behind the plane than the box's projected
+ * radius along the plane normal.
+ */
+RK_INTERNAL
+s32 cull_aabb_range(Frustum const& f, Aabb_Soa const& boxes, s32 begin, s32 end,
+                    u32* RK_RESTRICT out) noexcept
+{
+    s32 n = 0;
+    s32 i = begin;
+
+#if RK_SIMD_SSE
+    __m128 const zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        __m128 const cx = _mm_loadu_ps(boxes.center_x + i);
+        __m128 const cy = _mm_loadu_ps(boxes.center_y + i);
+        __m128 const cz = _mm_loadu_ps(boxes.center_z + i);
+        __m128 const ex = _mm_loadu_ps(boxes.extent_x + i);
+        __m128 const ey = _mm_loadu_ps(boxes.extent_y + i);
+        __m128 const ez = _mm_loadu_ps(boxes.extent_z + i);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (s32 p = 0; p < Frustum::num_planes; ++p) {
+            __m128 const a = _mm_set1_ps(f.a[p]);
+            __m128 const b = _mm_set1_ps(f.b[p]);
+            __m128 const c = _mm_set1_ps(f.c[p]);
+
+            __m128 dist = _mm_add_ps(_mm_mul_ps(a, cx), _mm_set1_ps(f.d[p]));
+            dist = _mm_add_ps(dist, _mm_mul_ps(b, cy));
+            dist = _mm_add_ps(dist, _mm_mul_ps(c, cz));
+
+            __m128 radius = _mm_mul_ps(_mm_set1_ps(std::abs(f.a[p])), ex);
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_set1_ps(std::abs(f.b[p])), ey));
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_set1_ps(std::abs(f.c[p])), ez));
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, radius), zero));
+        }
+
+        s32 const mask = _mm_movemask_ps(inside);
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i + 0), mask);
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i + 1), mask >> 1);
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i + 2), mask >> 2);
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i + 3), mask >> 3);
+    }
+#endif
+
+    for (; i < end; ++i) {
+        bool inside = true;
+        for (s32 p = 0; p < Frustum::num_planes; ++p) {
+            f32 const dist = f.a[p] * boxes.center_x[i] + f.b[p] * boxes.center_y[i] +
+                             f.c[p] * boxes.center_z[i] + f.d[p];
+            f32 const radius = std::abs(f.a[p]) * boxes.extent_x[i] +
+                               std::abs(f.b[p]) * boxes.extent_y[i] +
+                               std::abs(f.c[p]) * boxes.extent_z[i];
+            inside = inside && (dist + radius >= 0.0f);
+        }
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i), static_cast<s32>(inside));
+    }
+
+    return n;
+}
+
+/**
+ * \brief Cull the spheres in [begin, end) and write the visible indices to \a out.
+ */
+RK_INTERNAL
+s32 cull_sphere_range(Frustum const& f, Sphere_Soa const& spheres, s32 begin, s32 end,
+                      u32* RK_RESTRICT out) noexcept
+{
+    s32 n = 0;
+    s32 i = begin;
+
+#if RK_SIMD_SSE
+    __m128 const zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        __m128 const cx = _mm_loadu_ps(spheres.center_x + i);
+        __m128 const cy = _mm_loadu_ps(spheres.center_y + i);
+        __m128 const cz = _mm_loadu_ps(spheres.center_z + i);
+        __m128 const r = _mm_loadu_ps(spheres.radius + i);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (s32 p = 0; p < Frustum::num_planes; ++p) {
+            __m128 dist = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(f.a[p]), cx), _mm_set1_ps(f.d[p]));
+            dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(f.b[p]), cy));
+            dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(f.c[p]), cz));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, r), zero));
+        }
+
+        s32 const mask = _mm_movemask_ps(inside);
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i + 0), mask);
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i + 1), mask >> 1);
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i + 2), mask >> 2);
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i + 3), mask >> 3);
+    }
+#endif
+
+    for (; i < end; ++i) {
+        bool inside = true;
+        for (s32 p = 0; p < Frustum::num_planes; ++p) {
+            f32 const dist = f.a[p] * spheres.center_x[i] + f.b[p] * spheres.center_y[i] +
+                             f.c[p] * spheres.center_z[i] + f.d[p];
+            inside = inside && (dist + spheres.radius[i] >= 0.0f);
+        }
+        RK_APPEND_IF_VISIBLE(out, n, static_cast<u32>(i), static_cast<s32>(inside));
+    }
+
+    return n;
+}
+
+#undef RK_APPEND_IF_VISIBLE
+
+/** Upper bound on the number of parallel chunks a cull is split into. */
+constexpr s32 max_cull_chunks = 64;
+
+/**
+ * \brief Run \a cull_range over [0, count), in parallel chunks for large counts, and compact the
+ * results into \a out_visible.
+ *
+ * Each chunk writes its results at its own offset in \a out_visible (a chunk can't produce more
+ * indices than it has volumes), then the chunks are shifted down in order.
+ */
+template <typename F>
+RK_INTERNAL s32 cull_chunked(s32 count, u32* out_visible, Cull_Config const& config,
+                             F&& cull_range) noexcept
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT(out_visible || count == 0);
+
+    if (count < config.parallel_threshold) { return cull_range(0, count, out_visible); }
+
+    s32 const max_threads = (config.max_threads > 0 ? config.max_threads : worker_thread_count());
+    s32 const max_chunks = std::clamp(count / std::max(1, config.min_chunk_size), 1,
+                                      std::min(max_threads, max_cull_chunks));
+
+    std::array<s32, max_cull_chunks> chunk_begin{};
+    std::array<s32, max_cull_chunks> chunk_visible{};
+    s32 const num_chunks = parallel_for_chunks(count, max_chunks, [&](s32 chunk, s32 begin,
+                                                                      s32 end) {
+        chunk_begin[chunk] = begin;
+        chunk_visible[chunk] = cull_range(begin, end, out_visible + begin);
+    });
+
+    s32 total = chunk_visible[0];
+    for (s32 chunk = 1; chunk < num_chunks; ++chunk) {
+        std::memmove(out_visible + total, out_visible + chunk_begin[chunk],
+                     chunk_visible[chunk] * sizeof(u32));
+        total += chunk_visible[chunk];
+    }
+    return total;
+}
+
+s32 rk::cull_aabbs(Frustum const& frustum, Aabb_Soa const& boxes, u32* out_visible,
+                   Cull_Config const& config) noexcept
+{
+    return cull_chunked(boxes.count, out_visible, config, [&](s32 begin, s32 end, u32* out) {
+        return cull_aabb_range(frustum, boxes, begin, end, out);
+    });
+}
+
+s32 rk::cull_spheres(Frustum const& frustum, Sphere_Soa const& spheres, u32* out_visible,
+                     Cull_Config const& config) noexcept
+{
+    return cull_chunked(spheres.count, out_visible, config, [&](s32 begin, s32 end, u32* out) {
+        return cull_sphere_range(frustum, spheres, begin, end, out);
+    });
+}
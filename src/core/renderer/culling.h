@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/math/matrix.h"
+#include "core/types.h"
+#include <array>
+
+/**
+ * \file culling.h
+ * \brief CPU visibility culling of bounding volumes against a view frustum.
+ *
+ * Bounding volumes are passed as structure of arrays so four (SSE) volumes can be tested against a
+ * plane per instruction. The output is a compacted list of the indices of the visible volumes, in
+ * ascending order.
+ */
+
+namespace rk
+{
+/**
+ * \brief Frustum as six planes `ax + by + cz + d = 0` with normals pointing inwards.
+ *
+ * Planes are stored as structure of arrays so a single plane can be broadcast against a batch of
+ * volumes.
+ */
+struct Frustum {
+    static constexpr s32 num_planes = 6;
+
+    enum Plane : s32 { left = 0, right, bottom, top, z_near, z_far };
+
+    std::array<f32, num_planes> a{};
+    std::array<f32, num_planes> b{};
+    std::array<f32, num_planes> c{};
+    std::array<f32, num_planes> d{};
+
+    /**
+     * \brief Extract the normalized frustum planes from a (column-major, OpenGL clip space)
+     * view-projection matrix.
+     *
+     * ref: Gribb, Hartmann. Fast Extraction of Viewing Frustum Planes from the World-View-Projection
+     * Matrix.
+     */
+    [[nodiscard]] static Frustum from_view_projection(Mat4 const& view_proj) noexcept;
+};
+
+/**
+ * \brief Axis aligned bounding boxes as center and half extents, structure of arrays.
+ */
+struct Aabb_Soa {
+    f32 const* center_x = nullptr;
+    f32 const* center_y = nullptr;
+    f32 const* center_z = nullptr;
+    f32 const* extent_x = nullptr;
+    f32 const* extent_y = nullptr;
+    f32 const* extent_z = nullptr;
+    s32 count = 0;
+};
+
+/**
+ * \brief Bounding spheres, structure of arrays.
+ */
+struct Sphere_Soa {
+    f32 const* center_x = nullptr;
+    f32 const* center_y = nullptr;
+    f32 const* center_z = nullptr;
+    f32 const* radius = nullptr;
+    s32 count = 0;
+};
+
+struct Cull_Config {
+    /** Volume count at which culling is split into parallel chunks. */
+    s32 parallel_threshold = 16 * 1024;
+    /** Minimum number of volumes in each parallel chunk. */
+    s32 min_chunk_size = 8 * 1024;
+    /** Maximum number of threads to use. 0 uses the hardware thread count. */
+    s32 max_threads = 0;
+};
+
+/**
+ * \brief Cull boxes against the frustum.
+ *
+ * \param out_visible Receives the indices of the visible boxes. Must have space for `boxes.count`
+ * indices.
+ * \return Number of visible boxes written to \a out_visible.
+ */
+[[nodiscard]] s32 cull_aabbs(Frustum const& frustum, Aabb_Soa const& boxes, u32* out_visible,
+                             Cull_Config const& config = {}) noexcept;
+
+/**
+ * \brief Cull spheres against the frustum.
+ *
+ * \param out_visible Receives the indices of the visible spheres. Must have space for
+ * `spheres.count` indices.
+ * \return Number of visible spheres written to \a out_visible.
+ */
+[[nodiscard]] s32 cull_spheres(Frustum const& frustum, Sphere_Soa const& spheres,
+                               u32* out_visible, Cull_Config const& config = {}) noexcept;
+} // namespace rk
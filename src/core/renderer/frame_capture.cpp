@@ -0,0 +1,153 @@
+#include "core/renderer/frame_capture.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/platform/stdlib/cstdio.h"
+#include "core/utility/no_exception.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <limits>
+
+using namespace rk;
+using namespace sds;
+
+RK_INTERNAL
+constexpr std::array<u32, 256> make_crc_table() noexcept
+{
+    std::array<u32, 256> table = {};
+    for (u32 n = 0; n < 256; ++n) {
+        u32 c = n;
+        for (s32 k = 0; k < 8; ++k) { c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1; }
+        table[n] = c;
+    }
+    return table;
+}
+
+constexpr std::array<u32, 256> crc_table = make_crc_table();
+
+RK_INTERNAL
+void append_u32_be(std::vector<u8>& out, u32 value)
+{
+    out.push_back(static_cast<u8>(value >> 24));
+    out.push_back(static_cast<u8>(value >> 16));
+    out.push_back(static_cast<u8>(value >> 8));
+    out.push_back(static_cast<u8>(value));
+}
+
+/**
+ * \brief Append a chunk of \a type with the data appended by \a append_data.
+ */
+template <typename F>
+void append_chunk(std::vector<u8>& out, char const (&type)[5], F&& append_data)
+{
+    size_t const length_offset = out.size();
+    append_u32_be(out, 0); // patched below
+    size_t const type_offset = out.size();
+    out.insert(out.end(), type, type + 4);
+    append_data();
+
+    u32 const length = static_cast<u32>(out.size() - type_offset - 4);
+    for (s32 i = 0; i < 4; ++i) {
+        out[length_offset + i] = static_cast<u8>(length >> (24 - i * 8));
+    }
+    u32 crc = 0xFFFFFFFFu;
+    for (size_t i = type_offset; i < out.size(); ++i) {
+        crc = crc_table[(crc ^ out[i]) & 0xFF] ^ (crc >> 8);
+    }
+    append_u32_be(out, crc ^ 0xFFFFFFFFu);
+}
+
+Status rk::encode_png(u8 const* rgba, s32 width, s32 height, std::vector<u8>& out) noexcept
+{
+    RK_ASSERT(rgba);
+    size_t const row_size = static_cast<size_t>(width) * 4;
+    // Rows are prefixed by their filter type
+    size_t const data_size = (row_size + 1) * height;
+    if (width <= 0 || height <= 0 || data_size > std::numeric_limits<u32>::max() / 2) {
+        LOG_ERROR("Can't encode a {}x{} PNG", width, height);
+        return Status::invalid_value;
+    }
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        out.clear();
+        constexpr std::array<u8, 8> signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        out.insert(out.end(), signature.begin(), signature.end());
+
+        append_chunk(out, "IHDR", [&]() {
+            append_u32_be(out, static_cast<u32>(width));
+            append_u32_be(out, static_cast<u32>(height));
+            out.push_back(8); // bit depth
+            out.push_back(6); // RGBA
+            out.push_back(0); // deflate
+            out.push_back(0); // adaptive filtering
+            out.push_back(0); // not interlaced
+        });
+
+        append_chunk(out, "IDAT", [&]() {
+            // zlib stream of stored deflate blocks
+            out.push_back(0x78);
+            out.push_back(0x01);
+            constexpr size_t max_block_size = 65535;
+            u32 adler_a = 1;
+            u32 adler_b = 0;
+            size_t block_remaining = 0;
+            size_t data_remaining = data_size;
+            auto put = [&](u8 byte) {
+                if (block_remaining == 0) {
+                    u16 const block_size =
+                        static_cast<u16>(std::min(data_remaining, max_block_size));
+                    out.push_back(data_remaining == block_size ? 1 : 0); // final block
+                    out.push_back(static_cast<u8>(block_size));
+                    out.push_back(static_cast<u8>(block_size >> 8));
+                    out.push_back(static_cast<u8>(~block_size));
+                    out.push_back(static_cast<u8>(~block_size >> 8));
+                    block_remaining = block_size;
+                }
+                out.push_back(byte);
+                --block_remaining;
+                --data_remaining;
+                adler_a = (adler_a + byte) % 65521;
+                adler_b = (adler_b + adler_a) % 65521;
+            };
+            for (s32 y = 0; y < height; ++y) {
+                put(0); // no filter
+                u8 const* row = rgba + y * row_size;
+                for (size_t i = 0; i < row_size; ++i) { put(row[i]); }
+            }
+            append_u32_be(out, (adler_b << 16) | adler_a);
+        });
+
+        append_chunk(out, "IEND", []() {});
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+Status rk::write_image(char const* path, Image_Format format, u8 const* rgba, s32 width,
+                       s32 height) noexcept
+{
+    RK_ASSERT(path);
+    RK_ASSERT(rgba);
+
+    std::vector<u8> png;
+    u8 const* data = rgba;
+    size_t size = static_cast<size_t>(width) * height * 4;
+    if (format == Image_Format::png) {
+        RK_CHECK(encode_png(rgba, width, height, png));
+        data = png.data();
+        size = png.size();
+    }
+
+    FILE* file = rk::fopen(path, "wb");
+    if (!file) {
+        LOG_ERROR("Failed to open '{}' for writing", path);
+        return Status::io_error;
+    }
+    size_t const written = std::fwrite(data, 1, size, file);
+    if (std::fclose(file) != 0 || written != size) {
+        LOG_ERROR("Failed to write '{}'", path);
+        return Status::io_error;
+    }
+    return Status::ok;
+}
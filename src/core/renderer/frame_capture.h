@@ -0,0 +1,38 @@
+#pragma once
+
+#include "core/status.h"
+#include "core/types.h"
+#include <vector>
+
+/**
+ * \file frame_capture.h
+ * \brief Writing captured frames to files, for golden image tests and inspecting headless runs.
+ *
+ * Frames are tightly packed 8 bit RGBA, rows from top to bottom, as returned by
+ * `Renderer::read_frame`.
+ */
+
+namespace rk
+{
+enum class Image_Format : u8 {
+    /** Pixels exactly as captured, with no header. */
+    raw,
+    /** Uncompressed PNG, readable by any image viewer. */
+    png,
+};
+
+/**
+ * \brief Encode \a rgba as a PNG into \a out.
+ *
+ * The image data is stored without compression. Captures are written rarely, and this avoids
+ * depending on a deflate implementation.
+ */
+[[nodiscard]] Status encode_png(u8 const* rgba, s32 width, s32 height,
+                                std::vector<u8>& out) noexcept;
+
+/**
+ * \brief Write \a rgba to the file at \a path in \a format.
+ */
+[[nodiscard]] Status write_image(char const* path, Image_Format format, u8 const* rgba, s32 width,
+                                 s32 height) noexcept;
+} // namespace rk
@@ -0,0 +1,107 @@
+#include "core/renderer/frame_pacer.h"
+
+#include "core/logging/logging.h"
+#include <glad/glad.h>
+#include <cmath>
+#include <thread>
+
+using namespace rk;
+using namespace sds;
+
+Status Frame_Pacer::initialize(Config config) noexcept
+{
+    if (!(config.max_frame_rate >= 0.0f)) {
+        LOG_ERROR("Max frame rate must not be negative, got {}", config.max_frame_rate);
+        return Status::invalid_value;
+    }
+    if (config.log_interval < 0) {
+        LOG_ERROR("Frame pacing log interval must not be negative, got {}", config.log_interval);
+        return Status::invalid_value;
+    }
+    m_config = config;
+    m_frame_period = Clock::duration::zero();
+    if (config.max_frame_rate > 0.0f) {
+        m_frame_period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<f64>(1.0 / config.max_frame_rate));
+    }
+    m_target = Clock::now();
+    return Status::ok;
+}
+
+Status Frame_Pacer::destroy() noexcept
+{
+    if (m_previous_fence) {
+        glDeleteSync(static_cast<GLsync>(m_previous_fence));
+        m_previous_fence = nullptr;
+    }
+    m_last_present = {};
+    m_present_interval = {};
+    m_jitter = {};
+    m_stall_count = 0;
+    m_present_count = 0;
+    return Status::ok;
+}
+
+void Frame_Pacer::wait_for_present() noexcept
+{
+    if (m_frame_period == Clock::duration::zero()) { return; }
+
+    Clock::time_point now = Clock::now();
+    if (m_target - now > spin_margin) { std::this_thread::sleep_for(m_target - now - spin_margin); }
+    while ((now = Clock::now()) < m_target) { std::this_thread::yield(); }
+
+    // A frame that ran long starts the schedule again, rather than rushing the next frames to
+    // catch up
+    m_target += m_frame_period;
+    if (m_target < now) { m_target = now + m_frame_period; }
+}
+
+Status Frame_Pacer::end_present() noexcept
+{
+    Clock::time_point const now = Clock::now();
+    if (m_last_present != Clock::time_point{}) {
+        f32 const interval = std::chrono::duration<f32, std::milli>(now - m_last_present).count();
+        if (m_present_interval.sample_count() > 0) {
+            m_jitter.add(std::abs(interval - m_present_interval.last()));
+        }
+        m_present_interval.add(interval);
+    }
+    m_last_present = now;
+
+    ++m_present_count;
+    if (m_config.log_interval > 0 && m_present_count % m_config.log_interval == 0) {
+        log_timings();
+    }
+
+    if (!m_config.low_latency) { return Status::ok; }
+
+    GLsync const fence = static_cast<GLsync>(m_previous_fence);
+    m_previous_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (!fence) { return Status::ok; }
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        ++m_stall_count;
+        constexpr GLuint64 timeout_ns = 1'000'000'000;
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+        while (result == GL_TIMEOUT_EXPIRED) {
+            LOG_WARN("Waited over a second for the GPU to finish a frame");
+            result = glClientWaitSync(fence, 0, timeout_ns);
+        }
+    }
+    glDeleteSync(fence);
+
+    if (result == GL_WAIT_FAILED) {
+        LOG_ERROR("Failed to wait on the frame pacing fence");
+        return Status::renderer_error;
+    }
+    return Status::ok;
+}
+
+void Frame_Pacer::log_timings() const noexcept
+{
+    LOG_INFO("Present interval: {:.3f} ms avg, {:.3f} ms max, jitter {:.3f} ms avg, {:.3f} ms max, "
+             "{} stalls",
+             m_present_interval.average(), m_present_interval.max(), m_jitter.average(),
+             m_jitter.max(), m_stall_count);
+}
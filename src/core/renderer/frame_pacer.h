@@ -0,0 +1,88 @@
+#pragma once
+
+#include "core/renderer/rolling_timing.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <chrono>
+
+namespace rk
+{
+/**
+ * \brief Paces buffer swaps and measures the time between them.
+ *
+ * Call `wait_for_present` right before swapping buffers and `end_present` right after.
+ *
+ * - With a frame rate limit, `wait_for_present` holds the swap until the frame's target time. It
+ *   sleeps until shortly before the target and spins the rest of the way, since sleeps can
+ *   overshoot by a scheduler tick.
+ * - In low latency mode, `end_present` fences each frame and waits for the previous frame's fence,
+ *   so the CPU is never more than one frame ahead of the GPU. Input sampled for a frame is then at
+ *   most a frame old when it's displayed, at the cost of less CPU and GPU overlap.
+ *
+ * Present to present time is measured from the return of one swap to the next. Jitter is how far
+ * an interval is from the previous one.
+ */
+class Frame_Pacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        /** Presents per second. 0 doesn't limit. */
+        f32 max_frame_rate = 0.0f;
+        /** Keep the CPU at most one frame ahead of the GPU. Needs a current OpenGL context. */
+        bool low_latency = false;
+        /** Log the present intervals and jitter every this many presents. 0 never logs. */
+        s32 log_interval = 0;
+    };
+
+    Frame_Pacer() = default;
+
+    [[nodiscard]] Status initialize(Config config) noexcept;
+    Status destroy() noexcept;
+
+    /**
+     * \brief Wait until the next frame may be presented, if the frame rate is limited.
+     */
+    void wait_for_present() noexcept;
+
+    /**
+     * \brief Measure the present that just happened, and in low latency mode wait for the GPU to
+     * finish the previous frame.
+     */
+    [[nodiscard]] Status end_present() noexcept;
+
+    /** Time `wait_for_present` spaces presents by. Zero if the frame rate isn't limited. */
+    [[nodiscard]] Clock::duration frame_period() const noexcept { return m_frame_period; }
+
+    /** Milliseconds between the last presents. */
+    [[nodiscard]] Rolling_Timing const& present_interval() const noexcept
+    {
+        return m_present_interval;
+    }
+
+    /** Milliseconds between the last two present intervals. */
+    [[nodiscard]] Rolling_Timing const& jitter() const noexcept { return m_jitter; }
+
+    /** Number of times low latency mode had to wait for the GPU. */
+    [[nodiscard]] u64 stall_count() const noexcept { return m_stall_count; }
+
+    /**
+     * \brief Log the present intervals and jitter.
+     */
+    void log_timings() const noexcept;
+
+private:
+    /** Left for spinning when sleeping until a target time. More than a scheduler tick. */
+    static constexpr std::chrono::microseconds spin_margin{2000};
+
+    Config m_config = {};
+    Clock::duration m_frame_period = Clock::duration::zero(); // zero if not limited
+    Clock::time_point m_target;       // when the next frame may be presented
+    Clock::time_point m_last_present; // epoch until the first present
+    Rolling_Timing m_present_interval;
+    Rolling_Timing m_jitter;
+    void* m_previous_fence = nullptr; // GLsync of the previous frame, in low latency mode
+    u64 m_stall_count = 0;
+    u64 m_present_count = 0;
+};
+} // namespace rk
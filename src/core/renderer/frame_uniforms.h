@@ -0,0 +1,33 @@
+#pragma once
+
+#include "core/math/matrix.h"
+#include "core/types.h"
+#include <array>
+
+namespace rk
+{
+/** Uniform buffer binding point of `Frame_Uniforms`, the same in every program. */
+constexpr u32 frame_uniforms_binding = 0;
+
+/**
+ * \brief Uniforms shared by every program, uploaded once per frame in one uniform buffer.
+ *
+ * std140 layout. Shaders declare the same block:
+ * \code{.glsl}
+ * layout (std140, binding = 0) uniform Frame {
+ *     mat4 screen_projection;
+ *     mat4 view_projection;
+ *     vec4 viewport;
+ * };
+ * \endcode
+ */
+struct Frame_Uniforms {
+    /** Screen pixels to clip space, with the origin at the bottom left. */
+    Mat4 screen_projection;
+    /** World to clip space, of the camera. */
+    Mat4 view_projection = Mat4::identity();
+    /** Viewport width and height in pixels, then their inverses. */
+    std::array<f32, 4> viewport = {};
+};
+RK_STATIC_ASSERT(sizeof(Frame_Uniforms) == 144);
+} // namespace rk
@@ -0,0 +1,105 @@
+#include "core/renderer/gl_state_cache.h"
+
+#include "core/assert.h"
+#include <glad/glad.h>
+
+using namespace rk;
+using namespace sds;
+
+bool Gl_State_Cache::change(u32& state, u32 value) noexcept
+{
+    if (state == value) {
+        ++m_stats.gl_calls_skipped;
+        return false;
+    }
+    state = value;
+    ++m_stats.gl_calls;
+    return true;
+}
+
+void Gl_State_Cache::use_program(u32 program) noexcept
+{
+    if (change(m_program, program)) { glUseProgram(program); }
+}
+
+void Gl_State_Cache::bind_vertex_array(u32 vao) noexcept
+{
+    if (change(m_vao, vao)) { glBindVertexArray(vao); }
+}
+
+void Gl_State_Cache::bind_texture(u32 unit, u32 texture) noexcept
+{
+    if (unit >= static_cast<u32>(max_texture_units)) {
+        glBindTextureUnit(unit, texture);
+        ++m_stats.gl_calls;
+        ++m_stats.texture_binds;
+        return;
+    }
+    if (change(m_textures[unit], texture)) {
+        glBindTextureUnit(unit, texture);
+        ++m_stats.texture_binds;
+    }
+}
+
+void Gl_State_Cache::set_blend(bool enable) noexcept
+{
+    if (!change(m_blend, enable ? GL_TRUE : GL_FALSE)) { return; }
+    if (enable) {
+        glEnable(GL_BLEND);
+    } else {
+        glDisable(GL_BLEND);
+    }
+}
+
+void Gl_State_Cache::set_blend_func(u32 src_factor, u32 dst_factor) noexcept
+{
+    if (m_blend_src == src_factor && m_blend_dst == dst_factor) {
+        ++m_stats.gl_calls_skipped;
+        return;
+    }
+    m_blend_src = src_factor;
+    m_blend_dst = dst_factor;
+    glBlendFunc(src_factor, dst_factor);
+    ++m_stats.gl_calls;
+}
+
+void Gl_State_Cache::set_cull_face(bool enable) noexcept
+{
+    if (!change(m_cull_face, enable ? GL_TRUE : GL_FALSE)) { return; }
+    if (enable) {
+        glEnable(GL_CULL_FACE);
+    } else {
+        glDisable(GL_CULL_FACE);
+    }
+}
+
+void Gl_State_Cache::set_polygon_mode(u32 mode) noexcept
+{
+    RK_ASSERT(mode == GL_FILL || mode == GL_LINE || mode == GL_POINT);
+    if (change(m_polygon_mode, mode)) { glPolygonMode(GL_FRONT_AND_BACK, mode); }
+}
+
+void Gl_State_Cache::forget_vertex_array(u32 vao) noexcept
+{
+    // The binding reverted to 0
+    if (m_vao == vao) { m_vao = 0; }
+}
+
+void Gl_State_Cache::forget_texture(u32 texture) noexcept
+{
+    for (u32& bound : m_textures) {
+        if (bound == texture) { bound = 0; }
+    }
+}
+
+void Gl_State_Cache::invalidate() noexcept
+{
+    m_program = unknown;
+    m_vao = unknown;
+    m_textures.fill(unknown);
+    m_blend = unknown;
+    m_blend_src = unknown;
+    m_blend_dst = unknown;
+    m_cull_face = unknown;
+    m_polygon_mode = unknown;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/renderer/render_stats.h"
+#include "core/types.h"
+#include <array>
+
+namespace rk
+{
+/**
+ * \brief Shadow of the OpenGL state the renderer changes between draws. Redundant changes are
+ * filtered out.
+ *
+ * Draws set the state they need through the cache instead of setting it and resetting it
+ * afterwards. A change to the state that's already set costs a comparison, not a GL call. Calls
+ * that are issued count in `Render_Stats::gl_calls`, and filtered ones count in
+ * `Render_Stats::gl_calls_skipped`.
+ *
+ * The cache only knows about changes made through it. Code that changes the tracked state directly
+ * must call `invalidate` afterwards. Resource setup should use direct state access (`glCreate*`,
+ * `glNamed*`, `glTexture*`, `glVertexArray*`), which doesn't touch the bindings, so resources can
+ * be created or updated at any point in a frame and the cached state stays true. Until the first
+ * change of each kind of state, the state is unknown and the call is always issued.
+ *
+ * Requires a current OpenGL 4.5 context.
+ */
+class Gl_State_Cache {
+public:
+    /** Texture units tracked. Binds to higher units are always issued. */
+    static constexpr s32 max_texture_units = 16;
+
+    /**
+     * \param stats Where issued and skipped calls are counted. Must outlive the cache.
+     */
+    explicit Gl_State_Cache(Render_Stats& stats) noexcept : m_stats(stats) { invalidate(); }
+
+    void use_program(u32 program) noexcept;
+    void bind_vertex_array(u32 vao) noexcept;
+
+    /**
+     * \brief Bind \a texture to \a unit, with `glBindTextureUnit`. The active texture unit is left
+     * unchanged.
+     */
+    void bind_texture(u32 unit, u32 texture) noexcept;
+
+    void set_blend(bool enable) noexcept;
+    void set_blend_func(u32 src_factor, u32 dst_factor) noexcept;
+    void set_cull_face(bool enable) noexcept;
+
+    /**
+     * \brief Set the polygon mode of front and back faces, `GL_FILL` or `GL_LINE`.
+     */
+    void set_polygon_mode(u32 mode) noexcept;
+
+    /**
+     * \brief Forget \a vao, which was deleted. Deleting a bound vertex array unbinds it and frees
+     * its name for reuse.
+     */
+    void forget_vertex_array(u32 vao) noexcept;
+
+    /**
+     * \brief Forget \a texture, which was deleted. Deleting a texture unbinds it from every unit.
+     */
+    void forget_texture(u32 texture) noexcept;
+
+    /**
+     * \brief Forget all tracked state. The next change of each kind is always issued.
+     */
+    void invalidate() noexcept;
+
+private:
+    /** Value of tracked state that's unknown, never a valid GL name or enum. */
+    static constexpr u32 unknown = 0xFFFF'FFFF;
+
+    /**
+     * \brief Record \a value as the current value of \a state. False if it already was, and the
+     * call should be skipped.
+     */
+    [[nodiscard]] bool change(u32& state, u32 value) noexcept;
+
+    Render_Stats& m_stats;
+
+    u32 m_program;
+    u32 m_vao;
+    std::array<u32, max_texture_units> m_textures;
+    u32 m_blend; // GL_TRUE or GL_FALSE
+    u32 m_blend_src;
+    u32 m_blend_dst;
+    u32 m_cull_face; // GL_TRUE or GL_FALSE
+    u32 m_polygon_mode;
+};
+} // namespace rk
@@ -0,0 +1,122 @@
+#include "core/renderer/glyph_atlas.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/utility/no_exception.h"
+#include <glad/glad.h>
+
+using namespace rk;
+using namespace sds;
+
+Status Glyph_Atlas::initialize(Config config) noexcept
+{
+    if (config.page_size <= 0 || config.padding < 0 || config.max_pages <= 0) {
+        LOG_ERROR("Invalid glyph atlas config: page size {}, padding {}, max pages {}",
+                  config.page_size, config.padding, config.max_pages);
+        return Status::invalid_value;
+    }
+    m_config = config;
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_pages.reserve(config.max_pages);
+        return Status::ok;
+    }));
+
+    // Always have a page, so empty glyphs have a texture to refer to
+    return add_page();
+}
+
+Status Glyph_Atlas::destroy() noexcept
+{
+    if (m_config.textures) {
+        for (Page& page : m_pages) { glDeleteTextures(1, &page.texture_id); }
+    }
+    m_pages.clear();
+    return Status::ok;
+}
+
+u32 Glyph_Atlas::page_texture(s32 page) const noexcept
+{
+    RK_ASSERT(page >= 0 && page < page_count());
+    return m_pages[page].texture_id;
+}
+
+Status Glyph_Atlas::add_page() noexcept
+{
+    RK_ASSERT(m_pages.size() < m_pages.capacity());
+    Page& page = m_pages.emplace_back();
+    RK_CHECK(page.packer.initialize(m_config.page_size, m_config.page_size));
+    if (!m_config.textures) { return Status::ok; }
+
+    // Direct state access, so glyphs can be added mid frame without disturbing texture bindings
+    glCreateTextures(GL_TEXTURE_2D, 1, &page.texture_id);
+    glTextureStorage2D(page.texture_id, 1, GL_R8, m_config.page_size, m_config.page_size);
+    glTextureParameteri(page.texture_id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(page.texture_id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(page.texture_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(page.texture_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    clear_page(page_count() - 1);
+    return Status::ok;
+}
+
+void Glyph_Atlas::clear_page(s32 page) noexcept
+{
+    RK_ASSERT(page >= 0 && page < page_count());
+    m_pages[page].packer.clear();
+    if (!m_config.textures) { return; }
+
+    // The padding between glyphs must be empty
+    u8 const zero = 0;
+    glClearTexImage(m_pages[page].texture_id, 0, GL_RED, GL_UNSIGNED_BYTE, &zero);
+}
+
+Status Glyph_Atlas::add(s32 width, s32 height, u8 const* bitmap, s32 pitch, Region& out) noexcept
+{
+    RK_ASSERT(!m_pages.empty());
+    RK_ASSERT(width >= 0 && height >= 0);
+
+    if (width == 0 || height == 0) {
+        out = {m_pages[0].texture_id, 0, {0.0f, 0.0f}, {0.0f, 0.0f}};
+        return Status::ok;
+    }
+
+    s32 const padded_width = width + 2 * m_config.padding;
+    s32 const padded_height = height + 2 * m_config.padding;
+    if (padded_width > m_config.page_size || padded_height > m_config.page_size) {
+        LOG_ERROR("Glyph of {}x{} doesn't fit in a {} texel atlas page", width, height,
+                  m_config.page_size);
+        return Status::invalid_value;
+    }
+
+    Rect rect;
+    s32 page_index = 0;
+    while (!m_pages[page_index].packer.pack(padded_width, padded_height, rect)) {
+        ++page_index;
+        if (page_index == page_count()) {
+            if (page_count() == m_config.max_pages) { return Status::buffer_length_error; }
+            RK_CHECK(add_page());
+        }
+    }
+    Page const& page = m_pages[page_index];
+
+    s32 const x = rect.x + m_config.padding;
+    s32 const y = rect.y + m_config.padding;
+
+    RK_ASSERT(bitmap);
+    RK_ASSERT(pitch >= width);
+    if (m_config.textures) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch);
+        glTextureSubImage2D(page.texture_id, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE,
+                            bitmap);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    f32 const inv_size = 1.0f / static_cast<f32>(m_config.page_size);
+    out.texture_id = page.texture_id;
+    out.page = page_index;
+    out.uv_min = {x * inv_size, y * inv_size};
+    out.uv_max = {(x + width) * inv_size, (y + height) * inv_size};
+    return Status::ok;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/renderer/rect_packer.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <glm/vec2.hpp>
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief Glyph bitmaps packed into a few large single channel textures.
+ *
+ * Each page is a square GL_R8 texture with its own `Rect_Packer`. Glyphs are placed on the first
+ * page with space, and a new page is created when none has. Once `Config::max_pages` is reached
+ * space is only reclaimed by clearing a whole page. Glyphs are separated by empty texels so linear
+ * filtering doesn't sample neighbouring glyphs.
+ *
+ * Requires a current OpenGL context, unless `Config::textures` is off.
+ */
+class Glyph_Atlas {
+public:
+    struct Config {
+        /** Width and height of each page texture in texels. */
+        s32 page_size = 1024;
+        /** Empty texels around each glyph. */
+        s32 padding = 1;
+        s32 max_pages = 4;
+        /**
+         * Create a texture for each page. Without, the atlas only tracks where glyphs go, so it
+         * and a `Glyph_Cache` using it run without OpenGL, as in tests. Every page texture is 0.
+         */
+        bool textures = true;
+    };
+
+    /**
+     * \brief Location of a glyph in the atlas.
+     *
+     * `uv_min` is the top left of the glyph bitmap and `uv_max` the bottom right.
+     */
+    struct Region {
+        u32 texture_id = 0;
+        s32 page = 0;
+        glm::vec2 uv_min = {0.0f, 0.0f};
+        glm::vec2 uv_max = {0.0f, 0.0f};
+    };
+
+    Glyph_Atlas() = default;
+
+    [[nodiscard]] Status initialize(Config config) noexcept;
+    Status destroy() noexcept;
+
+    /**
+     * \brief Add a glyph bitmap to the atlas.
+     *
+     * \param bitmap Rows of \a width bytes, \a pitch bytes apart. May be null if the glyph is
+     * empty.
+     * \return `buffer_length_error` if every page is full, `invalid_value` if the glyph is larger
+     * than a page.
+     */
+    [[nodiscard]] Status add(s32 width, s32 height, u8 const* bitmap, s32 pitch,
+                             Region& out) noexcept;
+
+    /**
+     * \brief Remove all glyphs from \a page. Regions on the page become invalid.
+     */
+    void clear_page(s32 page) noexcept;
+
+    [[nodiscard]] s32 page_size() const noexcept { return m_config.page_size; }
+    [[nodiscard]] s32 page_count() const noexcept { return static_cast<s32>(m_pages.size()); }
+    [[nodiscard]] u32 page_texture(s32 page) const noexcept;
+
+private:
+    struct Page {
+        u32 texture_id = 0;
+        Rect_Packer packer;
+    };
+
+    [[nodiscard]] Status add_page() noexcept;
+
+    Config m_config = {};
+    std::vector<Page> m_pages;
+};
+} // namespace rk
@@ -0,0 +1,335 @@
+#include "core/renderer/glyph_cache.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/utility/no_exception.h"
+#include <limits>
+#include <utility>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+using namespace rk;
+using namespace sds;
+
+Status Glyph_Cache::initialize(Config config) noexcept
+{
+    // Checked here, FreeType is only loaded when a glyph is first rasterized
+    if (config.sdf_spread < 2 || config.sdf_spread > 32) {
+        LOG_ERROR("SDF spread must be in [2, 32], got {}", config.sdf_spread);
+        return Status::invalid_value;
+    }
+    m_sdf_spread = config.sdf_spread;
+
+    RK_CHECK(m_glyph_atlas.initialize(config.atlas));
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_page_last_used.reserve(config.atlas.max_pages);
+        return Status::ok;
+    }));
+
+    return Status::ok;
+}
+
+Status Glyph_Cache::destroy() noexcept
+{
+    m_glyphs.clear();
+    m_page_last_used.clear();
+    RK_CHECK(m_glyph_atlas.destroy());
+
+    for (Font& font : m_fonts) {
+        if (font.face) { FT_Done_Face(font.face); }
+    }
+    m_fonts.clear();
+    if (m_ft) {
+        FT_Done_FreeType(m_ft);
+        m_ft = nullptr;
+    }
+    return Status::ok;
+}
+
+Status Glyph_Cache::load_font(char const* path, Font_Id& out_font) noexcept
+{
+    FT_Face face = nullptr;
+    RK_CHECK(open_face(path, face));
+    Status const ret = add_font({face, 0, {}}, out_font);
+    if (ret != Status::ok) { FT_Done_Face(face); }
+    return ret;
+}
+
+Status Glyph_Cache::load_baked_font(Baked_Font const& baked, char const* fallback_path,
+                                    Font_Id& out_font) noexcept
+{
+    Baked_Font_Header const& header = *baked.header;
+    if (header.render_mode > static_cast<u32>(Render_Mode::sdf)) {
+        LOG_ERROR("Baked font has unknown render mode {}", header.render_mode);
+        return Status::invalid_value;
+    }
+    Render_Mode const mode = static_cast<Render_Mode>(header.render_mode);
+    if (mode == Render_Mode::sdf && static_cast<s32>(header.sdf_spread) != m_sdf_spread) {
+        // Fallback glyphs would be drawn with a different distance range
+        LOG_ERROR("Baked font SDF spread {} doesn't match the glyph cache spread {}",
+                  header.sdf_spread, m_sdf_spread);
+        return Status::invalid_value;
+    }
+    if (header.pixel_size > std::numeric_limits<u16>::max()) {
+        LOG_ERROR("Baked font pixel size {} is too large", header.pixel_size);
+        return Status::invalid_value;
+    }
+    s32 const pixel_size = static_cast<s32>(header.pixel_size);
+    s32 const atlas_size = static_cast<s32>(header.atlas_size);
+
+    Font font;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        font.path = fallback_path;
+        return Status::ok;
+    }));
+    Font_Id font_id = 0;
+    RK_CHECK(add_font(std::move(font), font_id));
+
+    // The whole baked atlas goes in as one region, glyphs keep their offsets within it
+    Glyph_Atlas::Region region;
+    Status ret = m_glyph_atlas.add(atlas_size, atlas_size, baked.atlas, atlas_size, region);
+    if (ret == Status::buffer_length_error) {
+        RK_CHECK(evict_page());
+        ret = m_glyph_atlas.add(atlas_size, atlas_size, baked.atlas, atlas_size, region);
+    }
+    RK_CHECK(ret);
+    mark_page_used(region.page);
+    m_page_last_used[region.page] = pinned_page;
+
+    f32 const inv_page_size = 1.0f / static_cast<f32>(m_glyph_atlas.page_size());
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_glyphs.reserve(m_glyphs.size() + header.glyph_count);
+        for (u32 i = 0; i < header.glyph_count; ++i) {
+            Baked_Glyph const& g = baked.glyphs[i];
+            glm::vec2 const uv_min =
+                region.uv_min + glm::vec2(g.x * inv_page_size, g.y * inv_page_size);
+            glm::vec2 const uv_size = {g.width * inv_page_size, g.height * inv_page_size};
+            Glyph const glyph = {region.texture_id,
+                                 region.page,
+                                 uv_min,
+                                 uv_min + uv_size,
+                                 glm::ivec2(g.width, g.height),
+                                 glm::ivec2(g.bearing_x, g.bearing_y),
+                                 g.advance};
+            m_glyphs.emplace(make_key(font_id, pixel_size, g.codepoint, mode), glyph);
+        }
+        return Status::ok;
+    }));
+
+    out_font = font_id;
+    return Status::ok;
+}
+
+Status Glyph_Cache::initialize_freetype() noexcept
+{
+    if (m_ft) { return Status::ok; }
+
+    FT_Error err = FT_Init_FreeType(&m_ft);
+    if (err) {
+        LOG_ERROR("Failed to initialize FreeType: {}", FT_Error_String(err));
+        m_ft = nullptr;
+        return Status::api_error;
+    }
+
+    // Both SDF rasterizers, for outlines and for bitmaps, need the same spread
+    for (char const* module : {"sdf", "bsdf"}) {
+        err = FT_Property_Set(m_ft, module, "spread", &m_sdf_spread);
+        if (err) {
+            LOG_ERROR("Failed to set {} spread to {}: {}", module, m_sdf_spread,
+                      FT_Error_String(err));
+            FT_Done_FreeType(m_ft);
+            m_ft = nullptr;
+            return Status::invalid_value;
+        }
+    }
+    return Status::ok;
+}
+
+Status Glyph_Cache::open_face(char const* path, FT_FaceRec_*& out_face) noexcept
+{
+    // Fonts that are fully baked never get here, and never load FreeType
+    RK_CHECK(initialize_freetype());
+    FT_Face face = nullptr;
+    FT_Error err = FT_New_Face(m_ft, path, 0, &face);
+    if (err) {
+        LOG_ERROR("Failed to load font face ({}): {}", path, FT_Error_String(err));
+        return Status::io_error;
+    }
+
+    err = FT_Select_Charmap(face, FT_ENCODING_UNICODE);
+    if (err) {
+        LOG_ERROR("Failed to select encoding for '{}': {}", path, FT_Error_String(err));
+        FT_Done_Face(face);
+        return Status::api_error;
+    }
+
+    out_face = face;
+    return Status::ok;
+}
+
+Status Glyph_Cache::add_font(Font font, Font_Id& out_font) noexcept
+{
+    if (m_fonts.size() > std::numeric_limits<Font_Id>::max()) {
+        LOG_ERROR("Too many fonts loaded");
+        return Status::buffer_length_error;
+    }
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_fonts.push_back(std::move(font));
+        return Status::ok;
+    }));
+    out_font = static_cast<Font_Id>(m_fonts.size() - 1);
+    return Status::ok;
+}
+
+u64 Glyph_Cache::make_key(Font_Id font, s32 pixel_size, u32 codepoint, Render_Mode mode) noexcept
+{
+    // Code points are at most 21 bits
+    RK_ASSERT(pixel_size > 0 && pixel_size <= std::numeric_limits<u16>::max());
+    RK_ASSERT(codepoint <= 0x10FFFF);
+    return (static_cast<u64>(font) << 48) | (static_cast<u64>(pixel_size) << 32) |
+           (static_cast<u64>(mode) << 24) | codepoint;
+}
+
+Status Glyph_Cache::get(Font_Id font, s32 pixel_size, u32 codepoint, Render_Mode mode,
+                        Glyph& out) noexcept
+{
+    RK_ASSERT(font < m_fonts.size());
+    u64 const key = make_key(font, pixel_size, codepoint, mode);
+
+    auto it = m_glyphs.find(key);
+    if (it == m_glyphs.end()) {
+        Glyph glyph;
+        RK_CHECK(rasterize(font, pixel_size, codepoint, mode, glyph));
+        RK_CHECK_EXB(exception_boundary([&]() {
+            it = m_glyphs.emplace(key, glyph).first;
+            return Status::ok;
+        }));
+    }
+    out = it->second;
+
+    // Empty glyphs take no atlas space, so they don't keep a page alive
+    if (out.size.x > 0 && out.size.y > 0) { mark_page_used(out.page); }
+    return Status::ok;
+}
+
+void Glyph_Cache::mark_page_used(s32 page) noexcept
+{
+    if (page >= static_cast<s32>(m_page_last_used.size())) {
+        RK_ASSERT(static_cast<size_t>(page) < m_page_last_used.capacity());
+        m_page_last_used.resize(page + 1, 0);
+    }
+    if (m_page_last_used[page] != pinned_page) { m_page_last_used[page] = m_batch; }
+}
+
+Status Glyph_Cache::rasterize(Font_Id font, s32 pixel_size, u32 codepoint, Render_Mode mode,
+                              Glyph& out) noexcept
+{
+    Font& f = m_fonts[font];
+    if (!f.face) {
+        // Baked font missing a glyph
+        LOG_DEBUG("Opening '{}' to rasterize U+{:04X}", f.path, codepoint);
+        RK_CHECK(open_face(f.path.c_str(), f.face));
+    }
+
+    FT_Error err = 0;
+    if (f.pixel_size != pixel_size) {
+        err = FT_Set_Pixel_Sizes(f.face, 0, pixel_size);
+        if (err) {
+            LOG_ERROR("Failed to set font glyph pixel size {}: {}", pixel_size,
+                      FT_Error_String(err));
+            return Status::api_error;
+        }
+        f.pixel_size = pixel_size;
+    }
+
+    err = FT_Load_Char(f.face, codepoint, FT_LOAD_DEFAULT);
+    if (err) {
+        LOG_ERROR("Failed to load glyph for code point U+{:04X}: {}", codepoint,
+                  FT_Error_String(err));
+        return Status::api_error;
+    }
+
+    FT_GlyphSlot const slot = f.face->glyph;
+    FT_Render_Mode const ft_mode =
+        (mode == Render_Mode::sdf ? FT_RENDER_MODE_SDF : FT_RENDER_MODE_NORMAL);
+    err = FT_Render_Glyph(slot, ft_mode);
+    if (err) {
+        LOG_ERROR("Failed to render glyph for code point U+{:04X}: {}", codepoint,
+                  FT_Error_String(err));
+        return Status::api_error;
+    }
+
+    // NOTE: The glyph is a grayscale 8-bit image with a single byte per color. SDF glyphs include
+    // a border of the spread width, which the bitmap offsets account for.
+    FT_Bitmap const& bitmap = slot->bitmap;
+    s32 const width = static_cast<s32>(bitmap.width);
+    s32 const height = static_cast<s32>(bitmap.rows);
+
+    Glyph_Atlas::Region region;
+    Status ret = m_glyph_atlas.add(width, height, bitmap.buffer, bitmap.pitch, region);
+    if (ret == Status::buffer_length_error) {
+        // An empty page always has room, the glyph is known to fit in one
+        RK_CHECK(evict_page());
+        ret = m_glyph_atlas.add(width, height, bitmap.buffer, bitmap.pitch, region);
+    }
+    RK_CHECK(ret);
+
+    out = {region.texture_id,
+           region.page,
+           region.uv_min,
+           region.uv_max,
+           glm::ivec2(width, height),
+           glm::ivec2(slot->bitmap_left, slot->bitmap_top),
+           slot->advance.x};
+    return Status::ok;
+}
+
+s32 Glyph_Cache::least_recently_used_page(std::vector<u64> const& page_last_used,
+                                          u64 batch) noexcept
+{
+    s32 lru_page = -1;
+    u64 oldest = batch;
+    for (s32 page = 0; page < static_cast<s32>(page_last_used.size()); ++page) {
+        if (page_last_used[page] < oldest) {
+            oldest = page_last_used[page];
+            lru_page = page;
+        }
+    }
+    return lru_page;
+}
+
+Status Glyph_Cache::evict_page() noexcept
+{
+    s32 const lru_page = least_recently_used_page(m_page_last_used, m_batch);
+    if (lru_page < 0) {
+        LOG_WARN("Glyph atlas is full with glyphs in use, glyph dropped");
+        return Status::buffer_length_error;
+    }
+
+    LOG_DEBUG("Evicting glyph atlas page {}", lru_page);
+    m_glyph_atlas.clear_page(lru_page);
+    for (auto it = m_glyphs.begin(); it != m_glyphs.end();) {
+        Glyph const& g = it->second;
+        if (g.page == lru_page && g.size.x > 0 && g.size.y > 0) {
+            it = m_glyphs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_page_last_used[lru_page] = 0;
+    ++m_eviction_count;
+    return Status::ok;
+}
+
+void Glyph_Cache::mark_used(u32 texture_id) noexcept
+{
+    for (s32 page = 0; page < static_cast<s32>(m_page_last_used.size()); ++page) {
+        if (m_glyph_atlas.page_texture(page) == texture_id) {
+            mark_page_used(page);
+            return;
+        }
+    }
+}
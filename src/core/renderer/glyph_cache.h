@@ -0,0 +1,168 @@
+#pragma once
+
+#include "core/renderer/baked_font.h"
+#include "core/renderer/glyph_atlas.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <glm/vec2.hpp>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
+
+namespace rk
+{
+/**
+ * \brief Rasterized glyphs, keyed by font, pixel size and code point.
+ *
+ * Glyphs are rasterized with FreeType the first time they are requested and stored in a
+ * `Glyph_Atlas`, either as coverage bitmaps or as signed distance fields (see `Render_Mode`).
+ * When the atlas is full, the least recently used page is cleared and its glyphs are rasterized
+ * again if they are requested later.
+ *
+ * Glyphs returned since the last `end_batch` may be referenced by queued vertices, so their pages
+ * are never evicted. If every page is in use by the current batch, new glyphs can't be added until
+ * the next batch.
+ *
+ * Fonts baked offline (see `baked_font.h`) skip rasterization for their glyphs. Their atlas is
+ * uploaded as a whole and never evicted. FreeType is only initialized when a font face is first
+ * opened, so a fully baked font never loads it.
+ *
+ * Requires a current OpenGL context, unless the atlas is configured without textures. Not thread
+ * safe.
+ */
+class Glyph_Cache {
+public:
+    using Font_Id = u16;
+
+    enum class Render_Mode : u8 {
+        /** Coverage bitmaps. Sharp at the rasterized size, blurry when scaled up. */
+        bitmap,
+        /**
+         * Signed distance fields, 0.5 on the outline and increasing inwards. Can be drawn at any
+         * scale from one rasterized size with a distance threshold in the shader.
+         */
+        sdf,
+    };
+
+    struct Config {
+        Glyph_Atlas::Config atlas;
+        /**
+         * Distance range of SDF glyphs, in pixels either side of the outline. Also the width of the
+         * border added around each SDF glyph. FreeType accepts [2, 32].
+         */
+        s32 sdf_spread = 8;
+    };
+
+    struct Glyph {
+        u32 texture_id;     // handle of the atlas page texture
+        s32 page;           // atlas page
+        glm::vec2 uv_min;   // top left of the glyph in the atlas page
+        glm::vec2 uv_max;   // bottom right of the glyph in the atlas page
+        glm::ivec2 size;    // glyph size
+        glm::ivec2 bearing; // offset from baseline to left/top of glyph
+        s64 advance;        // offset to advance to next glyph, in 1/64 pixels
+    };
+
+    Glyph_Cache() = default;
+
+    [[nodiscard]] Status initialize(Config config) noexcept;
+    Status destroy() noexcept;
+
+    /**
+     * \brief Load a font face from the file at \a path.
+     */
+    [[nodiscard]] Status load_font(char const* path, Font_Id& out_font) noexcept;
+
+    /**
+     * \brief Load the glyphs of a baked font into the atlas.
+     *
+     * \a baked is only read during the call. Glyphs that weren't baked are rasterized from the font
+     * file at \a fallback_path, which is only opened when such a glyph is first requested. It must
+     * be the file the font was baked from, so the metrics match.
+     *
+     * \return `invalid_value` if the baked atlas doesn't fit in an atlas page or its SDF spread
+     * differs from the configured one.
+     */
+    [[nodiscard]] Status load_baked_font(Baked_Font const& baked, char const* fallback_path,
+                                         Font_Id& out_font) noexcept;
+
+    /**
+     * \brief Get the glyph for \a codepoint, rasterizing it if it isn't cached.
+     *
+     * Code points the font doesn't have give the font's missing glyph.
+     *
+     * \return `buffer_length_error` if the atlas is full with glyphs of the current batch.
+     */
+    [[nodiscard]] Status get(Font_Id font, s32 pixel_size, u32 codepoint, Render_Mode mode,
+                             Glyph& out) noexcept;
+
+    /**
+     * \brief Mark the glyphs returned so far as no longer in use, so their pages can be evicted.
+     */
+    void end_batch() noexcept { ++m_batch; }
+
+    /**
+     * \brief Mark the atlas page with \a texture_id as used by the current batch.
+     *
+     * For vertices that reference glyphs without going through `get`, like cached layouts.
+     */
+    void mark_used(u32 texture_id) noexcept;
+
+    [[nodiscard]] s32 glyph_count() const noexcept { return static_cast<s32>(m_glyphs.size()); }
+
+    /**
+     * \brief Number of atlas pages evicted so far. Glyphs fetched before a change may be gone.
+     */
+    [[nodiscard]] u64 eviction_count() const noexcept { return m_eviction_count; }
+
+    /**
+     * \brief Page to evict, given the batch each page was last used in: the least recently used
+     * one not used in the current \a batch, or -1 if every page is in use.
+     */
+    [[nodiscard]] static s32 least_recently_used_page(std::vector<u64> const& page_last_used,
+                                                      u64 batch) noexcept;
+
+private:
+    struct Font {
+        FT_FaceRec_* face = nullptr; // null until needed for baked fonts
+        s32 pixel_size = 0;          // size currently set on the face
+        std::string path;
+    };
+
+    /** Last used batch of pages holding baked atlases, which are never evicted. */
+    static constexpr u64 pinned_page = std::numeric_limits<u64>::max();
+
+    /**
+     * \brief Initialize FreeType, if it isn't yet. Done when the first face is opened.
+     */
+    [[nodiscard]] Status initialize_freetype() noexcept;
+    [[nodiscard]] Status open_face(char const* path, FT_FaceRec_*& out_face) noexcept;
+    [[nodiscard]] Status add_font(Font font, Font_Id& out_font) noexcept;
+    void mark_page_used(s32 page) noexcept;
+
+    static u64 make_key(Font_Id font, s32 pixel_size, u32 codepoint, Render_Mode mode) noexcept;
+
+    [[nodiscard]] Status rasterize(Font_Id font, s32 pixel_size, u32 codepoint, Render_Mode mode,
+                                   Glyph& out) noexcept;
+
+    /**
+     * \brief Clear the least recently used atlas page that isn't used by the current batch.
+     *
+     * \return `buffer_length_error` if every page is used by the current batch.
+     */
+    [[nodiscard]] Status evict_page() noexcept;
+
+    FT_LibraryRec_* m_ft = nullptr;
+    s32 m_sdf_spread = 0;
+    std::vector<Font> m_fonts;
+    Glyph_Atlas m_glyph_atlas;
+    std::unordered_map<u64, Glyph> m_glyphs;
+    std::vector<u64> m_page_last_used; // batch each atlas page was last used in
+    u64 m_batch = 1;
+    u64 m_eviction_count = 0;
+};
+} // namespace rk
@@ -0,0 +1,162 @@
+#include "core/renderer/gpu_profiler.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/utility/no_exception.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <limits>
+
+using namespace rk;
+using namespace sds;
+
+constexpr f64 ns_per_ms = 1e6;
+
+Status Gpu_Profiler::initialize(Config config) noexcept
+{
+    if (config.max_passes <= 0 || config.log_interval < 0) {
+        LOG_ERROR("Invalid GPU profiler config: {} passes, log interval {}", config.max_passes,
+                  config.log_interval);
+        return Status::invalid_value;
+    }
+    m_config = config;
+
+    size_t const pass_slots = static_cast<size_t>(frame_count) * config.max_passes;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_passes.reserve(config.max_passes);
+        m_queries.resize(pass_slots * 2);
+        m_pass_states.assign(pass_slots, Pass_State::idle);
+        return Status::ok;
+    }));
+    glCreateQueries(GL_TIMESTAMP, static_cast<s32>(m_queries.size()), m_queries.data());
+    return Status::ok;
+}
+
+Status Gpu_Profiler::destroy() noexcept
+{
+    glDeleteQueries(static_cast<s32>(m_queries.size()), m_queries.data());
+    m_queries.clear();
+    m_pass_states.clear();
+    m_passes.clear();
+    m_last_queries = {};
+    m_frame_timing = {};
+    m_frame = 0;
+    m_frame_number = 0;
+    m_dropped_frame_count = 0;
+    return Status::ok;
+}
+
+Status Gpu_Profiler::add_pass(std::string_view name, Pass_Id& out_pass) noexcept
+{
+    if (pass_count() == m_config.max_passes) {
+        LOG_ERROR("GPU profiler can't measure more than {} passes", m_config.max_passes);
+        return Status::buffer_length_error;
+    }
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_passes.push_back({std::string(name), {}});
+        return Status::ok;
+    }));
+    out_pass = pass_count() - 1;
+    return Status::ok;
+}
+
+void Gpu_Profiler::begin_pass(Pass_Id pass) noexcept
+{
+    RK_ASSERT(pass >= 0 && pass < pass_count());
+    Pass_State& state = m_pass_states[static_cast<size_t>(m_frame) * m_config.max_passes + pass];
+    RK_ASSERT(state == Pass_State::idle);
+    state = Pass_State::begun;
+
+    u32 const query = m_queries[query_index(m_frame, pass)];
+    glQueryCounter(query, GL_TIMESTAMP);
+    m_last_queries[m_frame] = query;
+}
+
+void Gpu_Profiler::end_pass(Pass_Id pass) noexcept
+{
+    RK_ASSERT(pass >= 0 && pass < pass_count());
+    Pass_State& state = m_pass_states[static_cast<size_t>(m_frame) * m_config.max_passes + pass];
+    RK_ASSERT(state == Pass_State::begun);
+    state = Pass_State::ended;
+
+    u32 const query = m_queries[query_index(m_frame, pass) + 1];
+    glQueryCounter(query, GL_TIMESTAMP);
+    m_last_queries[m_frame] = query;
+}
+
+Status Gpu_Profiler::end_frame() noexcept
+{
+    if (m_queries.empty()) { return Status::ok; }
+
+    // The next frame reuses the queries of the oldest frame in flight, read them first
+    m_frame = (m_frame + 1) % frame_count;
+    read_frame(m_frame);
+
+    ++m_frame_number;
+    if (m_config.log_interval > 0 && m_frame_number % m_config.log_interval == 0) {
+        log_timings();
+    }
+    return Status::ok;
+}
+
+void Gpu_Profiler::read_frame(s32 frame) noexcept
+{
+    Pass_State* const states = &m_pass_states[static_cast<size_t>(frame) * m_config.max_passes];
+    u32 const last_query = m_last_queries[frame];
+    m_last_queries[frame] = 0;
+    if (last_query == 0) { return; }
+
+    // Queries complete in order, if the last one is available they all are
+    s32 available = GL_FALSE;
+    glGetQueryObjectiv(last_query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        ++m_dropped_frame_count;
+        std::fill(states, states + pass_count(), Pass_State::idle);
+        return;
+    }
+
+    u64 frame_begin = std::numeric_limits<u64>::max();
+    u64 frame_end = 0;
+    for (Pass_Id pass = 0; pass < pass_count(); ++pass) {
+        Pass_State const state = states[pass];
+        states[pass] = Pass_State::idle;
+        // A pass left begun at the end of a frame has no end timestamp
+        RK_ASSERT(state != Pass_State::begun);
+        if (state != Pass_State::ended) { continue; }
+
+        size_t const index = query_index(frame, pass);
+        u64 begin = 0;
+        u64 end = 0;
+        glGetQueryObjectui64v(m_queries[index], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(m_queries[index + 1], GL_QUERY_RESULT, &end);
+        end = std::max(begin, end);
+        m_passes[pass].timing.add(static_cast<f32>((end - begin) / ns_per_ms));
+        frame_begin = std::min(frame_begin, begin);
+        frame_end = std::max(frame_end, end);
+    }
+    if (frame_end > 0) {
+        m_frame_timing.add(static_cast<f32>((frame_end - frame_begin) / ns_per_ms));
+    }
+}
+
+std::string_view Gpu_Profiler::pass_name(Pass_Id pass) const noexcept
+{
+    RK_ASSERT(pass >= 0 && pass < pass_count());
+    return m_passes[pass].name;
+}
+
+Rolling_Timing const& Gpu_Profiler::pass_timing(Pass_Id pass) const noexcept
+{
+    RK_ASSERT(pass >= 0 && pass < pass_count());
+    return m_passes[pass].timing;
+}
+
+void Gpu_Profiler::log_timings() const noexcept
+{
+    LOG_INFO("GPU frame: {:.3f} ms avg, {:.3f} ms max, {} dropped frames",
+             m_frame_timing.average(), m_frame_timing.max(), m_dropped_frame_count);
+    for (Pass const& pass : m_passes) {
+        LOG_INFO("  {}: {:.3f} ms avg, {:.3f} ms max", pass.name, pass.timing.average(),
+                 pass.timing.max());
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/renderer/rolling_timing.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief GPU time of named render passes, measured with timer queries.
+ *
+ * Each pass is bracketed by two `GL_TIMESTAMP` queries. Unlike `GL_TIME_ELAPSED` queries,
+ * timestamps can nest and overlap, so a pass can be measured inside another.
+ *
+ * Query results are read back `frame_count - 1` frames late, when the GPU has long finished with
+ * them, so measuring never stalls the CPU. If a frame's results still aren't available when its
+ * queries are reused, that frame is dropped from the timings rather than waited on.
+ *
+ * Timings are in milliseconds, averaged over the last `Rolling_Timing::window_size` frames the pass
+ * was measured in.
+ *
+ * Requires a current OpenGL 4.5 context.
+ */
+class Gpu_Profiler {
+public:
+    using Pass_Id = s32;
+
+    /** Frames of queries in flight. Results are read this many frames minus one late. */
+    static constexpr s32 frame_count = 4;
+
+    struct Config {
+        s32 max_passes = 16;
+        /** Log the timings every this many frames. 0 never logs. */
+        s32 log_interval = 0;
+    };
+
+    Gpu_Profiler() = default;
+
+    [[nodiscard]] Status initialize(Config config) noexcept;
+    Status destroy() noexcept;
+
+    /**
+     * \brief Add a pass named \a name to measure.
+     *
+     * \return `buffer_length_error` if there are already `Config::max_passes` passes.
+     */
+    [[nodiscard]] Status add_pass(std::string_view name, Pass_Id& out_pass) noexcept;
+
+    /**
+     * \brief Start measuring \a pass. Each pass is measured at most once per frame.
+     */
+    void begin_pass(Pass_Id pass) noexcept;
+    void end_pass(Pass_Id pass) noexcept;
+
+    /**
+     * \brief End the frame's measurements, and read back those of the oldest frame in flight.
+     * Called by `Renderer::end_frame`.
+     */
+    [[nodiscard]] Status end_frame() noexcept;
+
+    [[nodiscard]] s32 pass_count() const noexcept { return static_cast<s32>(m_passes.size()); }
+    [[nodiscard]] std::string_view pass_name(Pass_Id pass) const noexcept;
+    [[nodiscard]] Rolling_Timing const& pass_timing(Pass_Id pass) const noexcept;
+
+    /** From the start of the first pass of a frame to the end of its last pass. */
+    [[nodiscard]] Rolling_Timing const& frame_timing() const noexcept { return m_frame_timing; }
+
+    /** Frames whose results weren't available in time. */
+    [[nodiscard]] u64 dropped_frame_count() const noexcept { return m_dropped_frame_count; }
+
+    /**
+     * \brief Log the frame and pass timings.
+     */
+    void log_timings() const noexcept;
+
+private:
+    enum class Pass_State : u8 { idle, begun, ended };
+
+    struct Pass {
+        std::string name;
+        Rolling_Timing timing;
+    };
+
+    /**
+     * \brief Add the results of \a frame to the timings if they're available, and reset it.
+     */
+    void read_frame(s32 frame) noexcept;
+
+    [[nodiscard]] size_t query_index(s32 frame, Pass_Id pass) const noexcept
+    {
+        return (static_cast<size_t>(frame) * m_config.max_passes + pass) * 2;
+    }
+
+    Config m_config = {};
+    std::vector<Pass> m_passes;
+    Rolling_Timing m_frame_timing;
+
+    // Begin and end timestamp queries of every pass, for each frame in flight
+    std::vector<u32> m_queries;
+    std::vector<Pass_State> m_pass_states;           // of every pass, for each frame in flight
+    std::array<u32, frame_count> m_last_queries = {}; // issued last in each frame, 0 if none
+    s32 m_frame = 0;                                  // frame being measured
+    u64 m_frame_number = 0;
+    u64 m_dropped_frame_count = 0;
+};
+} // namespace rk
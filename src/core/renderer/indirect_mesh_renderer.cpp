@@ -0,0 +1,298 @@
+#include "core/renderer/indirect_mesh_renderer.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/renderer/culling.h"
+#include "core/utility/no_exception.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+using namespace rk;
+using namespace sds;
+
+// Same attribute layout as "mesh_instanced.vert"
+constexpr u32 position_location = 0;
+constexpr u32 model_location = 3;
+constexpr u32 vertex_binding = 0;
+constexpr u32 instance_binding = 1;
+
+// Workgroup size of "cull_instances.comp"
+constexpr u32 cull_group_size = 64;
+
+Status Indirect_Mesh_Renderer::initialize(Config config) noexcept
+{
+    if (config.max_vertices <= 0 || config.max_indices <= 0 || config.max_meshes <= 0 ||
+        config.max_instances <= 0) {
+        LOG_ERROR("Invalid indirect mesh renderer config: {} vertices, {} indices, {} meshes, {} "
+                  "instances",
+                  config.max_vertices, config.max_indices, config.max_meshes,
+                  config.max_instances);
+        return Status::invalid_value;
+    }
+    m_config = config;
+
+    // Read by the GPU as is
+    RK_STATIC_ASSERT(sizeof(Gpu_Instance) == 80);
+    RK_STATIC_ASSERT(sizeof(Draw_Command) == 20);
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_commands.reserve(config.max_meshes);
+        m_mesh_instance_counts.reserve(config.max_meshes);
+        return Status::ok;
+    }));
+
+    RK_CHECK(m_cull_program.compile());
+    m_frustum_planes_uniform = m_cull_program.uniform("frustum_planes");
+    m_instance_count_uniform = m_cull_program.uniform("instance_count");
+
+    // Filled by the CPU as meshes and instances are added
+    constexpr GLbitfield upload_flags = GL_DYNAMIC_STORAGE_BIT;
+    glCreateBuffers(1, &m_vertex_buffer);
+    glNamedBufferStorage(m_vertex_buffer, config.max_vertices * 3 * sizeof(f32), nullptr,
+                         upload_flags);
+    glCreateBuffers(1, &m_index_buffer);
+    glNamedBufferStorage(m_index_buffer, config.max_indices * sizeof(u32), nullptr, upload_flags);
+    glCreateBuffers(1, &m_instance_buffer);
+    glNamedBufferStorage(m_instance_buffer, config.max_instances * sizeof(Gpu_Instance), nullptr,
+                         upload_flags);
+    glCreateBuffers(1, &m_bounds_buffer);
+    glNamedBufferStorage(m_bounds_buffer, config.max_meshes * 4 * sizeof(f32), nullptr,
+                         upload_flags);
+    glCreateBuffers(1, &m_command_buffer);
+    glNamedBufferStorage(m_command_buffer, config.max_meshes * sizeof(Draw_Command), nullptr,
+                         upload_flags);
+    // Only written by the GPU
+    glCreateBuffers(1, &m_visible_buffer);
+    glNamedBufferStorage(m_visible_buffer, config.max_instances * sizeof(Mat4), nullptr, 0);
+
+    glCreateVertexArrays(1, &m_vao);
+    glVertexArrayElementBuffer(m_vao, m_index_buffer);
+    glVertexArrayVertexBuffer(m_vao, vertex_binding, m_vertex_buffer, 0, 3 * sizeof(f32));
+    glEnableVertexArrayAttrib(m_vao, position_location);
+    glVertexArrayAttribFormat(m_vao, position_location, 3, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(m_vao, position_location, vertex_binding);
+
+    // The visible matrices, offset to each mesh's range by its command's base instance
+    glVertexArrayVertexBuffer(m_vao, instance_binding, m_visible_buffer, 0, sizeof(Mat4));
+    glVertexArrayBindingDivisor(m_vao, instance_binding, 1);
+    for (u32 column = 0; column < 4; ++column) {
+        u32 const location = model_location + column;
+        glEnableVertexArrayAttrib(m_vao, location);
+        glVertexArrayAttribFormat(m_vao, location, 4, GL_FLOAT, GL_FALSE,
+                                  column * 4 * sizeof(f32));
+        glVertexArrayAttribBinding(m_vao, location, instance_binding);
+    }
+    return Status::ok;
+}
+
+Status Indirect_Mesh_Renderer::destroy() noexcept
+{
+    std::array<u32, 6> buffers = {m_vertex_buffer,  m_index_buffer,   m_instance_buffer,
+                                  m_bounds_buffer,  m_command_buffer, m_visible_buffer};
+    glDeleteBuffers(static_cast<s32>(buffers.size()), buffers.data());
+    glDeleteVertexArrays(1, &m_vao);
+    m_cull_program.destroy();
+
+    m_vertex_buffer = m_index_buffer = m_instance_buffer = 0;
+    m_bounds_buffer = m_command_buffer = m_visible_buffer = 0;
+    m_vao = 0;
+    m_vertex_count = m_index_count = 0;
+    m_commands.clear();
+    m_mesh_instance_counts.clear();
+    m_instances.clear();
+    m_dirty_begin = m_dirty_end = 0;
+    return Status::ok;
+}
+
+std::array<f32, 4> rk::mesh_bounding_sphere(f32 const* positions, s32 vertex_count) noexcept
+{
+    RK_ASSERT(positions && vertex_count > 0);
+
+    // Bounding sphere around the center of the bounding box. Not the tightest, but cheap.
+    std::array<f32, 3> min_pos = {positions[0], positions[1], positions[2]};
+    std::array<f32, 3> max_pos = min_pos;
+    for (s32 v = 0; v < vertex_count; ++v) {
+        for (s32 axis = 0; axis < 3; ++axis) {
+            min_pos[axis] = std::min(min_pos[axis], positions[v * 3 + axis]);
+            max_pos[axis] = std::max(max_pos[axis], positions[v * 3 + axis]);
+        }
+    }
+    std::array<f32, 4> sphere = {(min_pos[0] + max_pos[0]) * 0.5f,
+                                 (min_pos[1] + max_pos[1]) * 0.5f,
+                                 (min_pos[2] + max_pos[2]) * 0.5f, 0.0f};
+    for (s32 v = 0; v < vertex_count; ++v) {
+        f32 const dx = positions[v * 3 + 0] - sphere[0];
+        f32 const dy = positions[v * 3 + 1] - sphere[1];
+        f32 const dz = positions[v * 3 + 2] - sphere[2];
+        sphere[3] = std::max(sphere[3], dx * dx + dy * dy + dz * dz);
+    }
+    sphere[3] = std::sqrt(sphere[3]);
+    return sphere;
+}
+
+void Indirect_Mesh_Renderer::assign_base_instances(std::vector<u32> const& mesh_instance_counts,
+                                                   std::vector<Draw_Command>& commands) noexcept
+{
+    RK_ASSERT(mesh_instance_counts.size() == commands.size());
+    // Give each mesh a range of the visible buffer large enough for all its instances
+    u32 base_instance = 0;
+    for (size_t mesh = 0; mesh < commands.size(); ++mesh) {
+        commands[mesh].base_instance = base_instance;
+        base_instance += mesh_instance_counts[mesh];
+    }
+}
+
+Status Indirect_Mesh_Renderer::add_mesh(f32 const* positions, s32 vertex_count,
+                                        u32 const* indices, s32 index_count,
+                                        Mesh_Id& out_mesh) noexcept
+{
+    RK_ASSERT(positions && vertex_count > 0);
+    RK_ASSERT(indices && index_count > 0);
+    if (vertex_count > m_config.max_vertices - m_vertex_count ||
+        index_count > m_config.max_indices - m_index_count ||
+        static_cast<s32>(m_commands.size()) == m_config.max_meshes) {
+        LOG_ERROR("Indirect mesh renderer is full, can't add a mesh of {} vertices and {} indices",
+                  vertex_count, index_count);
+        return Status::buffer_length_error;
+    }
+
+    std::array<f32, 4> const sphere = mesh_bounding_sphere(positions, vertex_count);
+
+    Mesh_Id const mesh = static_cast<Mesh_Id>(m_commands.size());
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_commands.push_back({static_cast<u32>(index_count), 0, static_cast<u32>(m_index_count),
+                              m_vertex_count, 0});
+        m_mesh_instance_counts.push_back(0);
+        return Status::ok;
+    }));
+
+    glNamedBufferSubData(m_vertex_buffer, m_vertex_count * 3 * sizeof(f32),
+                         vertex_count * 3 * sizeof(f32), positions);
+    glNamedBufferSubData(m_index_buffer, m_index_count * sizeof(u32), index_count * sizeof(u32),
+                         indices);
+    glNamedBufferSubData(m_bounds_buffer, mesh * sizeof(sphere), sizeof(sphere), sphere.data());
+    m_vertex_count += vertex_count;
+    m_index_count += index_count;
+    m_commands_dirty = true;
+
+    out_mesh = mesh;
+    return Status::ok;
+}
+
+Status Indirect_Mesh_Renderer::add_instance(Mesh_Id mesh, Mat4 const& model,
+                                            Instance_Id& out_instance) noexcept
+{
+    RK_ASSERT(mesh < m_commands.size());
+    if (instance_count() == m_config.max_instances) {
+        LOG_ERROR("Indirect mesh renderer is full, can't add more than {} instances",
+                  m_config.max_instances);
+        return Status::buffer_length_error;
+    }
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_instances.push_back({model, mesh, {0, 0, 0}});
+        return Status::ok;
+    }));
+    ++m_mesh_instance_counts[mesh];
+    m_commands_dirty = true;
+
+    out_instance = static_cast<Instance_Id>(m_instances.size() - 1);
+    set_transform(out_instance, model);
+    return Status::ok;
+}
+
+void Indirect_Mesh_Renderer::set_transform(Instance_Id instance, Mat4 const& model) noexcept
+{
+    RK_ASSERT(instance < m_instances.size());
+    m_instances[instance].model = model;
+
+    s32 const index = static_cast<s32>(instance);
+    if (m_dirty_begin == m_dirty_end) {
+        m_dirty_begin = index;
+        m_dirty_end = index + 1;
+    } else {
+        m_dirty_begin = std::min(m_dirty_begin, index);
+        m_dirty_end = std::max(m_dirty_end, index + 1);
+    }
+}
+
+Status Indirect_Mesh_Renderer::draw(Shader_Program const& shader, Mat4 const& view_projection,
+                                    Gl_State_Cache& gl_state, Render_Stats& stats) noexcept
+{
+    if (m_instances.empty()) { return Status::ok; }
+
+    if (m_dirty_begin < m_dirty_end) {
+        glNamedBufferSubData(m_instance_buffer, m_dirty_begin * sizeof(Gpu_Instance),
+                             (m_dirty_end - m_dirty_begin) * sizeof(Gpu_Instance),
+                             &m_instances[m_dirty_begin]);
+        m_dirty_begin = m_dirty_end = 0;
+        ++stats.gl_calls;
+        ++stats.buffer_uploads;
+    }
+
+    if (m_commands_dirty) {
+        assign_base_instances(m_mesh_instance_counts, m_commands);
+        m_commands_dirty = false;
+    }
+    // Zero the instance counts the culling appends to
+    s32 const mesh_count = static_cast<s32>(m_commands.size());
+    glNamedBufferSubData(m_command_buffer, 0, mesh_count * sizeof(Draw_Command),
+                         m_commands.data());
+    ++stats.gl_calls;
+    ++stats.buffer_uploads;
+
+    // Cull
+    Frustum const frustum = Frustum::from_view_projection(view_projection);
+    std::array<f32, Frustum::num_planes * 4> planes;
+    for (s32 p = 0; p < Frustum::num_planes; ++p) {
+        planes[p * 4 + 0] = frustum.a[p];
+        planes[p * 4 + 1] = frustum.b[p];
+        planes[p * 4 + 2] = frustum.c[p];
+        planes[p * 4 + 3] = frustum.d[p];
+    }
+    m_cull_program.set_vec4_array(m_frustum_planes_uniform, planes.data(), Frustum::num_planes);
+    m_cull_program.set_u32(m_instance_count_uniform, static_cast<u32>(instance_count()));
+    gl_state.use_program(m_cull_program.handle());
+    std::array<u32, 4> const storage_buffers = {m_instance_buffer, m_bounds_buffer,
+                                                m_command_buffer, m_visible_buffer};
+    glBindBuffersBase(GL_SHADER_STORAGE_BUFFER, 0, static_cast<s32>(storage_buffers.size()),
+                      storage_buffers.data());
+    u32 const group_count = (static_cast<u32>(instance_count()) + cull_group_size - 1) /
+                            cull_group_size;
+    glDispatchCompute(group_count, 1, 1);
+    // The draw reads the commands and the visible matrices written by the culling, and the next
+    // frame's reset of the instance counts overwrites them
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                    GL_BUFFER_UPDATE_BARRIER_BIT);
+    stats.gl_calls += 5;
+
+    // Draw every mesh with one call
+    gl_state.set_blend(false);
+    gl_state.use_program(shader.handle());
+    gl_state.bind_vertex_array(m_vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_command_buffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, mesh_count, 0);
+    stats.gl_calls += 2;
+    ++stats.draw_calls;
+    return Status::ok;
+}
+
+Status Indirect_Mesh_Renderer::read_visible_count(u32& out_count) noexcept
+{
+    s32 const mesh_count = static_cast<s32>(m_commands.size());
+    std::vector<Draw_Command> commands;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        commands.resize(mesh_count);
+        return Status::ok;
+    }));
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glGetNamedBufferSubData(m_command_buffer, 0, mesh_count * sizeof(Draw_Command),
+                            commands.data());
+    out_count = 0;
+    for (Draw_Command const& command : commands) { out_count += command.instance_count; }
+    return Status::ok;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "core/math/matrix.h"
+#include "core/renderer/gl_state_cache.h"
+#include "core/renderer/opengl/shader_program.h"
+#include "core/renderer/render_stats.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <array>
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief Sphere around the \a vertex_count positions, 3 floats each, as center xyz and radius.
+ *
+ * Centered on the bounding box, so not the tightest sphere, but cheap to find.
+ */
+[[nodiscard]] std::array<f32, 4> mesh_bounding_sphere(f32 const* positions,
+                                                      s32 vertex_count) noexcept;
+
+/**
+ * \brief Mesh instances culled and drawn by the GPU, with one multi-draw indirect call.
+ *
+ * Meshes share one vertex and one index buffer, so every mesh can be drawn by a single
+ * `glMultiDrawElementsIndirect`. Instance transforms and mesh bounding spheres live in shader
+ * storage buffers. Each frame a compute shader ("cull_instances.comp") tests every instance's
+ * bounding sphere against the view frustum. It appends the model matrices of the visible instances
+ * to each mesh's range of the visible instance buffer, and counts them in the mesh's indirect draw
+ * command. The draw then reads the visible matrices as instanced attributes.
+ *
+ * The CPU work of a frame is proportional to the number of meshes and to the transforms that
+ * changed, not to the number of instances.
+ *
+ * Draw with a program built from "mesh_instanced.vert". Vertices are a position at location 0, and
+ * the model matrix is at locations 3 to 6.
+ *
+ * Requires a current OpenGL 4.5 context.
+ */
+class Indirect_Mesh_Renderer {
+public:
+    using Mesh_Id = u32;
+    using Instance_Id = u32;
+
+    /** Same layout as `DrawElementsIndirectCommand`. */
+    struct Draw_Command {
+        u32 count;
+        u32 instance_count;
+        u32 first_index;
+        s32 base_vertex;
+        u32 base_instance;
+    };
+
+    struct Config {
+        s32 max_vertices = 1 << 20;
+        s32 max_indices = 1 << 22;
+        s32 max_meshes = 256;
+        s32 max_instances = 1 << 18;
+    };
+
+    Indirect_Mesh_Renderer() = default;
+
+    [[nodiscard]] Status initialize(Config config) noexcept;
+    Status destroy() noexcept;
+
+    /**
+     * \brief Add a mesh of \a vertex_count positions, 3 floats each, and \a index_count triangle
+     * indices.
+     *
+     * \return `buffer_length_error` if the vertex, index or mesh capacity is exceeded.
+     */
+    [[nodiscard]] Status add_mesh(f32 const* positions, s32 vertex_count, u32 const* indices,
+                                  s32 index_count, Mesh_Id& out_mesh) noexcept;
+
+    /**
+     * \return `buffer_length_error` if the instance capacity is exceeded.
+     */
+    [[nodiscard]] Status add_instance(Mesh_Id mesh, Mat4 const& model,
+                                      Instance_Id& out_instance) noexcept;
+
+    void set_transform(Instance_Id instance, Mat4 const& model) noexcept;
+
+    /**
+     * \brief Cull the instances against the frustum of \a view_projection and draw the visible
+     * ones with \a shader.
+     *
+     * \a view_projection must match `Renderer::set_view_projection`, which \a shader draws with.
+     */
+    [[nodiscard]] Status draw(Shader_Program const& shader, Mat4 const& view_projection,
+                              Gl_State_Cache& gl_state, Render_Stats& stats) noexcept;
+
+    /**
+     * \brief Number of instances found visible by the last `draw`. Waits for the GPU, for tests and
+     * debugging only.
+     */
+    [[nodiscard]] Status read_visible_count(u32& out_count) noexcept;
+
+    [[nodiscard]] s32 instance_count() const noexcept
+    {
+        return static_cast<s32>(m_instances.size());
+    }
+
+    /**
+     * \brief Give each mesh's command a range of the visible instance buffer, of
+     * \a mesh_instance_counts of that mesh. Ranges follow each other in mesh order.
+     */
+    static void assign_base_instances(std::vector<u32> const& mesh_instance_counts,
+                                      std::vector<Draw_Command>& commands) noexcept;
+
+private:
+    /** Instance in the shader storage buffer, std430 layout. */
+    struct Gpu_Instance {
+        Mat4 model;
+        u32 mesh;
+        u32 padding[3];
+    };
+
+    Config m_config = {};
+
+    u32 m_vertex_buffer = 0;
+    u32 m_index_buffer = 0;
+    u32 m_instance_buffer = 0; // Gpu_Instance
+    u32 m_bounds_buffer = 0;   // bounding sphere of each mesh, vec4 center and radius
+    u32 m_command_buffer = 0;  // Draw_Command of each mesh
+    u32 m_visible_buffer = 0;  // model matrices of visible instances, grouped by mesh
+    u32 m_vao = 0;
+
+    Shader_Program m_cull_program{"cull_instances.comp"};
+    Uniform_Handle m_frustum_planes_uniform;
+    Uniform_Handle m_instance_count_uniform;
+
+    s32 m_vertex_count = 0;
+    s32 m_index_count = 0;
+    // Commands with no instances, uploaded every frame to reset the counts the culling appends to
+    std::vector<Draw_Command> m_commands;
+    std::vector<u32> m_mesh_instance_counts;
+    bool m_commands_dirty = false; // instance counts changed, base instances need updating
+
+    std::vector<Gpu_Instance> m_instances;
+    s32 m_dirty_begin = 0; // range of instances to upload
+    s32 m_dirty_end = 0;
+};
+} // namespace rk
@@ -0,0 +1,81 @@
+#include "core/renderer/opengl/program_binary.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/utility/no_exception.h"
+#include <cstdint>
+#include <cstring>
+
+using namespace rk;
+using namespace sds;
+
+u64 rk::program_binary_key_append(u64 key, std::string_view part) noexcept
+{
+    constexpr u64 prime = 1099511628211ull;
+    u64 const length = part.size();
+    for (s32 i = 0; i < 8; ++i) {
+        key ^= (length >> (i * 8)) & 0xFF;
+        key *= prime;
+    }
+    for (char c : part) {
+        key ^= static_cast<u8>(c);
+        key *= prime;
+    }
+    return key;
+}
+
+Status rk::parse_program_binary(u8 const* data, size_t size, u64 key,
+                                Program_Binary& out) noexcept
+{
+    if (!data || size < sizeof(Program_Binary_Header)) {
+        LOG_WARN("Program binary is truncated: {} bytes", size);
+        return Status::invalid_value;
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(Program_Binary_Header) != 0) {
+        LOG_WARN("Program binary data isn't aligned");
+        return Status::invalid_value;
+    }
+
+    auto const* header = reinterpret_cast<Program_Binary_Header const*>(data);
+    if (header->magic != Program_Binary_Header::expected_magic) {
+        LOG_WARN("Not a program binary");
+        return Status::invalid_value;
+    }
+    if (header->version != Program_Binary_Header::current_version) {
+        LOG_WARN("Program binary version {} isn't supported, expected {}", header->version,
+                 Program_Binary_Header::current_version);
+        return Status::invalid_value;
+    }
+    if (header->key != key) {
+        LOG_WARN("Program binary key {:016x} doesn't match {:016x}", header->key, key);
+        return Status::invalid_value;
+    }
+    u64 const expected_size = sizeof(Program_Binary_Header) + static_cast<u64>(header->binary_size);
+    if (header->binary_size == 0 || size != expected_size) {
+        LOG_WARN("Program binary is {} bytes, expected {}", size, expected_size);
+        return Status::invalid_value;
+    }
+
+    out.binary_format = header->binary_format;
+    out.binary = data + sizeof(Program_Binary_Header);
+    out.binary_size = header->binary_size;
+    return Status::ok;
+}
+
+Status rk::serialize_program_binary(u64 key, Program_Binary const& binary,
+                                    std::vector<u8>& out) noexcept
+{
+    RK_ASSERT(binary.binary);
+    Program_Binary_Header header;
+    header.key = key;
+    header.binary_format = binary.binary_format;
+    header.binary_size = binary.binary_size;
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        out.resize(sizeof(header) + binary.binary_size);
+        return Status::ok;
+    }));
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + sizeof(header), binary.binary, binary.binary_size);
+    return Status::ok;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/status.h"
+#include "core/types.h"
+#include <array>
+#include <string_view>
+#include <vector>
+
+/**
+ * \file program_binary.h
+ * \brief File format of the linked program cache, which saves compiling shaders on every launch.
+ *
+ * Layout, in the byte order of the machine that wrote it:
+ * - `Program_Binary_Header`
+ * - `binary_size` bytes from `glGetProgramBinary`
+ *
+ * The key identifies the shader sources and the driver the binary was made by. A binary from
+ * another driver, or a driver update, doesn't load, so the key includes the driver's vendor,
+ * renderer and version strings.
+ */
+
+namespace rk
+{
+struct Program_Binary_Header {
+    static constexpr std::array<char, 4> expected_magic = {'R', 'K', 'P', 'B'};
+    static constexpr u32 current_version = 1;
+
+    std::array<char, 4> magic = expected_magic;
+    u32 version = current_version;
+    u64 key = 0;
+    u32 binary_format = 0; // passed back to `glProgramBinary`
+    u32 binary_size = 0;
+};
+
+RK_STATIC_ASSERT(sizeof(Program_Binary_Header) == 24);
+
+/**
+ * \brief View of a program binary in memory. Doesn't own the data.
+ */
+struct Program_Binary {
+    u32 binary_format = 0;
+    u8 const* binary = nullptr;
+    u32 binary_size = 0;
+};
+
+/** Key before any parts are appended. */
+constexpr u64 program_binary_key_seed = 14695981039346656037ull;
+
+/**
+ * \brief Mix \a part into \a key, with 64 bit FNV-1a.
+ *
+ * Parts are length prefixed, so text moved from one part to the next changes the key.
+ */
+[[nodiscard]] u64 program_binary_key_append(u64 key, std::string_view part) noexcept;
+
+/**
+ * \brief Validate the cached program in \a data and point \a out into it.
+ *
+ * \a data must be 8 byte aligned and outlive \a out.
+ *
+ * \return `invalid_value` if the data isn't a program binary of the current version for \a key,
+ * or is truncated.
+ */
+[[nodiscard]] Status parse_program_binary(u8 const* data, size_t size, u64 key,
+                                          Program_Binary& out) noexcept;
+
+/**
+ * \brief Write \a binary, cached under \a key, to \a out.
+ */
+[[nodiscard]] Status serialize_program_binary(u64 key, Program_Binary const& binary,
+                                              std::vector<u8>& out) noexcept;
+} // namespace rk
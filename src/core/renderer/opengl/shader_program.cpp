@@ -2,10 +2,18 @@
 
 #include "core/assert.h"
 #include "core/logging/logging.h"
+#include "core/platform/filesystem.h"
+#include "core/platform/stdlib/cstdio.h"
 #include "core/platform/stdlib/fstream.h"
+#include "core/renderer/opengl/program_binary.h"
 #include "core/utility/no_exception.h"
 #include <glad/glad.h>
+#include <array>
+#include <cstdio>
+#include <random>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <glm/gtc/type_ptr.hpp>
 
 using namespace rk;
@@ -22,7 +30,7 @@ std::string get_program_info_log(u32 id) noexcept
 }
 
 RK_INTERNAL
-Status compile_shader(char const* name, s32 shader_id) noexcept
+Status read_shader_source(char const* name, std::string& shader) noexcept
 {
     RK_ASSERT(name);
 
@@ -36,8 +44,6 @@ Status compile_shader(char const* name, s32 shader_id) noexcept
             return Status::io_error;
         }
 
-        std::string shader;
-
         f.seekg(0, std::ios::end);
         if (f.fail()) {
             LOG_ERROR("Failed to seek to EOF of shader file '{}'", shader_path);
@@ -56,28 +62,166 @@ Status compile_shader(char const* name, s32 shader_id) noexcept
         if (f.fail()) {
             LOG_WARN("Failed to close shader file '{}', but not much we can do!", shader_path);
         }
+        return Status::ok;
+    });
+    auto p_status = std::get_if<Status>(&ret);
+    RK_ASSERT(p_status); // must return a status
+    return *p_status;
+}
 
-        char const* shader_contents = shader.c_str();
+RK_INTERNAL
+void compile_shader(char const* name, std::string const& shader, s32 shader_id) noexcept
+{
+    RK_ASSERT(name);
+
+    char const* shader_contents = shader.c_str();
 
-        glShaderSource(shader_id, 1, &shader_contents, nullptr);
-        glCompileShader(shader_id);
+    glShaderSource(shader_id, 1, &shader_contents, nullptr);
+    glCompileShader(shader_id);
 
-        s32 compile_success = 0;
-        glGetShaderiv(shader_id, GL_COMPILE_STATUS, &compile_success);
-        if (!compile_success) {
-            LOG_ERROR("Failed to compile shader {} ('{}'): {}",
-                shader_id,
-                shader_path,
-                get_program_info_log(shader_id));
+    s32 compile_success = 0;
+    glGetShaderiv(shader_id, GL_COMPILE_STATUS, &compile_success);
+    if (!compile_success) {
+        LOG_ERROR("Failed to compile shader {} ('{}'): {}",
+            shader_id,
+            name,
+            get_program_info_log(shader_id));
+    }
+
+    LOG_DEBUG("Compiled shader id {} ('{}')", shader_id, name);
+}
+
+#ifdef RK_SHADER_CACHE_DIR
+/**
+ * \brief Key of a program built from \a sources by the current driver.
+ */
+RK_INTERNAL
+u64 make_program_binary_key(std::array<std::string, 2> const& sources) noexcept
+{
+    u64 key = program_binary_key_seed;
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        char const* value = reinterpret_cast<char const*>(glGetString(name));
+        key = program_binary_key_append(key, value ? value : "");
+    }
+    for (std::string const& source : sources) { key = program_binary_key_append(key, source); }
+    return key;
+}
+
+/**
+ * \brief Link \a program from the binary cached at \a path.
+ *
+ * \return `invalid_value` if there's no usable binary, and the program must be built from source.
+ */
+RK_INTERNAL
+Status load_program_binary(u32 program, char const* path, u64 key) noexcept
+{
+    bool exists = false;
+    RK_CHECK(fs::file_exists(path, exists));
+    if (!exists) { return Status::invalid_value; }
+
+    // Read rather than mapped, since another process may replace the file while it's in use
+    FILE* file = rk::fopen(path, "rb");
+    if (!file) {
+        LOG_WARN("Failed to open '{}'", path);
+        return Status::io_error;
+    }
+    std::vector<u8> data;
+    Status read_status = Status::io_error;
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        long const size = std::ftell(file);
+        if (size >= 0 && std::fseek(file, 0, SEEK_SET) == 0) {
+            auto ret = exception_boundary([&]() {
+                data.resize(static_cast<size_t>(size));
+                return Status::ok;
+            });
+            Status const* alloc_status = std::get_if<Status>(&ret);
+            if (alloc_status && *alloc_status == Status::ok &&
+                std::fread(data.data(), 1, data.size(), file) == data.size()) {
+                read_status = Status::ok;
+            }
         }
+    }
+    std::fclose(file);
+    if (read_status != Status::ok) {
+        LOG_WARN("Failed to read '{}'", path);
+        return read_status;
+    }
+
+    Program_Binary binary;
+    RK_CHECK(parse_program_binary(data.data(), data.size(), key, binary));
 
-        LOG_DEBUG("Compiled shader id {} ('{}')", shader_id, shader_path);
+    glProgramBinary(program, binary.binary_format, binary.binary,
+                    static_cast<s32>(binary.binary_size));
+    s32 link_success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &link_success);
+    if (!link_success) {
+        // Drivers may reject their own binaries, for example after an update
+        LOG_INFO("Cached program '{}' was rejected by the driver, building from source", path);
+        return Status::invalid_value;
+    }
+    return Status::ok;
+}
+
+/**
+ * \brief Cache the binary of the linked \a program at \a path.
+ */
+RK_INTERNAL
+Status save_program_binary(u32 program, char const* path, u64 key) noexcept
+{
+    s32 binary_size = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+    if (binary_size <= 0) {
+        LOG_WARN("Driver returned no binary for program {}", program);
+        return Status::renderer_error;
+    }
+
+    std::vector<u8> binary_data;
+    std::vector<u8> file_data;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        binary_data.resize(binary_size);
         return Status::ok;
-    });
-    auto p_status = std::get_if<Status>(&ret);
-    RK_ASSERT(p_status); // must return a status
-    return *p_status;
+    }));
+    GLenum binary_format = 0;
+    glGetProgramBinary(program, binary_size, nullptr, &binary_format, binary_data.data());
+
+    Program_Binary binary;
+    binary.binary_format = binary_format;
+    binary.binary = binary_data.data();
+    binary.binary_size = static_cast<u32>(binary_size);
+    RK_CHECK(serialize_program_binary(key, binary, file_data));
+
+    RK_CHECK(fs::create_directory(RK_SHADER_CACHE_DIR));
+
+    // Written beside the target and renamed over it, so other processes reading the cache never
+    // see a partial file
+    std::string temp_path;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        temp_path = fmt::format("{}.{:08x}.tmp", path, std::random_device{}());
+        return Status::ok;
+    }));
+    FILE* file = rk::fopen(temp_path.c_str(), "wb");
+    if (!file) {
+        LOG_WARN("Failed to open '{}' for writing", temp_path);
+        return Status::io_error;
+    }
+    size_t const written = std::fwrite(file_data.data(), 1, file_data.size(), file);
+    if (std::fclose(file) != 0 || written != file_data.size()) {
+        LOG_WARN("Failed to write '{}'", temp_path);
+        rk::remove(temp_path.c_str());
+        return Status::io_error;
+    }
+    if (rk::rename(temp_path.c_str(), path) != 0) {
+        // Renaming over an existing file fails on Windows
+        rk::remove(path);
+        if (rk::rename(temp_path.c_str(), path) != 0) {
+            LOG_WARN("Failed to rename '{}' to '{}'", temp_path, path);
+            rk::remove(temp_path.c_str());
+            return Status::io_error;
+        }
+    }
+    return Status::ok;
 }
+#endif
 
 Shader_Program::Shader_Program(char const* vert_shader_path, char const* frag_shader_path) noexcept
     : m_vert_shader_path(vert_shader_path), m_frag_shader_path(frag_shader_path)
@@ -86,6 +230,12 @@ Shader_Program::Shader_Program(char const* vert_shader_path, char const* frag_sh
     RK_ASSERT(frag_shader_path);
 }
 
+Shader_Program::Shader_Program(char const* comp_shader_path) noexcept
+    : m_comp_shader_path(comp_shader_path)
+{
+    RK_ASSERT(comp_shader_path);
+}
+
 Shader_Program::~Shader_Program() noexcept { destroy(); }
 
 void Shader_Program::destroy() noexcept
@@ -94,6 +244,7 @@ void Shader_Program::destroy() noexcept
         glDeleteProgram(m_id);
         m_id = invalid_handle;
     }
+    m_uniforms.clear();
 
     RK_ASSERT(m_id == invalid_handle);
 }
@@ -118,16 +269,54 @@ Status Shader_Program::compile() noexcept
         return Status::ok;
     }
 
+    // Either a compute shader, or a vertex and a fragment shader
+    std::array<GLenum, 2> stages = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+    std::array<char const*, 2> paths = {m_vert_shader_path, m_frag_shader_path};
+    if (m_comp_shader_path) {
+        stages = {GL_COMPUTE_SHADER, 0};
+        paths = {m_comp_shader_path, nullptr};
+    }
+    std::array<std::string, 2> sources;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (paths[i]) { RK_CHECK(read_shader_source(paths[i], sources[i])); }
+    }
+
     m_id = glCreateProgram();
 
-    s32 const vert_shader = glCreateShader(GL_VERTEX_SHADER);
-    s32 const frag_shader = glCreateShader(GL_FRAGMENT_SHADER);
+#ifdef RK_SHADER_CACHE_DIR
+    // The sources still have to be read to find the key, but reading is cheap next to compiling
+    s32 binary_format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binary_format_count);
+    bool const use_cache = binary_format_count > 0;
+    u64 key = 0;
+    std::string cache_path;
+    if (use_cache) {
+        key = make_program_binary_key(sources);
+        RK_CHECK_EXB(exception_boundary([&]() {
+            cache_path = fmt::format("{}/{:016x}.rkprog", RK_SHADER_CACHE_DIR, key);
+            return Status::ok;
+        }));
+        if (load_program_binary(m_id, cache_path.c_str(), key) == Status::ok) {
+            LOG_DEBUG("Loaded program {} from '{}'", m_id, cache_path);
+            return reflect_uniforms();
+        }
+        // Start again with a program that hasn't been given a rejected binary
+        glDeleteProgram(m_id);
+        m_id = glCreateProgram();
+        glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
 
-    RK_CHECK(compile_shader(m_vert_shader_path, vert_shader));
-    RK_CHECK(compile_shader(m_frag_shader_path, frag_shader));
+    std::array<s32, 2> shaders = {0, 0};
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!paths[i]) { continue; }
+        shaders[i] = glCreateShader(stages[i]);
+        compile_shader(paths[i], sources[i], shaders[i]);
+    }
 
-    glAttachShader(m_id, vert_shader);
-    glAttachShader(m_id, frag_shader);
+    for (s32 shader : shaders) {
+        if (shader) { glAttachShader(m_id, shader); }
+    }
     glLinkProgram(m_id);
 
     s32 link_success = 0;
@@ -137,84 +326,137 @@ Status Shader_Program::compile() noexcept
         return Status::renderer_error;
     }
 
-    glDeleteShader(vert_shader);
-    glDeleteShader(frag_shader);
+    for (s32 shader : shaders) {
+        if (shader) { glDeleteShader(shader); }
+    }
 
-    return Status::ok;
+#ifdef RK_SHADER_CACHE_DIR
+    // A program that can't be cached still works, it's only built from source again next time
+    if (use_cache && save_program_binary(m_id, cache_path.c_str(), key) != Status::ok) {
+        LOG_WARN("Failed to cache program {} at '{}'", m_id, cache_path);
+    }
+#endif
+
+    return reflect_uniforms();
 }
 
-void Shader_Program::set_bool(char const* name, bool v) const noexcept {
-    set_s32(name, static_cast<s32>(v));
+Status Shader_Program::reflect_uniforms() noexcept
+{
+    s32 active_count = 0;
+    glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &active_count);
+    s32 max_name_length = 0;
+    glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_MAX_NAME_LENGTH, &max_name_length);
+
+    // Arrays go in by both names
+    RK_CHECK(m_uniforms.initialize(active_count * 2));
+
+    std::string name;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        name.resize(max_name_length);
+        return Status::ok;
+    }));
+    constexpr GLenum location_property = GL_LOCATION;
+    constexpr std::string_view array_suffix = "[0]";
+    for (s32 i = 0; i < active_count; ++i) {
+        // Members of uniform blocks have no location
+        s32 location = -1;
+        glGetProgramResourceiv(m_id, GL_UNIFORM, i, 1, &location_property, 1, nullptr, &location);
+        if (location < 0) { continue; }
+
+        s32 name_length = 0;
+        glGetProgramResourceName(m_id, GL_UNIFORM, i, max_name_length, &name_length, name.data());
+        std::string_view const uniform_name(name.data(), name_length);
+        RK_CHECK(m_uniforms.insert(uniform_name, location));
+
+        // Arrays are named by their first element
+        if (uniform_name.size() > array_suffix.size() &&
+            uniform_name.substr(uniform_name.size() - array_suffix.size()) == array_suffix) {
+            RK_CHECK(m_uniforms.insert(
+                uniform_name.substr(0, uniform_name.size() - array_suffix.size()), location));
+        }
+    }
+    return Status::ok;
 }
 
-void Shader_Program::set_s32(char const* name, s32 v) const noexcept {
+Uniform_Handle Shader_Program::uniform(char const* name) const noexcept
+{
     RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform1i(glGetUniformLocation(m_id, name), v);
+    RK_ASSERT(m_id != invalid_handle); // Must be compiled
+    return {m_uniforms.find(name)};
 }
 
-void Shader_Program::set_u32(char const* name, u32 v) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform1ui(glGetUniformLocation(m_id, name), v);
+void Shader_Program::set_bool(Uniform_Handle u, bool v) const noexcept
+{
+    set_s32(u, static_cast<s32>(v));
 }
 
-void Shader_Program::set_f32(char const* name, f32 v) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform1f(glGetUniformLocation(m_id, name), v);
+void Shader_Program::set_s32(Uniform_Handle u, s32 v) const noexcept
+{
+    glProgramUniform1i(m_id, u.location, v);
 }
 
-void Shader_Program::set_vec2(char const* name, f32 x, f32 y) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform2f(glGetUniformLocation(m_id, name), x, y);
+void Shader_Program::set_u32(Uniform_Handle u, u32 v) const noexcept
+{
+    glProgramUniform1ui(m_id, u.location, v);
 }
 
-void Shader_Program::set_vec2(char const* name, glm::vec2 const& v) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform2fv(glGetUniformLocation(m_id, name), 1, glm::value_ptr(v));
+void Shader_Program::set_f32(Uniform_Handle u, f32 v) const noexcept
+{
+    glProgramUniform1f(m_id, u.location, v);
 }
 
-void Shader_Program::set_vec3(char const* name, f32 x, f32 y, f32 z) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform3f(glGetUniformLocation(m_id, name), x, y, z);
+void Shader_Program::set_vec2(Uniform_Handle u, f32 x, f32 y) const noexcept
+{
+    glProgramUniform2f(m_id, u.location, x, y);
 }
 
-void Shader_Program::set_vec3(char const* name, glm::vec3 const& v) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform3fv(glGetUniformLocation(m_id, name), 1, glm::value_ptr(v));
+void Shader_Program::set_vec2(Uniform_Handle u, glm::vec2 const& v) const noexcept
+{
+    glProgramUniform2fv(m_id, u.location, 1, glm::value_ptr(v));
 }
 
-void Shader_Program::set_vec4(char const* name, f32 x, f32 y, f32 z, f32 w) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform4f(glGetUniformLocation(m_id, name), x, y, z, w);
+void Shader_Program::set_vec3(Uniform_Handle u, f32 x, f32 y, f32 z) const noexcept
+{
+    glProgramUniform3f(m_id, u.location, x, y, z);
 }
 
-void Shader_Program::set_vec4(char const* name, glm::vec4 const& v) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniform4fv(glGetUniformLocation(m_id, name), 1, glm::value_ptr(v));
+void Shader_Program::set_vec3(Uniform_Handle u, glm::vec3 const& v) const noexcept
+{
+    glProgramUniform3fv(m_id, u.location, 1, glm::value_ptr(v));
 }
 
-void Shader_Program::set_mat2(char const* name, glm::mat2 const& v) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniformMatrix2fv(glGetUniformLocation(m_id, name), 1, GL_FALSE, glm::value_ptr(v));
+void Shader_Program::set_vec4(Uniform_Handle u, f32 x, f32 y, f32 z, f32 w) const noexcept
+{
+    glProgramUniform4f(m_id, u.location, x, y, z, w);
 }
 
-void Shader_Program::set_mat3(char const* name, glm::mat3 const& v) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniformMatrix3fv(glGetUniformLocation(m_id, name), 1, GL_FALSE, glm::value_ptr(v));
+void Shader_Program::set_vec4(Uniform_Handle u, glm::vec4 const& v) const noexcept
+{
+    glProgramUniform4fv(m_id, u.location, 1, glm::value_ptr(v));
 }
 
-void Shader_Program::set_mat4(char const* name, glm::mat4 const& v) const noexcept {
-    RK_ASSERT(name);
-    RK_ASSERT(is_active());
-    glUniformMatrix4fv(glGetUniformLocation(m_id, name), 1, GL_FALSE, glm::value_ptr(v));
+void Shader_Program::set_vec4_array(Uniform_Handle u, f32 const* xyzw, s32 count) const noexcept
+{
+    RK_ASSERT(xyzw);
+    glProgramUniform4fv(m_id, u.location, count, xyzw);
+}
+
+void Shader_Program::set_mat2(Uniform_Handle u, glm::mat2 const& v) const noexcept
+{
+    glProgramUniformMatrix2fv(m_id, u.location, 1, GL_FALSE, glm::value_ptr(v));
+}
+
+void Shader_Program::set_mat3(Uniform_Handle u, glm::mat3 const& v) const noexcept
+{
+    glProgramUniformMatrix3fv(m_id, u.location, 1, GL_FALSE, glm::value_ptr(v));
+}
+
+void Shader_Program::set_mat4(Uniform_Handle u, glm::mat4 const& v) const noexcept
+{
+    glProgramUniformMatrix4fv(m_id, u.location, 1, GL_FALSE, glm::value_ptr(v));
+}
+
+void Shader_Program::set_mat4(Uniform_Handle u, Mat4 const& v) const noexcept
+{
+    glProgramUniformMatrix4fv(m_id, u.location, 1, GL_FALSE, v.data());
 }
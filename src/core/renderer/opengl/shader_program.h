@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/math/matrix.h"
+#include "core/renderer/opengl/uniform_table.h"
 #include "core/status.h"
 
 #include <glm/vec2.hpp>
@@ -11,6 +13,26 @@
 
 namespace rk
 {
+/**
+ * \brief Location of a uniform in a `Shader_Program`, looked up once with
+ * `Shader_Program::uniform`.
+ *
+ * Setting a uniform that isn't active in the program, with an invalid handle, does nothing.
+ */
+struct Uniform_Handle {
+    s32 location = -1;
+
+    [[nodiscard]] bool is_valid() const noexcept { return location >= 0; }
+};
+
+/**
+ * \brief A linked program and its uniforms.
+ *
+ * Active uniforms are found once when the program is linked. Uniforms are set with direct state
+ * access, so the program doesn't need to be in use, and each set is one GL call. Setters taking a
+ * name look it up in the program's table of uniforms on every call; draws should look up a
+ * `Uniform_Handle` once and set through it.
+ */
 class Shader_Program {
     /*
      * @optimization: Might be worth it to have all the shaders compiled and
@@ -29,6 +51,14 @@ private:
     // once we have resource ids.
     const char* m_vert_shader_path = nullptr;
     const char* m_frag_shader_path = nullptr;
+    const char* m_comp_shader_path = nullptr;
+
+    Uniform_Table m_uniforms;
+
+    /**
+     * \brief Fill the table of uniforms from the active uniforms of the linked program.
+     */
+    [[nodiscard]] Status reflect_uniforms() noexcept;
 
 public:
     static constexpr const u32 invalid_handle = 0;
@@ -38,6 +68,11 @@ public:
      */
     // TODO(sdsmith): @perf: replace with resource id
     Shader_Program(char const* vert_shader_path, char const* frag_shader_path) noexcept;
+
+    /**
+     * \brief Set the compute shader to be used with the shader program.
+     */
+    explicit Shader_Program(char const* comp_shader_path) noexcept;
     ~Shader_Program() noexcept;
 
     /**
@@ -69,21 +104,75 @@ public:
 
     /**
      * \brief Compile the shader program.
+     *
+     * With `RK_SHADER_BINARY_CACHE`, the linked program is loaded from the binary cache when the
+     * sources and driver match, and built from source and added to the cache otherwise.
      */
     [[nodiscard]] Status compile() noexcept;
 
-    void set_bool(char const* name, bool v) const noexcept;
-    void set_s32(char const* name, s32 v) const noexcept;
-    void set_u32(char const* name, u32 v) const noexcept;
-    void set_f32(char const* name, f32 v) const noexcept;
-    void set_vec2(char const* name, f32 x, f32 y) const noexcept;
-    void set_vec2(char const* name, glm::vec2 const& v) const noexcept;
-    void set_vec3(char const* name, f32 x, f32 y, f32 z) const noexcept;
-    void set_vec3(char const* name, glm::vec3 const& v) const noexcept;
-    void set_vec4(char const* name, f32 x, f32 y, f32 z, f32 w) const noexcept;
-    void set_vec4(char const* name, glm::vec4 const& v) const noexcept;
-    void set_mat2(char const* name, glm::mat2 const& v) const noexcept;
-    void set_mat3(char const* name, glm::mat3 const& v) const noexcept;
-    void set_mat4(char const* name, glm::mat4 const& v) const noexcept;
+    /**
+     * \brief Handle of the uniform \a name. Invalid if the program has no active uniform by that
+     * name. An array's handle can be found by its name with or without "[0]".
+     */
+    [[nodiscard]] Uniform_Handle uniform(char const* name) const noexcept;
+
+    /** Number of uniform names with a location, counting arrays under both names. */
+    [[nodiscard]] s32 uniform_count() const noexcept { return m_uniforms.size(); }
+
+    void set_bool(Uniform_Handle u, bool v) const noexcept;
+    void set_s32(Uniform_Handle u, s32 v) const noexcept;
+    void set_u32(Uniform_Handle u, u32 v) const noexcept;
+    void set_f32(Uniform_Handle u, f32 v) const noexcept;
+    void set_vec2(Uniform_Handle u, f32 x, f32 y) const noexcept;
+    void set_vec2(Uniform_Handle u, glm::vec2 const& v) const noexcept;
+    void set_vec3(Uniform_Handle u, f32 x, f32 y, f32 z) const noexcept;
+    void set_vec3(Uniform_Handle u, glm::vec3 const& v) const noexcept;
+    void set_vec4(Uniform_Handle u, f32 x, f32 y, f32 z, f32 w) const noexcept;
+    void set_vec4(Uniform_Handle u, glm::vec4 const& v) const noexcept;
+    /** Set \a count elements of a vec4 array from \a xyzw, four floats per element. */
+    void set_vec4_array(Uniform_Handle u, f32 const* xyzw, s32 count) const noexcept;
+    void set_mat2(Uniform_Handle u, glm::mat2 const& v) const noexcept;
+    void set_mat3(Uniform_Handle u, glm::mat3 const& v) const noexcept;
+    void set_mat4(Uniform_Handle u, glm::mat4 const& v) const noexcept;
+    void set_mat4(Uniform_Handle u, Mat4 const& v) const noexcept;
+
+    void set_bool(char const* name, bool v) const noexcept { set_bool(uniform(name), v); }
+    void set_s32(char const* name, s32 v) const noexcept { set_s32(uniform(name), v); }
+    void set_u32(char const* name, u32 v) const noexcept { set_u32(uniform(name), v); }
+    void set_f32(char const* name, f32 v) const noexcept { set_f32(uniform(name), v); }
+    void set_vec2(char const* name, f32 x, f32 y) const noexcept { set_vec2(uniform(name), x, y); }
+    void set_vec2(char const* name, glm::vec2 const& v) const noexcept
+    {
+        set_vec2(uniform(name), v);
+    }
+    void set_vec3(char const* name, f32 x, f32 y, f32 z) const noexcept
+    {
+        set_vec3(uniform(name), x, y, z);
+    }
+    void set_vec3(char const* name, glm::vec3 const& v) const noexcept
+    {
+        set_vec3(uniform(name), v);
+    }
+    void set_vec4(char const* name, f32 x, f32 y, f32 z, f32 w) const noexcept
+    {
+        set_vec4(uniform(name), x, y, z, w);
+    }
+    void set_vec4(char const* name, glm::vec4 const& v) const noexcept
+    {
+        set_vec4(uniform(name), v);
+    }
+    void set_mat2(char const* name, glm::mat2 const& v) const noexcept
+    {
+        set_mat2(uniform(name), v);
+    }
+    void set_mat3(char const* name, glm::mat3 const& v) const noexcept
+    {
+        set_mat3(uniform(name), v);
+    }
+    void set_mat4(char const* name, glm::mat4 const& v) const noexcept
+    {
+        set_mat4(uniform(name), v);
+    }
+    void set_mat4(char const* name, Mat4 const& v) const noexcept { set_mat4(uniform(name), v); }
 };
 } // namespace rk
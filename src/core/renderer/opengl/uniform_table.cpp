@@ -0,0 +1,104 @@
+#include "core/renderer/opengl/uniform_table.h"
+
+#include "core/assert.h"
+#include "core/utility/no_exception.h"
+#include <utility>
+
+using namespace rk;
+using namespace sds;
+
+/**
+ * \brief 32 bit FNV-1a hash of \a s.
+ */
+RK_INTERNAL
+u32 hash_name(std::string_view s) noexcept
+{
+    u32 hash = 2166136261u;
+    for (char c : s) {
+        hash ^= static_cast<u8>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * \brief Smallest power of two slot count that keeps \a count names at most half the slots.
+ */
+RK_INTERNAL
+size_t slot_count_for(s32 count) noexcept
+{
+    size_t slots = 8;
+    while (slots < static_cast<size_t>(count) * 2) { slots *= 2; }
+    return slots;
+}
+
+Status Uniform_Table::initialize(s32 uniform_count) noexcept
+{
+    RK_ASSERT(uniform_count >= 0);
+    clear();
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_slots.assign(slot_count_for(uniform_count), Slot{});
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+void Uniform_Table::clear() noexcept
+{
+    m_slots.clear();
+    m_names.clear();
+    m_size = 0;
+}
+
+size_t Uniform_Table::find_slot(std::string_view name, u32 hash) const noexcept
+{
+    RK_ASSERT(!m_slots.empty());
+    size_t const mask = m_slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Slot const& slot = m_slots[i];
+        if (slot.location < 0) { return i; }
+        if (slot.hash == hash &&
+            std::string_view(m_names).substr(slot.name_offset, slot.name_length) == name) {
+            return i;
+        }
+    }
+}
+
+Status Uniform_Table::insert(std::string_view name, s32 location) noexcept
+{
+    RK_ASSERT(location >= 0);
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        if (static_cast<size_t>(m_size + 1) * 2 > m_slots.size()) {
+            // Grow and put the names back
+            std::vector<Slot> old_slots(slot_count_for(m_size + 1), Slot{});
+            std::swap(old_slots, m_slots);
+            for (Slot const& slot : old_slots) {
+                if (slot.location < 0) { continue; }
+                size_t const mask = m_slots.size() - 1;
+                size_t i = slot.hash & mask;
+                while (m_slots[i].location >= 0) { i = (i + 1) & mask; }
+                m_slots[i] = slot;
+            }
+        }
+
+        u32 const hash = hash_name(name);
+        Slot& slot = m_slots[find_slot(name, hash)];
+        if (slot.location < 0) {
+            slot.hash = hash;
+            slot.name_offset = static_cast<u32>(m_names.size());
+            slot.name_length = static_cast<u32>(name.size());
+            m_names.append(name);
+            ++m_size;
+        }
+        slot.location = location;
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+s32 Uniform_Table::find(std::string_view name) const noexcept
+{
+    if (m_slots.empty()) { return -1; }
+    return m_slots[find_slot(name, hash_name(name))].location;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/status.h"
+#include "core/types.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief Uniform names of a linked program mapped to their locations.
+ *
+ * Filled once when the program is linked, so looking up a name never asks the driver. An open
+ * addressing table with linear probing over a flat array of slots, kept at most half full. Names
+ * are stored back to back in one string.
+ */
+class Uniform_Table {
+public:
+    Uniform_Table() = default;
+
+    /**
+     * \brief Empty the table and make room for \a uniform_count names.
+     */
+    [[nodiscard]] Status initialize(s32 uniform_count) noexcept;
+
+    void clear() noexcept;
+
+    /**
+     * \brief Map \a name to \a location, which must not be negative. Replaces the location of a
+     * name already in the table.
+     */
+    [[nodiscard]] Status insert(std::string_view name, s32 location) noexcept;
+
+    /**
+     * \brief Location of \a name, or -1 if it isn't in the table.
+     */
+    [[nodiscard]] s32 find(std::string_view name) const noexcept;
+
+    /** Number of names in the table. */
+    [[nodiscard]] s32 size() const noexcept { return m_size; }
+
+private:
+    struct Slot {
+        u32 hash = 0;
+        s32 location = -1; // -1 if empty
+        u32 name_offset = 0;
+        u32 name_length = 0;
+    };
+
+    /**
+     * \brief Index of the slot holding \a name, or of the empty slot it would go in.
+     */
+    [[nodiscard]] size_t find_slot(std::string_view name, u32 hash) const noexcept;
+
+    std::vector<Slot> m_slots; // power of two size
+    std::string m_names;
+    s32 m_size = 0;
+};
+} // namespace rk
@@ -0,0 +1,98 @@
+#include "core/renderer/rect_packer.h"
+
+#include "core/assert.h"
+#include "core/utility/no_exception.h"
+#include <algorithm>
+#include <limits>
+
+using namespace rk;
+using namespace sds;
+
+Status Rect_Packer::initialize(s32 width, s32 height) noexcept
+{
+    RK_ASSERT(width > 0 && height > 0);
+    m_width = width;
+    m_height = height;
+
+    // Every packed rectangle adds at most one node, and nodes are at least one unit wide
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_skyline.reserve(static_cast<size_t>(width) + 1);
+        return Status::ok;
+    }));
+
+    clear();
+    return Status::ok;
+}
+
+void Rect_Packer::clear() noexcept
+{
+    m_skyline.clear();
+    m_skyline.push_back({0, 0, m_width});
+    m_used_area = 0;
+}
+
+s32 Rect_Packer::fit_height(size_t index, s32 width) const noexcept
+{
+    if (m_skyline[index].x + width > m_width) { return -1; }
+
+    s32 y = 0;
+    s32 remaining = width;
+    for (size_t i = index; remaining > 0; ++i) {
+        RK_ASSERT(i < m_skyline.size());
+        y = std::max(y, m_skyline[i].y);
+        remaining -= m_skyline[i].width;
+    }
+    return y;
+}
+
+bool Rect_Packer::pack(s32 width, s32 height, Rect& out) noexcept
+{
+    if (width <= 0 || height <= 0 || width > m_width || height > m_height) { return false; }
+
+    // Lowest top edge wins. Nodes are visited left to right, so ties go to the leftmost position.
+    s32 best_top = std::numeric_limits<s32>::max();
+    size_t best_index = 0;
+    s32 best_y = 0;
+    for (size_t i = 0; i < m_skyline.size(); ++i) {
+        s32 const y = fit_height(i, width);
+        if (y < 0) { break; } // every node further right is past the edge as well
+        if (y + height > m_height) { continue; }
+        if (y + height < best_top) {
+            best_top = y + height;
+            best_index = i;
+            best_y = y;
+        }
+    }
+    if (best_top == std::numeric_limits<s32>::max()) { return false; }
+
+    out = {m_skyline[best_index].x, best_y, width, height};
+    m_used_area += static_cast<s64>(width) * height;
+
+    // Raise the skyline over the new rectangle and trim the nodes it covers
+    RK_ASSERT(m_skyline.size() < m_skyline.capacity());
+    m_skyline.insert(m_skyline.begin() + best_index, {out.x, best_top, width});
+    size_t const next = best_index + 1;
+    while (next < m_skyline.size()) {
+        Skyline_Node const& prev = m_skyline[next - 1];
+        Skyline_Node& node = m_skyline[next];
+        s32 const overlap = prev.x + prev.width - node.x;
+        if (overlap <= 0) { break; }
+
+        node.x += overlap;
+        node.width -= overlap;
+        if (node.width > 0) { break; }
+        m_skyline.erase(m_skyline.begin() + next);
+    }
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    return true;
+}
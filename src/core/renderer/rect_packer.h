@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/status.h"
+#include "core/types.h"
+#include <vector>
+
+namespace rk
+{
+struct Rect {
+    s32 x = 0;
+    s32 y = 0;
+    s32 width = 0;
+    s32 height = 0;
+};
+
+/**
+ * \brief Packs rectangles into a fixed size area.
+ *
+ * Uses a bottom-left skyline: the packer tracks the top edge of the packed rectangles, and each
+ * new rectangle goes in the position that keeps its top edge lowest. Good for many small
+ * rectangles of similar height, like glyphs. Rectangles can't be removed individually, only all at
+ * once with `clear`.
+ *
+ * Doesn't allocate after `initialize`.
+ */
+class Rect_Packer {
+public:
+    Rect_Packer() = default;
+
+    [[nodiscard]] Status initialize(s32 width, s32 height) noexcept;
+
+    /**
+     * \brief Remove all packed rectangles.
+     */
+    void clear() noexcept;
+
+    /**
+     * \brief Find space for a \a width by \a height rectangle.
+     *
+     * \return True and the position in \a out if it fits, false if there is no space left.
+     */
+    [[nodiscard]] bool pack(s32 width, s32 height, Rect& out) noexcept;
+
+    [[nodiscard]] s32 width() const noexcept { return m_width; }
+    [[nodiscard]] s32 height() const noexcept { return m_height; }
+
+    /**
+     * \brief Area of the packed rectangles.
+     */
+    [[nodiscard]] s64 used_area() const noexcept { return m_used_area; }
+
+private:
+    /** Horizontal segment of the skyline, covering `[x, x + width)` at height `y`. */
+    struct Skyline_Node {
+        s32 x;
+        s32 y;
+        s32 width;
+    };
+
+    /**
+     * \brief Height at which a \a width wide rectangle starting at node \a index rests.
+     *
+     * \return The height, or -1 if it extends past the right edge.
+     */
+    s32 fit_height(size_t index, s32 width) const noexcept;
+
+    s32 m_width = 0;
+    s32 m_height = 0;
+    s64 m_used_area = 0;
+    std::vector<Skyline_Node> m_skyline; // ordered by x, covers the whole width
+};
+} // namespace rk
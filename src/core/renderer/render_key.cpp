@@ -0,0 +1,105 @@
+#include "core/renderer/render_key.h"
+
+#include "core/assert.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+using namespace rk;
+using namespace sds;
+
+constexpr s32 layer_shift = 56;
+constexpr s32 blend_shift = 55;
+constexpr u64 slot_mask = max_render_key_slots - 1;
+constexpr u64 depth_mask = 0xFFFF;
+
+// Opaque draws
+constexpr s32 opaque_program_shift = 43;
+constexpr s32 opaque_texture_shift = 31;
+constexpr s32 opaque_depth_shift = 15;
+
+// Blended draws
+constexpr s32 blend_depth_shift = 39;
+constexpr s32 blend_program_shift = 27;
+constexpr s32 blend_texture_shift = 15;
+
+u64 rk::make_render_key(u8 layer, bool blend, u32 program_slot, u32 texture_slot,
+                        f32 depth) noexcept
+{
+    RK_ASSERT(program_slot < max_render_key_slots);
+    RK_ASSERT(texture_slot < max_render_key_slots);
+
+    // Written so NaN clamps to 0
+    f32 const clamped = depth > 0.0f ? std::min(depth, 1.0f) : 0.0f;
+    u64 const quantized = static_cast<u64>(clamped * static_cast<f32>(depth_mask) + 0.5f);
+    u64 const program = program_slot & slot_mask;
+    u64 const texture = texture_slot & slot_mask;
+
+    u64 key = static_cast<u64>(layer) << layer_shift;
+    if (blend) {
+        key |= u64(1) << blend_shift;
+        key |= (depth_mask - quantized) << blend_depth_shift;
+        key |= program << blend_program_shift;
+        key |= texture << blend_texture_shift;
+    } else {
+        key |= program << opaque_program_shift;
+        key |= texture << opaque_texture_shift;
+        key |= quantized << opaque_depth_shift;
+    }
+    return key;
+}
+
+void rk::radix_sort(u64* keys, u32* values, u64* scratch_keys, u32* scratch_values,
+                    s32 count) noexcept
+{
+    RK_ASSERT(count >= 0);
+    if (count < 2) { return; }
+    RK_ASSERT(keys && values && scratch_keys && scratch_values);
+
+    constexpr s32 digit_count = sizeof(u64);
+    constexpr s32 radix = 256;
+
+    // Count every digit in one pass over the keys
+    std::array<std::array<u32, radix>, digit_count> histograms = {};
+    for (s32 i = 0; i < count; ++i) {
+        u64 const key = keys[i];
+        for (s32 digit = 0; digit < digit_count; ++digit) {
+            ++histograms[digit][(key >> (digit * 8)) & 0xFF];
+        }
+    }
+
+    u64* src_keys = keys;
+    u32* src_values = values;
+    u64* dst_keys = scratch_keys;
+    u32* dst_values = scratch_values;
+    for (s32 digit = 0; digit < digit_count; ++digit) {
+        std::array<u32, radix>& histogram = histograms[digit];
+        s32 const shift = digit * 8;
+
+        // Every key has the same digit, the pass wouldn't move anything
+        if (histogram[(src_keys[0] >> shift) & 0xFF] == static_cast<u32>(count)) { continue; }
+
+        // Bucket counts to bucket offsets
+        u32 offset = 0;
+        for (u32& bucket : histogram) {
+            u32 const bucket_count = bucket;
+            bucket = offset;
+            offset += bucket_count;
+        }
+
+        for (s32 i = 0; i < count; ++i) {
+            u32 const dst = histogram[(src_keys[i] >> shift) & 0xFF]++;
+            dst_keys[dst] = src_keys[i];
+            dst_values[dst] = src_values[i];
+        }
+        std::swap(src_keys, dst_keys);
+        std::swap(src_values, dst_values);
+    }
+
+    // An odd number of passes leaves the result in the scratch space
+    if (src_keys != keys) {
+        std::memcpy(keys, src_keys, count * sizeof(u64));
+        std::memcpy(values, src_values, count * sizeof(u32));
+    }
+}
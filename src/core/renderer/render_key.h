@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/types.h"
+
+/**
+ * \file render_key.h
+ * \brief 64 bit sort keys that order draws to minimize state changes, and a radix sort for them.
+ *
+ * Key layout, most significant bits first:
+ *
+ *     opaque:  layer 8 | 0 | program 12 | texture 12 | depth 16   | unused 15
+ *     blended: layer 8 | 1 | far to near depth 16 | program 12 | texture 12 | unused 15
+ *
+ * Layers are drawn in order, opaque draws before blended ones within a layer. Opaque draws are
+ * grouped by program, then texture, then drawn near to far so early depth testing rejects hidden
+ * fragments. Blended draws must be drawn far to near to composite correctly, so depth comes before
+ * the state they use.
+ */
+
+namespace rk
+{
+/** Programs and textures are identified in keys by slots of this many bits. */
+constexpr s32 render_key_slot_bits = 12;
+constexpr u32 max_render_key_slots = 1U << render_key_slot_bits;
+
+/**
+ * \brief Sort key of a draw.
+ *
+ * \param program_slot Small id of the draw's program, in [0, `max_render_key_slots`).
+ * \param texture_slot Small id of the draw's texture, in [0, `max_render_key_slots`).
+ * \param depth Distance from the camera, in [0, 1]. Clamped.
+ */
+[[nodiscard]] u64 make_render_key(u8 layer, bool blend, u32 program_slot, u32 texture_slot,
+                                  f32 depth) noexcept;
+
+/**
+ * \brief Sort \a keys ascending, moving \a values with them. Stable.
+ *
+ * Least significant digit radix sort on bytes. Passes over bytes that are the same in every key
+ * are skipped, so keys that only use a few bits sort in a few passes.
+ *
+ * \param scratch_keys Space for \a count keys.
+ * \param scratch_values Space for \a count values.
+ */
+void radix_sort(u64* keys, u32* values, u64* scratch_keys, u32* scratch_values,
+                s32 count) noexcept;
+} // namespace rk
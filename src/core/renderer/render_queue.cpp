@@ -0,0 +1,188 @@
+#include "core/renderer/render_queue.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/renderer/render_key.h"
+#include "core/utility/no_exception.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <limits>
+
+using namespace rk;
+using namespace sds;
+
+RK_INTERNAL
+GLenum to_gl_primitive(Draw_Packet::Primitive primitive) noexcept
+{
+    switch (primitive) {
+        case Draw_Packet::Primitive::triangles: return GL_TRIANGLES;
+        case Draw_Packet::Primitive::triangle_strip: return GL_TRIANGLE_STRIP;
+        case Draw_Packet::Primitive::lines: return GL_LINES;
+    }
+    RK_ASSERT(0);
+    return GL_TRIANGLES;
+}
+
+Status Render_Command_Buffer::reserve(s32 capacity) noexcept
+{
+    RK_ASSERT(capacity >= 0);
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_commands.reserve(capacity);
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+Status Render_Command_Buffer::submit(Draw_Packet const& packet, u8 layer, f32 depth) noexcept
+{
+    RK_ASSERT(packet.program != 0 && packet.vao != 0);
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_commands.push_back({packet, depth, layer});
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+Status Render_Queue::initialize(s32 capacity) noexcept
+{
+    RK_ASSERT(capacity >= 0);
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_packets.reserve(capacity);
+        m_keys.reserve(capacity);
+        m_sorted_keys.reserve(capacity);
+        m_order.reserve(capacity);
+        m_scratch_keys.reserve(capacity);
+        m_scratch_order.reserve(capacity);
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+Status Render_Queue::destroy() noexcept
+{
+    m_packets.clear();
+    m_keys.clear();
+    m_sorted_keys.clear();
+    m_order.clear();
+    m_program_slots.clear();
+    m_texture_slots.clear();
+    return Status::ok;
+}
+
+Status Render_Queue::find_slot(std::vector<u32>& slots, u32 id, u32& out_slot) noexcept
+{
+    // A frame uses few programs and textures, and packets tend to come in runs of the same one
+    if (!slots.empty() && slots.back() == id) {
+        out_slot = static_cast<u32>(slots.size() - 1);
+        return Status::ok;
+    }
+    auto it = std::find(slots.begin(), slots.end(), id);
+    out_slot = static_cast<u32>(it - slots.begin());
+    if (it != slots.end()) { return Status::ok; }
+
+    if (out_slot == max_render_key_slots) {
+        LOG_ERROR("More than {} programs or textures queued in one frame", max_render_key_slots);
+        return Status::buffer_length_error;
+    }
+    RK_CHECK_EXB(exception_boundary([&]() {
+        slots.push_back(id);
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+Status Render_Queue::submit(Draw_Packet const& packet, u8 layer, f32 depth) noexcept
+{
+    RK_ASSERT(packet.program != 0 && packet.vao != 0);
+    if (m_packets.size() >= std::numeric_limits<u32>::max()) {
+        LOG_ERROR("Too many packets in the render queue");
+        return Status::buffer_length_error;
+    }
+
+    u32 program_slot = 0;
+    u32 texture_slot = 0;
+    RK_CHECK(find_slot(m_program_slots, packet.program, program_slot));
+    RK_CHECK(find_slot(m_texture_slots, packet.texture, texture_slot));
+
+    u64 const key = make_render_key(layer, packet.blend, program_slot, texture_slot, depth);
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_packets.push_back(packet);
+        m_keys.push_back(key);
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+Status Render_Queue::merge(Render_Command_Buffer& buffer) noexcept
+{
+    size_t const total = m_packets.size() + buffer.m_commands.size();
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_packets.reserve(total);
+        m_keys.reserve(total);
+        return Status::ok;
+    }));
+    // Keys are made here rather than while recording, the program and texture slots are shared
+    for (Render_Command_Buffer::Command const& command : buffer.m_commands) {
+        RK_CHECK(submit(command.packet, command.layer, command.depth));
+    }
+    buffer.clear();
+    return Status::ok;
+}
+
+Status Render_Queue::sort() noexcept
+{
+    s32 const num_packets = packet_count();
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_sorted_keys.assign(m_keys.begin(), m_keys.end());
+        m_order.resize(num_packets);
+        m_scratch_keys.resize(num_packets);
+        m_scratch_order.resize(num_packets);
+        return Status::ok;
+    }));
+    for (s32 i = 0; i < num_packets; ++i) { m_order[i] = static_cast<u32>(i); }
+    radix_sort(m_sorted_keys.data(), m_order.data(), m_scratch_keys.data(),
+               m_scratch_order.data(), num_packets);
+    return Status::ok;
+}
+
+Status Render_Queue::flush(Gl_State_Cache& gl_state, Render_Stats& stats) noexcept
+{
+    if (packet_count() == 0) { return Status::ok; }
+    RK_CHECK(sort());
+
+    for (u32 const index : m_order) {
+        Draw_Packet const& packet = m_packets[index];
+
+        gl_state.set_blend(packet.blend);
+        if (packet.blend) { gl_state.set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); }
+        gl_state.use_program(packet.program);
+        gl_state.bind_vertex_array(packet.vao);
+        if (packet.texture != 0) { gl_state.bind_texture(0, packet.texture); }
+        if (packet.instance_buffer != 0) {
+            glVertexArrayVertexBuffer(packet.vao, packet.instance_binding, packet.instance_buffer,
+                                      0, packet.instance_stride);
+            ++stats.gl_calls;
+        }
+
+        GLenum const mode = to_gl_primitive(packet.primitive);
+        if (packet.index_type == Draw_Packet::Index_Type::none) {
+            glDrawArraysInstancedBaseInstance(mode, packet.first, packet.count,
+                                              packet.instance_count, packet.base_instance);
+        } else {
+            bool const u16_indices = packet.index_type == Draw_Packet::Index_Type::u16;
+            size_t const index_offset = packet.first * (u16_indices ? sizeof(u16) : sizeof(u32));
+            glDrawElementsInstancedBaseVertexBaseInstance(
+                mode, packet.count, u16_indices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                reinterpret_cast<void const*>(index_offset), packet.instance_count,
+                packet.base_vertex, packet.base_instance);
+        }
+        ++stats.gl_calls;
+        ++stats.draw_calls;
+    }
+
+    m_packets.clear();
+    m_keys.clear();
+    m_program_slots.clear();
+    m_texture_slots.clear();
+    return Status::ok;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "core/renderer/gl_state_cache.h"
+#include "core/renderer/render_stats.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief Everything needed to issue one draw call, without knowing the GL state it's drawn in.
+ */
+struct Draw_Packet {
+    enum class Primitive : u8 { triangles, triangle_strip, lines };
+    enum class Index_Type : u8 { none, u16, u32 };
+
+    u32 program = 0;  //!< `Shader_Program::handle`
+    u32 vao = 0;      //!< Vertex array with the vertex attributes, and index buffer if indexed
+    u32 texture = 0;  //!< Bound to texture unit 0, if not 0
+    /** Bound to the vertex array at `instance_binding` before drawing, if not 0. */
+    u32 instance_buffer = 0;
+    u32 instance_binding = 0;
+    u32 instance_stride = 0;
+    s32 count = 0;         //!< Indices, or vertices if not indexed
+    u32 first = 0;         //!< First index, or first vertex if not indexed
+    s32 base_vertex = 0;   //!< Added to every index
+    s32 instance_count = 1;
+    u32 base_instance = 0;
+    Primitive primitive = Primitive::triangles;
+    Index_Type index_type = Index_Type::none;
+    /** Alpha blended. Drawn far to near after the opaque draws of its layer. */
+    bool blend = false;
+};
+
+/**
+ * \brief Draw packets recorded by one thread, to be merged into a `Render_Queue`.
+ *
+ * Recording makes no GL calls and touches no shared state, so worker threads can each record into
+ * their own buffer concurrently while building the frame's draws. The buffers are merged into the
+ * queue on the thread that owns the GL context. The buffer keeps its memory between frames.
+ */
+class Render_Command_Buffer {
+public:
+    Render_Command_Buffer() = default;
+
+    /**
+     * \brief Reserve space for \a capacity packets. The buffer grows past it as needed.
+     */
+    [[nodiscard]] Status reserve(s32 capacity) noexcept;
+
+    /**
+     * \brief Record \a packet. Same as `Render_Queue::submit`, but drawn once the buffer is merged.
+     */
+    [[nodiscard]] Status submit(Draw_Packet const& packet, u8 layer, f32 depth) noexcept;
+
+    void clear() noexcept { m_commands.clear(); }
+
+    [[nodiscard]] s32 packet_count() const noexcept
+    {
+        return static_cast<s32>(m_commands.size());
+    }
+
+private:
+    friend class Render_Queue;
+
+    struct Command {
+        Draw_Packet packet;
+        f32 depth;
+        u8 layer;
+    };
+    std::vector<Command> m_commands; // in recording order
+};
+
+/**
+ * \brief Draws submitted from anywhere during a frame, sorted and drawn together.
+ *
+ * Each submitted packet gets a 64 bit sort key from its layer, blending, program, texture and
+ * depth (see "render_key.h"). `flush` radix sorts the keys and draws the packets in key order
+ * through the `Gl_State_Cache`, so draws with the same state are adjacent and the state is set once
+ * per run instead of once per draw. Callers don't need to know what's bound.
+ *
+ * Packets with equal keys are drawn in the order they were submitted.
+ *
+ * Not thread safe. Threads record into their own `Render_Command_Buffer`, which are merged on the
+ * thread that owns the GL context.
+ *
+ * Per frame uniforms must be set on the programs before `flush`. Per draw data goes in vertex or
+ * instance attributes.
+ */
+class Render_Queue {
+public:
+    Render_Queue() = default;
+
+    /**
+     * \param capacity Packets to reserve space for. The queue grows past it as needed.
+     */
+    [[nodiscard]] Status initialize(s32 capacity) noexcept;
+    Status destroy() noexcept;
+
+    /**
+     * \brief Queue \a packet to be drawn by the next `flush`.
+     *
+     * \param layer Lower layers are drawn first.
+     * \param depth Distance from the camera, in [0, 1]. Orders draws within a layer.
+     * \return `buffer_length_error` if the frame has too many distinct programs or textures for
+     * the sort key.
+     */
+    [[nodiscard]] Status submit(Draw_Packet const& packet, u8 layer, f32 depth) noexcept;
+
+    /**
+     * \brief Queue the packets recorded in \a buffer, as if submitted in the order they were
+     * recorded, and clear it.
+     *
+     * Merge the buffers of a frame in a fixed order, so packets with equal keys are drawn in the
+     * same order every frame no matter how the recording threads were scheduled.
+     */
+    [[nodiscard]] Status merge(Render_Command_Buffer& buffer) noexcept;
+
+    /**
+     * \brief Sort and draw the queued packets, and empty the queue.
+     */
+    [[nodiscard]] Status flush(Gl_State_Cache& gl_state, Render_Stats& stats) noexcept;
+
+    [[nodiscard]] s32 packet_count() const noexcept { return static_cast<s32>(m_packets.size()); }
+
+    /** Queued packets, in submission order. */
+    [[nodiscard]] std::vector<Draw_Packet> const& packets() const noexcept { return m_packets; }
+
+    /**
+     * \brief Sort the queued packets by key into `draw_order`. Done by `flush`. The packets and
+     * their keys stay in submission order, so sorting again gives the same order.
+     */
+    [[nodiscard]] Status sort() noexcept;
+
+    /** Indices into `packets` in the order they're drawn, as of the last `sort`. */
+    [[nodiscard]] std::vector<u32> const& draw_order() const noexcept { return m_order; }
+
+private:
+    /**
+     * \brief Slot of \a id in \a slots, added if it's not there.
+     */
+    [[nodiscard]] static Status find_slot(std::vector<u32>& slots, u32 id, u32& out_slot) noexcept;
+
+    std::vector<Draw_Packet> m_packets; // in submission order
+    std::vector<u64> m_keys;            // sort key of each packet, in submission order
+    std::vector<u64> m_sorted_keys;     // copy of the keys sorted by `sort`
+    std::vector<u32> m_order;           // packet indices, sorted with the keys
+    std::vector<u64> m_scratch_keys;
+    std::vector<u32> m_scratch_order;
+
+    // Programs and textures of the queued packets, indexed by their slot in the sort keys
+    std::vector<u32> m_program_slots;
+    std::vector<u32> m_texture_slots;
+};
+} // namespace rk
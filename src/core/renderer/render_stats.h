@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/types.h"
+
+namespace rk
+{
+/**
+ * \brief Counters for the work the renderer submits to the graphics API.
+ *
+ * Counted by the renderer as it issues calls, so only the renderer's own paths are included.
+ * Reset by the owner, typically once per frame.
+ */
+struct Render_Stats {
+    u32 gl_calls = 0;       //!< All GL calls, including those counted below
+    u32 draw_calls = 0;     //!< glDraw*
+    u32 texture_binds = 0;  //!< glBindTexture and glBindTextureUnit
+    u32 buffer_uploads = 0; //!< glBufferData and glBufferSubData
+    u32 glyphs = 0;         //!< Glyph quads drawn
+    u32 sprites = 0;        //!< Sprite instances drawn
+    u32 instances = 0;      //!< Mesh instances drawn
+    u32 stream_bytes = 0;   //!< Bytes written to the persistently mapped stream buffer
+    /** Redundant state changes filtered out by `Gl_State_Cache`, not in `gl_calls`. */
+    u32 gl_calls_skipped = 0;
+};
+} // namespace rk
@@ -2,18 +2,22 @@
 
 #include "core/assert.h"
 #include "core/logging/logging.h"
+#include "core/platform/filesystem.h"
 #include "core/platform/glfw.h"
+#include "core/platform/unicode.h"
+#include "core/renderer/baked_font.h"
 #include "core/types.h"
 #include "core/utility/fixme.h"
+#include "core/utility/no_exception.h"
 #include <fmt/core.h>
 #include <glad/glad.h>
 #include <sds/string.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstring>
 #include <iterator>
 
-#include <ft2build.h>
-#include FT_FREETYPE_H
-
 #include <glm/gtc/matrix_transform.hpp>
 
 // Ask for a high performance renderer
@@ -22,18 +26,53 @@
 using namespace rk;
 using namespace sds;
 
-Global_Renderer_State rk::g_renderer_state = {};
+/** Framebuffer size of the last resize not yet applied by `begin_frame`, packed, or 0. */
+RK_INTERNAL std::atomic<u64> g_pending_viewport{0};
+
+constexpr s32 vertices_per_glyph = 4;
+constexpr s32 indices_per_glyph = 6;
 
 Status Renderer::initialize(Config config) noexcept {
+    if (config.text_batch_capacity <= 0 || config.text_batch_capacity > max_text_batch_capacity) {
+        LOG_ERROR("Text batch capacity must be in [1, {}], got {}", max_text_batch_capacity,
+                  config.text_batch_capacity);
+        return Status::invalid_value;
+    }
+    if (config.stream_buffer_frame_size == 0) {
+        LOG_ERROR("Stream buffer frame size must not be 0");
+        return Status::invalid_value;
+    }
+    if (config.sprite_batch_capacity < 0) {
+        LOG_ERROR("Sprite batch capacity must not be negative, got {}",
+                  config.sprite_batch_capacity);
+        return Status::invalid_value;
+    }
+    if (config.render_queue_capacity < 0) {
+        LOG_ERROR("Render queue capacity must not be negative, got {}",
+                  config.render_queue_capacity);
+        return Status::invalid_value;
+    }
+
     m_config = config;
     return Status::ok;
 }
 
 Status Renderer::destroy() noexcept {
     glDeleteVertexArrays(1, &m_text_vao);
-    glDeleteBuffers(1, &m_text_vbo);
-
-    // TODO: cleanup glyphs?
+    glDeleteBuffers(1, &m_text_ebo);
+    RK_CHECK(m_glyph_cache.destroy());
+    RK_CHECK(m_sprite_batch.destroy());
+    RK_CHECK(m_render_queue.destroy());
+    RK_CHECK(m_gpu_profiler.destroy());
+    RK_CHECK(m_frame_pacer.destroy());
+    glDeleteBuffers(1, &m_frame_uniform_buffer);
+    m_frame_uniform_buffer = 0;
+    glDeleteFramebuffers(1, &m_headless_fbo);
+    std::array<u32, 2> const renderbuffers = {m_headless_color, m_headless_depth};
+    glDeleteRenderbuffers(static_cast<s32>(renderbuffers.size()), renderbuffers.data());
+    m_headless_fbo = m_headless_color = m_headless_depth = 0;
+    RK_CHECK(m_stream_buffer.destroy());
+    m_gl_state.invalidate();
 
     return Status::ok;
 }
@@ -45,6 +84,7 @@ Status Renderer::prepare_window() noexcept
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT,
         (m_config.enable_debug ? GLFW_TRUE : GLFW_FALSE));
+    if (m_config.headless) { glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE); }
 
     return platform::glfw::handle_error();
 }
@@ -228,11 +268,14 @@ Status Renderer::setup_gl_api() noexcept
         RK_CHECK(handle_ogl_error());
     }
 
+    // Nothing is known about the state of a new context
+    m_gl_state.invalidate();
+
     // Explicitly set counter-clockwise winding order
     glFrontFace(GL_CCW);
 
     // Enable face culling
-    glEnable(GL_CULL_FACE);
+    m_gl_state.set_cull_face(true);
     glCullFace(GL_BACK);
 
     LOG_INFO(
@@ -240,25 +283,155 @@ Status Renderer::setup_gl_api() noexcept
         "  Debug: {}",
         sds::to_string(is_ogl_debug_ctx));
 
-    s32 window_w = 0;
-    s32 window_h = 0;
-    RK_CHECK(m_window->get_window_size(window_w, window_h));
-    glViewport(0, 0, window_w, window_h);
+    s32 framebuffer_w = 0;
+    s32 framebuffer_h = 0;
+    RK_CHECK(m_window->get_framebuffer_size(framebuffer_w, framebuffer_h));
+    glCreateBuffers(1, &m_frame_uniform_buffer);
+    glNamedBufferStorage(m_frame_uniform_buffer, sizeof(Frame_Uniforms), nullptr,
+                         GL_DYNAMIC_STORAGE_BIT);
+    glBindBufferBase(GL_UNIFORM_BUFFER, frame_uniforms_binding, m_frame_uniform_buffer);
+    set_viewport(framebuffer_w, framebuffer_h);
+    if (m_config.headless) { RK_CHECK(create_headless_target(framebuffer_w, framebuffer_h)); }
+
+    RK_CHECK(m_stream_buffer.initialize(m_config.stream_buffer_frame_size));
+    RK_CHECK(m_sprite_batch.initialize(m_config.sprite_batch_capacity,
+                                       m_stream_buffer.buffer_id()));
+    RK_CHECK(m_render_queue.initialize(m_config.render_queue_capacity));
+    RK_CHECK(m_gpu_profiler.initialize(m_config.gpu_profiler));
+    RK_CHECK(set_vsync(m_config.vsync));
+    RK_CHECK(m_frame_pacer.initialize(m_config.frame_pacing));
 
     LOG_INFO("OpenGL context initialized");
     return Status::ok;
 }
 
-void Renderer::draw_wireframe(bool enable) const noexcept
+void Renderer::set_viewport(s32 width, s32 height) noexcept
 {
-    if (enable) {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    } else {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glViewport(0, 0, width, height);
+    m_frame_uniforms.screen_projection =
+        Mat4::orthographic(0.0f, static_cast<f32>(width), 0.0f, static_cast<f32>(height));
+    m_frame_uniforms.viewport = {static_cast<f32>(width), static_cast<f32>(height),
+                                 1.0f / std::max(width, 1), 1.0f / std::max(height, 1)};
+    m_frame_uniforms_dirty = true;
+}
+
+void Renderer::set_view_projection(Mat4 const& view_projection) noexcept
+{
+    m_frame_uniforms.view_projection = view_projection;
+    m_frame_uniforms_dirty = true;
+}
+
+void Renderer::draw_wireframe(bool enable) noexcept
+{
+    m_gl_state.set_polygon_mode(enable ? GL_LINE : GL_FILL);
+}
+
+Status Renderer::begin_frame() noexcept
+{
+    if (u64 const size = g_pending_viewport.exchange(0); size != 0) {
+        set_viewport(static_cast<s32>(size >> 32), static_cast<s32>(size & 0xFFFFFFFF));
+    }
+    if (m_frame_uniforms_dirty) {
+        glNamedBufferSubData(m_frame_uniform_buffer, 0, sizeof(Frame_Uniforms), &m_frame_uniforms);
+        m_frame_uniforms_dirty = false;
+        ++m_stats.gl_calls;
+        ++m_stats.buffer_uploads;
+    }
+    return Status::ok;
+}
+
+Status Renderer::end_frame() noexcept
+{
+    RK_CHECK(m_gpu_profiler.end_frame());
+    // Glyphs drawn this frame, queued or laid out, no longer hold on to their atlas pages
+    m_glyph_cache.end_batch();
+    return m_stream_buffer.end_frame();
+}
+
+Status Renderer::swap_buffers() noexcept
+{
+    RK_CHECK(end_frame());
+    m_frame_pacer.wait_for_present();
+    // Nothing to present in headless mode, frames are read back instead
+    if (!m_config.headless) { RK_CHECK(m_window->swap_buffers()); }
+    return m_frame_pacer.end_present();
+}
+
+Status Renderer::create_headless_target(s32 width, s32 height) noexcept
+{
+    // A hidden window's default framebuffer fails the pixel ownership test, so its contents are
+    // undefined. Render into our own instead.
+    glCreateRenderbuffers(1, &m_headless_color);
+    glNamedRenderbufferStorage(m_headless_color, GL_RGBA8, width, height);
+    glCreateRenderbuffers(1, &m_headless_depth);
+    glNamedRenderbufferStorage(m_headless_depth, GL_DEPTH24_STENCIL8, width, height);
+
+    glCreateFramebuffers(1, &m_headless_fbo);
+    glNamedFramebufferRenderbuffer(m_headless_fbo, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                                   m_headless_color);
+    glNamedFramebufferRenderbuffer(m_headless_fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                                   m_headless_depth);
+    GLenum const status = glCheckNamedFramebufferStatus(m_headless_fbo, GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_ERROR("Headless framebuffer is incomplete: {:#x}", status);
+        return Status::renderer_error;
+    }
+
+    // Left bound, everything draws into it
+    glBindFramebuffer(GL_FRAMEBUFFER, m_headless_fbo);
+    m_headless_width = width;
+    m_headless_height = height;
+    LOG_INFO("Rendering headless into a {}x{} framebuffer", width, height);
+    return Status::ok;
+}
+
+Status Renderer::read_frame(std::vector<u8>& out_rgba, s32& out_width, s32& out_height) noexcept
+{
+    s32 width = m_headless_width;
+    s32 height = m_headless_height;
+    if (!m_config.headless) { RK_CHECK(m_window->get_framebuffer_size(width, height)); }
+
+    size_t const row_size = static_cast<size_t>(width) * 4;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        out_rgba.resize(row_size * height);
+        return Status::ok;
+    }));
+
+    // Rows of RGBA8 are always 4 byte aligned, the default pack alignment
+    glReadBuffer(m_config.headless ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, out_rgba.data());
+    RK_CHECK(handle_ogl_error());
+
+    // GL rows go from bottom to top
+    for (s32 y = 0; y < height / 2; ++y) {
+        std::swap_ranges(out_rgba.begin() + y * row_size, out_rgba.begin() + (y + 1) * row_size,
+                         out_rgba.begin() + (height - 1 - y) * row_size);
     }
+    out_width = width;
+    out_height = height;
+    return Status::ok;
 }
 
-Status Renderer::swap_buffers() const noexcept { return m_window->swap_buffers(); }
+Status Renderer::set_vsync(Vsync vsync) noexcept
+{
+    s32 interval = 0;
+    switch (vsync) {
+        case Vsync::off: interval = 0; break;
+        case Vsync::on: interval = 1; break;
+        case Vsync::adaptive:
+            // A negative interval swaps late frames immediately
+            if (glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+                interval = -1;
+            } else {
+                LOG_WARN("Adaptive vsync is not supported, using vsync");
+                interval = 1;
+            }
+            break;
+    }
+    glfwSwapInterval(interval);
+    return platform::glfw::handle_error();
+}
 
 /**
  * \brief Window resize callback function.
@@ -268,10 +441,8 @@ void framebuffer_size_callback(GLFWwindow* window, s32 width, s32 height) noexce
 {
     RK_ASSERT(window);
     LOG_INFO("Window resized to width: {}, height: {} - adjusting viewport", width, height);
-    glViewport(0, 0, width, height);
-
-    // Update the ortho_projection
-    g_renderer_state.screen_ortho_projection = glm::ortho(0.0f, static_cast<f32>(width), 0.0f, static_cast<f32>(height));
+    // Applied on the thread that owns the context, which may not be the one polling events
+    g_pending_viewport.store((static_cast<u64>(width) << 32) | static_cast<u32>(height));
 }
 
 GLFWframebuffersizefun Renderer::get_framebuffer_size_callback() const noexcept
@@ -280,175 +451,354 @@ GLFWframebuffersizefun Renderer::get_framebuffer_size_callback() const noexcept
 }
 
 Status Renderer::load_font_glyphs() noexcept {
-    // TODO: update to take font param. Will need a charcode map per active font
-#define RK_FT_SAME_AS_OTHER_DIM 0
-    FT_Library ft;
-    FT_Error err = FT_Init_FreeType(&ft);
-    if (err) {
-        LOG_ERROR("Failed to initialize FreeType: {}", FT_Error_String(err));
-        return Status::api_error;
-    }
+    RK_CHECK(m_glyph_cache.initialize({}));
 
-    FT_Face face;
     // TODO: update to rk::filesystem path API
     std::string font_path = fmt::format("{}/{}", RK_DATA_BASE_DIR, "assets/fonts/calibri/calibri-regular.ttf");
-    err = FT_New_Face(ft, font_path.c_str(), 0, &face);
-    if (err) {
-        LOG_ERROR("Failed to load font face ({}): {}", font_path.c_str(), FT_Error_String(err));
-        return Status::io_error;
+
+    bool baked = false;
+#ifdef RK_BAKED_FONT_DIR
+    std::string const baked_path =
+        fmt::format("{}/calibri-regular-{}{}.rkfont", RK_BAKED_FONT_DIR,
+                    m_config.text_render_mode == Glyph_Cache::Render_Mode::sdf ? "sdf" : "bitmap",
+                    glyph_pixel_size());
+    baked = (load_baked_font(baked_path.c_str(), font_path.c_str()) == Status::ok);
+#endif
+
+    if (!baked) {
+        RK_CHECK(m_glyph_cache.load_font(font_path.c_str(), m_font));
+
+        // Other glyphs are rasterized when first drawn. Preload printable ASCII, which nearly all
+        // text uses, so it doesn't stall the first frames.
+        for (u32 codepoint = 0x20; codepoint < 0x7F; ++codepoint) {
+            Glyph_Cache::Glyph glyph;
+            RK_CHECK(m_glyph_cache.get(m_font, glyph_pixel_size(), codepoint,
+                                       m_config.text_render_mode, glyph));
+        }
+        m_glyph_cache.end_batch();
     }
 
-    // Set charmap encoding
-    const FT_Encoding encoding = FT_ENCODING_UNICODE;
-    err = FT_Select_Charmap(face, encoding);
-    if (err) {
-        LOG_ERROR("Failed to select encoding for '{}': {}", font_path, FT_Error_String(err));
-        return Status::api_error;
+    // Create the text batch buffers. Each glyph is a quad of 4 vertices drawn as 2 triangles. The
+    // index pattern never changes, so the index buffer is filled once.
+    s32 const capacity = m_config.text_batch_capacity;
+    std::vector<u16> indices;
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_text_vertices.reserve(capacity * vertices_per_glyph);
+        m_text_textures.reserve(capacity);
+        indices.reserve(capacity * indices_per_glyph);
+        return Status::ok;
+    }));
+    for (s32 glyph = 0; glyph < capacity; ++glyph) {
+        u16 const first = static_cast<u16>(glyph * vertices_per_glyph);
+        for (u16 i : {0, 1, 2, 0, 2, 3}) { indices.push_back(static_cast<u16>(first + i)); }
     }
 
-    // NOTE: char heights and widths are specified in 1/64 of a point. A point is a physical distance equal to 1/72 of an inch.
-
-#if 0
-    err = FT_Set_Char_Size(
-        face,
-        RK_FT_SAME_AS_OTHER_DIM, // char_width in 1/64 of points
-        16*64, // char_height in 1/64 of points
-        window_w, // horizontal device resolution
-        window_h // vertical device resolution
-    );
-    if (err) {
-        LOG_ERROR("Failed to set font glyph character size for '{}': {}", font_path, FT_Error_String(err));
-        return Status::api_error;
+    // Vertices are written to the stream buffer and addressed with a base vertex
+    glCreateBuffers(1, &m_text_ebo);
+    glNamedBufferData(m_text_ebo, indices.size() * sizeof(u16), indices.data(), GL_STATIC_DRAW);
+    glCreateVertexArrays(1, &m_text_vao);
+    setup_text_vertex_array(m_text_vao, m_stream_buffer.buffer_id());
+
+    return Status::ok;
+}
+
+Status Renderer::load_baked_font(char const* baked_path, char const* font_path) noexcept
+{
+    bool exists = false;
+    RK_CHECK(fs::file_exists(baked_path, exists));
+    if (!exists) {
+        LOG_INFO("No baked font at '{}', rasterizing glyphs at runtime", baked_path);
+        return Status::io_error;
     }
-#else
-    err = FT_Set_Pixel_Sizes(
-        face,
-        RK_FT_SAME_AS_OTHER_DIM, // pixel width
-        64 // pixel height
-    );
-    if (err) {
-        LOG_ERROR("Failed to set font glyph pixel size for '{}': {}", font_path, FT_Error_String(err));
-        return Status::api_error;
+
+    // Only needed until the atlas is uploaded and the glyph metrics are copied
+    fs::Mapped_File file;
+    RK_CHECK(file.open(baked_path));
+    Baked_Font baked;
+    RK_CHECK(parse_baked_font(file.data(), file.size(), baked));
+
+    Glyph_Cache::Render_Mode const mode =
+        static_cast<Glyph_Cache::Render_Mode>(baked.header->render_mode);
+    if (mode != m_config.text_render_mode ||
+        static_cast<s32>(baked.header->pixel_size) != glyph_pixel_size()) {
+        LOG_WARN("Baked font '{}' doesn't match the text render mode and size", baked_path);
+        return Status::invalid_value;
     }
-#endif
-#undef RK_FT_SAME_AS_OTHER_DIM
-
-    // Cache the 128 ASCII characters
-    //
-    // NOTE: The glyph is a grayscale 8-bit image with a single byte per color. Disable OGL 32-bit alignment requirement so we can maintain one byte per color.
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    for (u32 charcode = 0; charcode < 128; ++charcode) {
-        err = FT_Load_Char(face, charcode, FT_LOAD_RENDER);
-        if (err) {
-            LOG_ERROR("Failed to load glyph for character code '{}'", charcode);
-            continue;
+
+    RK_CHECK(m_glyph_cache.load_baked_font(baked, font_path, m_font));
+    LOG_INFO("Loaded {} baked glyphs from '{}'", baked.header->glyph_count, baked_path);
+    return Status::ok;
+}
+
+void Renderer::setup_text_vertex_array(u32 vao, u32 vbo) const noexcept
+{
+    // Also called mid frame by `layout_text`, with the text draw state possibly bound
+    glVertexArrayVertexBuffer(vao, 0, vbo, 0, sizeof(Text_Vertex));
+    glVertexArrayElementBuffer(vao, m_text_ebo);
+    // vec4: vec2 pos, vec2 tex
+    glEnableVertexArrayAttrib(vao, 0);
+    glVertexArrayAttribFormat(vao, 0, 4, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(vao, 0, 0);
+    // vec4 color, normalized from bytes
+    glEnableVertexArrayAttrib(vao, 1);
+    glVertexArrayAttribFormat(vao, 1, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(Text_Vertex, color));
+    glVertexArrayAttribBinding(vao, 1, 0);
+}
+
+char const* Renderer::text_fragment_shader() const noexcept
+{
+    switch (m_config.text_render_mode) {
+        case Glyph_Cache::Render_Mode::bitmap: return "font_glyphs.frag";
+        case Glyph_Cache::Render_Mode::sdf: return "font_glyphs_sdf.frag";
+    }
+    RK_ASSERT(0);
+    return "font_glyphs.frag";
+}
+
+s32 Renderer::glyph_pixel_size() const noexcept
+{
+    return m_config.text_render_mode == Glyph_Cache::Render_Mode::sdf ? m_sdf_glyph_pixel_size
+                                                                      : m_bitmap_glyph_pixel_size;
+}
+
+/**
+ * \brief Convert a [0, 1] color channel to a byte.
+ */
+RK_INTERNAL
+u8 to_unorm8(f32 v) noexcept
+{
+    return static_cast<u8>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+Status Renderer::queue_text(std::string_view text, f32 screen_pos_x, f32 screen_pos_y, f32 scale,
+                            glm::vec3 color) noexcept
+{
+    return append_text_quads(text, screen_pos_x, screen_pos_y, scale, color, m_text_vertices,
+                             m_text_textures);
+}
+
+Status Renderer::append_text_quads(std::string_view text, f32 screen_pos_x, f32 screen_pos_y,
+                                   f32 scale, glm::vec3 color, std::vector<Text_Vertex>& vertices,
+                                   std::vector<u32>& textures) noexcept
+{
+    std::array<u8, 4> const rgba = {to_unorm8(color.x), to_unorm8(color.y), to_unorm8(color.z),
+                                    255};
+    // Glyph metrics are at the rasterized size, scale is relative to the text size
+    s32 const pixel_size = glyph_pixel_size();
+    scale *= static_cast<f32>(m_text_pixel_size) / static_cast<f32>(pixel_size);
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        size_t pos = 0;
+        while (pos < text.size()) {
+            u32 const codepoint = unicode::decode_utf8(text, pos);
+            Glyph_Cache::Glyph ch;
+            if (m_glyph_cache.get(m_font, pixel_size, codepoint, m_config.text_render_mode, ch) !=
+                Status::ok) {
+                // Logged by the cache. Skip the glyph rather than dropping the whole string.
+                continue;
+            }
+
+            f32 const pos_x = screen_pos_x + ch.bearing.x * scale;
+            f32 const pos_y = screen_pos_y - (ch.size.y - ch.bearing.y) * scale;
+            f32 const w = ch.size.x * scale;
+            f32 const h = ch.size.y * scale;
+
+            if (ch.size.x > 0 && ch.size.y > 0) {
+                // Counter-clockwise from the top left, matching the index pattern
+                glm::vec2 const uv0 = ch.uv_min;
+                glm::vec2 const uv1 = ch.uv_max;
+                vertices.push_back({pos_x, pos_y + h, uv0.x, uv0.y, rgba});
+                vertices.push_back({pos_x, pos_y, uv0.x, uv1.y, rgba});
+                vertices.push_back({pos_x + w, pos_y, uv1.x, uv1.y, rgba});
+                vertices.push_back({pos_x + w, pos_y + h, uv1.x, uv0.y, rgba});
+                textures.push_back(ch.texture_id);
+            }
+
+            // advance cursor for next glyph
+            // NOTE: advance is number of 1/64 points
+            //  bitshift >> 6 => 2^6 = 64
+            screen_pos_x += (ch.advance >> 6) * scale;
         }
+        return Status::ok;
+    }));
+
+    return Status::ok;
+}
+
+void Renderer::begin_text_draw(Shader_Program const& shader, u32 vao) noexcept
+{
+    m_gl_state.set_blend(true);
+    m_gl_state.set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_gl_state.use_program(shader.handle());
+    m_gl_state.bind_vertex_array(vao);
+}
 
-        u32 texture = 0;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        Character c{
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
-        };
-        m_characters[charcode] = c;
+Status Renderer::flush_text(Shader_Program& shader) noexcept
+{
+    s32 const num_glyphs = static_cast<s32>(m_text_textures.size());
+    if (num_glyphs == 0) { return Status::ok; }
+    RK_ASSERT(m_text_vertices.size() == static_cast<size_t>(num_glyphs * vertices_per_glyph));
+
+    begin_text_draw(shader, m_text_vao);
+
+    // Write as many glyphs as the index buffer covers, then draw each run of glyphs on the same
+    // atlas page with one call. Typically all glyphs are on one page.
+    s32 const capacity = m_config.text_batch_capacity;
+    for (s32 batch_begin = 0; batch_begin < num_glyphs; batch_begin += capacity) {
+        s32 const batch_size = std::min(capacity, num_glyphs - batch_begin);
+        u32 const batch_bytes = batch_size * vertices_per_glyph * sizeof(Text_Vertex);
+        Stream_Buffer::Allocation alloc;
+        RK_CHECK(m_stream_buffer.allocate(batch_bytes, sizeof(Text_Vertex), alloc));
+        std::memcpy(alloc.data, &m_text_vertices[batch_begin * vertices_per_glyph], batch_bytes);
+        m_stats.stream_bytes += batch_bytes;
+        s32 const base_vertex = static_cast<s32>(alloc.offset / sizeof(Text_Vertex));
+
+        u32 const* textures = &m_text_textures[batch_begin];
+        s32 run_begin = 0;
+        while (run_begin < batch_size) {
+            s32 run_end = run_begin + 1;
+            while (run_end < batch_size && textures[run_end] == textures[run_begin]) { ++run_end; }
+
+            m_gl_state.bind_texture(0, textures[run_begin]);
+
+            size_t const index_offset = run_begin * indices_per_glyph * sizeof(u16);
+            glDrawElementsBaseVertex(GL_TRIANGLES, (run_end - run_begin) * indices_per_glyph,
+                                     GL_UNSIGNED_SHORT, reinterpret_cast<void const*>(index_offset),
+                                     base_vertex);
+            ++m_stats.gl_calls;
+            ++m_stats.draw_calls;
+
+            run_begin = run_end;
+        }
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-
-    // Create text quad buffer
-    glGenVertexArrays(1, &m_text_vao);
-    glGenBuffers(1, &m_text_vbo);
-    glBindVertexArray(m_text_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_text_vbo);
-    // 6 verts in quad, 4 floats each
-    // dynamic draw - will be changing buffer content often
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
 
+    m_stats.glyphs += static_cast<u32>(num_glyphs);
+
+    m_text_vertices.clear();
+    m_text_textures.clear();
+    // The queued glyphs are drawn, their atlas pages can be reused
+    m_glyph_cache.end_batch();
     return Status::ok;
 }
 
-Status Renderer::render_text(Shader_Program& shader, std::string_view text, f32 screen_pos_x, f32 screen_pos_y, f32 scale, glm::vec3 color) const noexcept {
-    RK_ASSERT(!m_characters.empty());
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+Status Renderer::render_text(Shader_Program& shader, std::string_view text, f32 screen_pos_x, f32 screen_pos_y, f32 scale, glm::vec3 color) noexcept {
+    RK_CHECK(queue_text(text, screen_pos_x, screen_pos_y, scale, color));
+    return flush_text(shader);
+}
 
-    shader.use();
-    shader.set_vec3("text_color", color);
+Status Renderer::layout_text(Text_Layout& layout, std::string_view text, f32 screen_pos_x,
+                             f32 screen_pos_y, f32 scale, glm::vec3 color) noexcept
+{
+    bool const unchanged = layout.m_laid_out && layout.m_text == text &&
+                           layout.m_screen_pos_x == screen_pos_x &&
+                           layout.m_screen_pos_y == screen_pos_y && layout.m_scale == scale &&
+                           layout.m_color == color && layout.m_font == m_font &&
+                           layout.m_atlas_evictions == m_glyph_cache.eviction_count();
+    if (unchanged) { return Status::ok; }
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        layout.m_text = text;
+        return Status::ok;
+    }));
+    layout.m_screen_pos_x = screen_pos_x;
+    layout.m_screen_pos_y = screen_pos_y;
+    layout.m_scale = scale;
+    layout.m_color = color;
+    layout.m_font = m_font;
+    // Laid out again by the next call if building fails
+    layout.m_laid_out = false;
+    return build_text_layout(layout);
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(m_text_vao);
+Status Renderer::build_text_layout(Text_Layout& layout) noexcept
+{
+    m_layout_vertices.clear();
+    m_layout_textures.clear();
+    RK_CHECK(append_text_quads(layout.m_text, layout.m_screen_pos_x, layout.m_screen_pos_y,
+                               layout.m_scale, layout.m_color, m_layout_vertices,
+                               m_layout_textures));
+    s32 const num_glyphs = static_cast<s32>(m_layout_textures.size());
+
+    RK_CHECK_EXB(exception_boundary([&]() {
+        layout.m_runs.clear();
+        s32 run_begin = 0;
+        while (run_begin < num_glyphs) {
+            s32 run_end = run_begin + 1;
+            u32 const texture = m_layout_textures[run_begin];
+            while (run_end < num_glyphs && m_layout_textures[run_end] == texture) { ++run_end; }
+            layout.m_runs.push_back({texture, run_begin, run_end - run_begin});
+            run_begin = run_end;
+        }
+        return Status::ok;
+    }));
+    // Read after appending, which may itself have evicted a page
+    layout.m_atlas_evictions = m_glyph_cache.eviction_count();
+    layout.m_glyph_count = num_glyphs;
+    layout.m_laid_out = true;
+
+    if (layout.m_vao == 0) {
+        // Same index pattern as the text batches
+        glCreateVertexArrays(1, &layout.m_vao);
+        glCreateBuffers(1, &layout.m_vbo);
+        setup_text_vertex_array(layout.m_vao, layout.m_vbo);
+    }
 
-    for (char c : text) {
-        // TODO: can we access this by ref?
-        auto ch_iter = m_characters.find(c);
-        if (ch_iter == m_characters.end()) {
-            // TODO: error - unable to find glyph for character
-            continue;
+    if (num_glyphs > 0) {
+        size_t const size = m_layout_vertices.size() * sizeof(Text_Vertex);
+        if (num_glyphs > layout.m_vbo_capacity) {
+            glNamedBufferData(layout.m_vbo, size, m_layout_vertices.data(), GL_STATIC_DRAW);
+            layout.m_vbo_capacity = num_glyphs;
+        } else {
+            glNamedBufferSubData(layout.m_vbo, 0, size, m_layout_vertices.data());
         }
-        Character ch = ch_iter->second;
-
-        f32 pos_x = screen_pos_x + ch.bearing.x * scale;
-        f32 pos_y = screen_pos_y - (ch.size.y - ch.bearing.y) * scale;
-
-        f32 w = ch.size.x * scale;
-        f32 h = ch.size.y * scale;
-
-        // update vbo per character to create the rect it will be rendered in
-        // @perf don't allocate this every time (will it get hoisted?)
-        f32 vertices[6][4] = {
-            { pos_x,     pos_y + h, 0.0f, 0.0f },
-            { pos_x,     pos_y,     0.0f, 1.0f },
-            { pos_x + w, pos_y,     1.0f, 1.0f },
-
-            { pos_x,     pos_y + h, 0.0f, 0.0f },
-            { pos_x + w, pos_y,     1.0f, 1.0f },
-            { pos_x + w, pos_y + h, 1.0f, 0.0f },
-        };
-
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.texture_id);
-        // update vbo
-        glBindBuffer(GL_ARRAY_BUFFER, m_text_vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-        // advance cursor for next glyph
-        // NOTE: advance is number of 1/64 points
-        //  bitshift >> 6 => 2^6 = 64
-        screen_pos_x += (ch.advance >> 6) * scale;
+        ++m_stats.gl_calls;
+        ++m_stats.buffer_uploads;
     }
 
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glDisable(GL_BLEND);
+    return Status::ok;
+}
 
+Status Renderer::draw_text_layout(Shader_Program& shader, Text_Layout& layout) noexcept
+{
+    RK_ASSERT(layout.m_laid_out); // call layout_text first
+    if (layout.m_atlas_evictions != m_glyph_cache.eviction_count()) {
+        // Laying out other text this frame evicted a page, which may have held these glyphs
+        RK_CHECK(build_text_layout(layout));
+    }
+    if (layout.m_glyph_count == 0) { return Status::ok; }
+
+    begin_text_draw(shader, layout.m_vao);
+
+    // The index buffer covers `text_batch_capacity` glyphs, longer layouts are drawn in chunks of
+    // that size with a base vertex
+    s32 const capacity = m_config.text_batch_capacity;
+    for (Text_Layout::Run const& run : layout.m_runs) {
+        // Keep the glyphs' atlas page from being evicted while the layout is in use
+        m_glyph_cache.mark_used(run.texture_id);
+        m_gl_state.bind_texture(0, run.texture_id);
+
+        s32 const run_end = run.first_glyph + run.glyph_count;
+        for (s32 glyph = run.first_glyph; glyph < run_end;) {
+            s32 const chunk_begin = glyph / capacity * capacity;
+            s32 const draw_end = std::min(run_end, chunk_begin + capacity);
+            size_t const index_offset = (glyph - chunk_begin) * indices_per_glyph * sizeof(u16);
+            glDrawElementsBaseVertex(GL_TRIANGLES, (draw_end - glyph) * indices_per_glyph,
+                                     GL_UNSIGNED_SHORT, reinterpret_cast<void const*>(index_offset),
+                                     chunk_begin * vertices_per_glyph);
+            ++m_stats.gl_calls;
+            ++m_stats.draw_calls;
+            glyph = draw_end;
+        }
+    }
+
+    m_stats.glyphs += static_cast<u32>(layout.m_glyph_count);
     return Status::ok;
 }
+
+void Renderer::destroy_text_layout(Text_Layout& layout) noexcept
+{
+    m_gl_state.forget_vertex_array(layout.m_vao);
+    glDeleteVertexArrays(1, &layout.m_vao);
+    glDeleteBuffers(1, &layout.m_vbo);
+    layout = Text_Layout();
+}
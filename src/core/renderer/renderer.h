@@ -1,28 +1,73 @@
 #pragma once
 
+#include "core/math/matrix.h"
 #include "core/platform/glfw.h"
 #include "core/platform/window.h"
+#include "core/renderer/frame_pacer.h"
+#include "core/renderer/frame_uniforms.h"
+#include "core/renderer/gl_state_cache.h"
+#include "core/renderer/glyph_cache.h"
+#include "core/renderer/gpu_profiler.h"
 #include "core/renderer/opengl/shader_program.h"
+#include "core/renderer/render_queue.h"
+#include "core/renderer/render_stats.h"
+#include "core/renderer/sprite_batch.h"
+#include "core/renderer/stream_buffer.h"
+#include "core/renderer/text_layout.h"
 #include "core/status.h"
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
-#include <map>
+#include <array>
 #include <string>
+#include <vector>
 
 namespace rk
 {
-struct Global_Renderer_State {
-    glm::mat4 screen_ortho_projection;
-};
-extern Global_Renderer_State g_renderer_state;
-
 class Renderer {
 public:
     Renderer() = default;
+    Renderer(Renderer const&) = delete;
+    Renderer& operator=(Renderer const&) = delete;
+
+    /** Largest `Config::text_batch_capacity`. Glyph vertices are indexed with u16. */
+    static constexpr s32 max_text_batch_capacity = 16384;
+
+    enum class Vsync : u8 {
+        off,
+        on,
+        /**
+         * Sync when on time, tear rather than wait a whole refresh when late. Same as `on` if
+         * unsupported.
+         */
+        adaptive,
+    };
 
     struct Config {
         bool enable_debug = false;
+        Vsync vsync = Vsync::on;
+        /**
+         * Render into an offscreen framebuffer the size of a hidden window, instead of to the
+         * screen. Works with software drivers like Mesa's llvmpipe, but still needs a display
+         * connection, eg. from Xvfb. Read frames back with `read_frame`.
+         */
+        bool headless = false;
+        /** Frame rate limit and low latency mode. */
+        Frame_Pacer::Config frame_pacing = {};
+        /** Glyphs per text vertex buffer upload. Larger batches need fewer GL calls. */
+        s32 text_batch_capacity = 4096;
+        /** SDF text stays sharp at any scale. Needs the shader from `text_fragment_shader`. */
+        Glyph_Cache::Render_Mode text_render_mode = Glyph_Cache::Render_Mode::sdf;
+        /** Sprites to reserve space for. The sprite batch grows past it as needed. */
+        s32 sprite_batch_capacity = 16384;
+        /**
+         * Bytes of text vertices and sprite instances each frame can stream to the GPU. Three
+         * frames' worth is kept mapped.
+         */
+        u32 stream_buffer_frame_size = 8 * 1024 * 1024;
+        /** Draw packets to reserve space for. The render queue grows past it as needed. */
+        s32 render_queue_capacity = 1024;
+        Gpu_Profiler::Config gpu_profiler = {};
     };
     [[nodiscard]] Status initialize(Config config) noexcept;
     Status destroy() noexcept;
@@ -54,20 +99,159 @@ public:
      */
     [[nodiscard]] Status setup_gl_api() noexcept;
 
+    /**
+     * \brief Set how buffer swaps sync with the display. Set from the config by `setup_gl_api`.
+     */
+    [[nodiscard]] Status set_vsync(Vsync vsync) noexcept;
+
     /**
      * \brief Draw wireframe primitives in any subsequent draw calls.
      */
-    void draw_wireframe(bool enable) const noexcept;
+    void draw_wireframe(bool enable) noexcept;
+
+    /**
+     * \brief Start a frame. Applies window resizes and uploads the frame uniforms if they changed.
+     * Call before drawing anything in the frame.
+     */
+    [[nodiscard]] Status begin_frame() noexcept;
+
+    /**
+     * \brief End the frame's GPU work, so the streamed data of a later frame can reuse its memory,
+     * and the glyph atlas pages only used by this frame can be evicted. Called by `swap_buffers`.
+     * Without a window, call it once per frame.
+     */
+    [[nodiscard]] Status end_frame() noexcept;
+
+    /**
+     * \brief Set the camera's view projection in the frame uniforms, uploaded by the next
+     * `begin_frame`.
+     */
+    void set_view_projection(Mat4 const& view_projection) noexcept;
+
+    /**
+     * \brief Uniforms every program reads from the uniform buffer at `frame_uniforms_binding`.
+     * The screen projection and viewport follow the window size.
+     */
+    [[nodiscard]] Frame_Uniforms const& frame_uniforms() const noexcept
+    {
+        return m_frame_uniforms;
+    }
 
     /**
-     * \brief Swap frame buffers.
+     * \brief End the frame and swap frame buffers, paced by the frame rate limit and low latency
+     * mode.
      */
-    [[nodiscard]] Status swap_buffers() const noexcept;
+    [[nodiscard]] Status swap_buffers() noexcept;
+
+    /**
+     * \brief Read the frame drawn so far into \a out_rgba as 8 bit RGBA, rows from top to bottom.
+     * Waits for the GPU.
+     *
+     * Reads the offscreen framebuffer in headless mode, and the back buffer otherwise.
+     */
+    [[nodiscard]] Status read_frame(std::vector<u8>& out_rgba, s32& out_width,
+                                    s32& out_height) noexcept;
 
     [[nodiscard]] GLFWframebuffersizefun get_framebuffer_size_callback() const noexcept;
 
     [[nodiscard]] Status load_font_glyphs() noexcept;
-    [[nodiscard]] Status render_text(Shader_Program& shader, std::string_view text, f32 screen_pos_x, f32 screen_pos_y, f32 scale, glm::vec3 color) const noexcept;
+
+    /**
+     * \brief Fragment shader to draw text with, for the configured text render mode.
+     *
+     * Use with the "font_glyphs.vert" vertex shader.
+     */
+    [[nodiscard]] char const* text_fragment_shader() const noexcept;
+
+    /**
+     * \brief Queue text to be drawn by the next `flush_text`.
+     *
+     * Glyphs of all the queued text go into one vertex stream and are drawn together.
+     */
+    [[nodiscard]] Status queue_text(std::string_view text, f32 screen_pos_x, f32 screen_pos_y,
+                                    f32 scale, glm::vec3 color) noexcept;
+
+    /**
+     * \brief Draw all queued text with \a shader.
+     */
+    [[nodiscard]] Status flush_text(Shader_Program& shader) noexcept;
+
+    /**
+     * \brief Draw text now. Same as `queue_text` followed by `flush_text`, so any previously queued
+     * text is drawn as well.
+     */
+    [[nodiscard]] Status render_text(Shader_Program& shader, std::string_view text, f32 screen_pos_x, f32 screen_pos_y, f32 scale, glm::vec3 color) noexcept;
+
+    /**
+     * \brief Lay out text into \a layout, if anything changed since it was last laid out.
+     *
+     * Call every frame before `draw_text_layout`. When nothing changed this is a comparison.
+     */
+    [[nodiscard]] Status layout_text(Text_Layout& layout, std::string_view text, f32 screen_pos_x,
+                                     f32 screen_pos_y, f32 scale, glm::vec3 color) noexcept;
+
+    /**
+     * \brief Draw \a layout with \a shader. Independent of the queued text.
+     *
+     * If laying out other text since `layout_text` evicted a glyph atlas page, \a layout is laid
+     * out again first.
+     */
+    [[nodiscard]] Status draw_text_layout(Shader_Program& shader, Text_Layout& layout) noexcept;
+
+    /**
+     * \brief Free the GL resources of \a layout and reset it.
+     */
+    void destroy_text_layout(Text_Layout& layout) noexcept;
+
+    /**
+     * \brief Queue a sprite to be drawn by the next `flush_sprites`.
+     */
+    [[nodiscard]] Status queue_sprite(Sprite const& sprite) noexcept
+    {
+        return m_sprite_batch.add(sprite);
+    }
+
+    /**
+     * \brief Draw all queued sprites with \a shader, built from "sprite.vert" and "sprite.frag".
+     */
+    [[nodiscard]] Status flush_sprites(Shader_Program& shader) noexcept
+    {
+        return m_sprite_batch.flush(shader, m_stream_buffer, m_gl_state, m_stats);
+    }
+
+    /**
+     * \brief Queue for draws submitted during the frame. Drawn by `flush_render_queue`.
+     */
+    [[nodiscard]] Render_Queue& render_queue() noexcept { return m_render_queue; }
+
+    /**
+     * \brief Sort the draws queued this frame and draw them.
+     */
+    [[nodiscard]] Status flush_render_queue() noexcept
+    {
+        return m_render_queue.flush(m_gl_state, m_stats);
+    }
+
+    /**
+     * \brief The GL state set by the renderer. Code drawing outside the renderer should change the
+     * tracked state through it too, so the cache stays in sync.
+     */
+    [[nodiscard]] Gl_State_Cache& gl_state() noexcept { return m_gl_state; }
+
+    /**
+     * \brief GPU timings of the render passes, see `Gpu_Profiler`. Frames are ended by `end_frame`.
+     */
+    [[nodiscard]] Gpu_Profiler& gpu_profiler() noexcept { return m_gpu_profiler; }
+
+    /**
+     * \brief Present to present intervals and jitter of `swap_buffers`.
+     */
+    [[nodiscard]] Frame_Pacer const& frame_pacer() const noexcept { return m_frame_pacer; }
+
+    [[nodiscard]] Render_Stats const& stats() const noexcept { return m_stats; }
+    /** For code outside the renderer that submits GL work to count it in the frame's stats. */
+    [[nodiscard]] Render_Stats& stats() noexcept { return m_stats; }
+    void reset_stats() noexcept { m_stats = {}; }
 
 private:
     Config m_config = {};
@@ -76,15 +260,94 @@ private:
     static constexpr s32 m_ogl_ctx_version_major = 4;
     static constexpr s32 m_ogl_ctx_version_minor = 6;
 
-    struct Character {
-        u32 texture_id; // handle of glyph texture
-        glm::ivec2 size; // glyph size
-        glm::ivec2 bearing; // offset from baseline to left/top of glyph
-        s64 advance; // offset to advance to next glyph
+    Glyph_Cache m_glyph_cache;
+    Glyph_Cache::Font_Id m_font = 0;
+    /** Text height in pixels at a scale of 1. */
+    static constexpr s32 m_text_pixel_size = 64;
+    /** Size glyphs are rasterized at. SDF glyphs scale well, so a smaller size is enough. */
+    static constexpr s32 m_bitmap_glyph_pixel_size = 64;
+    static constexpr s32 m_sdf_glyph_pixel_size = 32;
+    [[nodiscard]] s32 glyph_pixel_size() const noexcept;
+
+    /**
+     * \brief Load the glyphs baked into the file at \a baked_path, falling back to the font at
+     * \a font_path for glyphs that weren't baked.
+     *
+     * \return Not `ok` if there is no usable baked font, in which case glyphs should be rasterized
+     * from \a font_path.
+     */
+    [[nodiscard]] Status load_baked_font(char const* baked_path, char const* font_path) noexcept;
+
+    struct Text_Vertex {
+        f32 x, y; // screen position
+        f32 u, v;
+        std::array<u8, 4> color; // rgba
     };
-    std::map<u32, Character> m_characters;
+    std::vector<Text_Vertex> m_text_vertices;   // queued glyph quads, 4 vertices each
+    std::vector<u32> m_text_textures;           // texture of each queued glyph
+    std::vector<Text_Vertex> m_layout_vertices; // scratch space for `layout_text`
+    std::vector<u32> m_layout_textures;
 
     u32 m_text_vao = 0;
-    u32 m_text_vbo = 0;
+    u32 m_text_ebo = 0;
+
+    Stream_Buffer m_stream_buffer;
+
+    Sprite_Batch m_sprite_batch;
+
+    Render_Queue m_render_queue;
+
+    Gpu_Profiler m_gpu_profiler;
+
+    Frame_Pacer m_frame_pacer;
+
+    Frame_Uniforms m_frame_uniforms;
+    u32 m_frame_uniform_buffer = 0;
+    bool m_frame_uniforms_dirty = false; // changed since the last upload
+
+    // Headless render target
+    u32 m_headless_fbo = 0;
+    u32 m_headless_color = 0;
+    u32 m_headless_depth = 0;
+    s32 m_headless_width = 0;
+    s32 m_headless_height = 0;
+
+    Render_Stats m_stats;
+    Gl_State_Cache m_gl_state{m_stats};
+
+    /**
+     * \brief Append a quad for each visible glyph of \a text to \a vertices, and its atlas texture
+     * to \a textures.
+     */
+    [[nodiscard]] Status append_text_quads(std::string_view text, f32 screen_pos_x,
+                                           f32 screen_pos_y, f32 scale, glm::vec3 color,
+                                           std::vector<Text_Vertex>& vertices,
+                                           std::vector<u32>& textures) noexcept;
+
+    /**
+     * \brief Build the vertices of \a layout from its current inputs.
+     */
+    [[nodiscard]] Status build_text_layout(Text_Layout& layout) noexcept;
+
+    /**
+     * \brief Set the viewport, and the frame uniforms that depend on it.
+     */
+    void set_viewport(s32 width, s32 height) noexcept;
+
+    /**
+     * \brief Create and bind the offscreen framebuffer of headless mode.
+     */
+    [[nodiscard]] Status create_headless_target(s32 width, s32 height) noexcept;
+
+    /**
+     * \brief Set up \a vao to draw `Text_Vertex` quads from \a vbo with the text index buffer.
+     */
+    void setup_text_vertex_array(u32 vao, u32 vbo) const noexcept;
+
+    /**
+     * \brief Set the state text is drawn with. It's left set afterwards, the next draw changes only
+     * what it needs to.
+     */
+    void begin_text_draw(Shader_Program const& shader, u32 vao) noexcept;
 };
 } // namespace rk
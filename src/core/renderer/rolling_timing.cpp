@@ -0,0 +1,28 @@
+#include "core/renderer/rolling_timing.h"
+
+#include <algorithm>
+
+using namespace rk;
+using namespace sds;
+
+void Rolling_Timing::add(f32 sample) noexcept
+{
+    m_samples[m_next] = sample;
+    m_next = (m_next + 1) % window_size;
+    m_count = std::min(m_count + 1, window_size);
+    m_last = sample;
+}
+
+f32 Rolling_Timing::average() const noexcept
+{
+    if (m_count == 0) { return 0.0f; }
+    f64 sum = 0.0;
+    for (s32 i = 0; i < m_count; ++i) { sum += m_samples[i]; }
+    return static_cast<f32>(sum / m_count);
+}
+
+f32 Rolling_Timing::max() const noexcept
+{
+    if (m_count == 0) { return 0.0f; }
+    return *std::max_element(m_samples.begin(), m_samples.begin() + m_count);
+}
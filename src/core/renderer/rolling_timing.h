@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core/types.h"
+#include <array>
+
+namespace rk
+{
+/**
+ * \brief Average and maximum of the last `window_size` samples.
+ */
+class Rolling_Timing {
+public:
+    static constexpr s32 window_size = 60;
+
+    void add(f32 sample) noexcept;
+
+    [[nodiscard]] f32 last() const noexcept { return m_last; }
+    [[nodiscard]] f32 average() const noexcept;
+    [[nodiscard]] f32 max() const noexcept;
+    [[nodiscard]] s32 sample_count() const noexcept { return m_count; }
+
+private:
+    std::array<f32, window_size> m_samples = {};
+    s32 m_next = 0;  // slot the next sample goes in
+    s32 m_count = 0; // samples in the window
+    f32 m_last = 0.0f;
+};
+} // namespace rk
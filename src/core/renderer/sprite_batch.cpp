@@ -0,0 +1,170 @@
+#include "core/renderer/sprite_batch.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/utility/no_exception.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+using namespace rk;
+using namespace sds;
+
+// Sort key: biased layer in the top 16 bits, texture slot in the next 16, sprite index in the low
+// 32. Sorting the keys orders sprites by layer, then texture, then the order they were added.
+constexpr s32 key_layer_shift = 48;
+constexpr s32 key_slot_shift = 32;
+constexpr u64 key_index_mask = 0xFFFF'FFFF;
+
+u64 rk::make_sprite_sort_key(s16 layer, u32 texture_slot, u32 index) noexcept
+{
+    RK_ASSERT(texture_slot < max_sprite_texture_slots);
+    u64 const biased_layer =
+        static_cast<u64>(static_cast<s32>(layer) - std::numeric_limits<s16>::min());
+    return (biased_layer << key_layer_shift) | (static_cast<u64>(texture_slot) << key_slot_shift) |
+           index;
+}
+
+u32 rk::sprite_sort_key_index(u64 key) noexcept { return static_cast<u32>(key & key_index_mask); }
+
+constexpr s32 vertices_per_sprite = 4; // triangle strip
+
+Status Sprite_Batch::initialize(s32 capacity, u32 stream_buffer) noexcept
+{
+    RK_ASSERT(capacity >= 0);
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_sprites.reserve(capacity);
+        m_sort_keys.reserve(capacity);
+        m_runs.reserve(capacity);
+        return Status::ok;
+    }));
+
+    glCreateVertexArrays(1, &m_vao);
+    glVertexArrayVertexBuffer(m_vao, 0, stream_buffer, 0, sizeof(Instance));
+
+    // Every attribute is per instance, the quad corners come from gl_VertexID. Instances are
+    // addressed in the stream buffer with the base instance.
+    glVertexArrayBindingDivisor(m_vao, 0, 1);
+    // vec4: vec2 pos, vec2 size
+    glEnableVertexArrayAttrib(m_vao, 0);
+    glVertexArrayAttribFormat(m_vao, 0, 4, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(m_vao, 0, 0);
+    // vec4: vec2 uv min, vec2 uv max
+    glEnableVertexArrayAttrib(m_vao, 1);
+    glVertexArrayAttribFormat(m_vao, 1, 4, GL_FLOAT, GL_FALSE, offsetof(Instance, u_min));
+    glVertexArrayAttribBinding(m_vao, 1, 0);
+    // vec4 color, normalized from bytes
+    glEnableVertexArrayAttrib(m_vao, 2);
+    glVertexArrayAttribFormat(m_vao, 2, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(Instance, color));
+    glVertexArrayAttribBinding(m_vao, 2, 0);
+    return Status::ok;
+}
+
+Status Sprite_Batch::destroy() noexcept
+{
+    glDeleteVertexArrays(1, &m_vao);
+    m_vao = 0;
+    m_sprites.clear();
+    m_sort_keys.clear();
+    m_texture_slots.clear();
+    m_runs.clear();
+    return Status::ok;
+}
+
+Status Sprite_Batch::add(Sprite const& sprite) noexcept
+{
+    if (m_sprites.size() > key_index_mask) {
+        LOG_ERROR("Too many sprites in one batch");
+        return Status::buffer_length_error;
+    }
+
+    // Sprites tend to come in runs with the same texture
+    u32 slot = m_last_texture_slot;
+    if (m_texture_slots.empty() || sprite.texture_id != m_last_texture) {
+        auto it = std::find(m_texture_slots.begin(), m_texture_slots.end(), sprite.texture_id);
+        slot = static_cast<u32>(it - m_texture_slots.begin());
+        if (it == m_texture_slots.end()) {
+            if (slot == max_sprite_texture_slots) {
+                LOG_ERROR("Too many textures in one sprite batch");
+                return Status::buffer_length_error;
+            }
+            RK_CHECK_EXB(exception_boundary([&]() {
+                m_texture_slots.push_back(sprite.texture_id);
+                return Status::ok;
+            }));
+        }
+        m_last_texture = sprite.texture_id;
+        m_last_texture_slot = slot;
+    }
+
+    u64 const key =
+        make_sprite_sort_key(sprite.layer, slot, static_cast<u32>(m_sprites.size()));
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_sprites.push_back(sprite);
+        m_sort_keys.push_back(key);
+        return Status::ok;
+    }));
+    return Status::ok;
+}
+
+Status Sprite_Batch::build(Instance* RK_RESTRICT instances) noexcept
+{
+    RK_CHECK_EXB(exception_boundary([&]() {
+        m_runs.reserve(m_sprites.size());
+        return Status::ok;
+    }));
+
+    // Sorting 8 byte keys is much cheaper than sorting the sprites themselves
+    std::sort(m_sort_keys.begin(), m_sort_keys.end());
+
+    // Layers are sorted first, so a texture change or a layer change starts a new run. Only the
+    // texture matters for drawing, runs of the same texture across a layer change are merged.
+    m_runs.clear();
+    for (size_t i = 0; i < m_sort_keys.size(); ++i) {
+        Sprite const& s = m_sprites[sprite_sort_key_index(m_sort_keys[i])];
+        instances[i] = {s.position.x, s.position.y, s.size.x,   s.size.y,
+                        s.uv_min.x,   s.uv_min.y,   s.uv_max.x, s.uv_max.y,
+                        s.color};
+        if (m_runs.empty() || m_runs.back().texture_id != s.texture_id) {
+            m_runs.push_back({s.texture_id, static_cast<s32>(i), 0});
+        }
+        ++m_runs.back().count;
+    }
+    return Status::ok;
+}
+
+Status Sprite_Batch::flush(Shader_Program& shader, Stream_Buffer& stream_buffer,
+                           Gl_State_Cache& gl_state, Render_Stats& stats) noexcept
+{
+    s32 const num_sprites = sprite_count();
+    if (num_sprites == 0) { return Status::ok; }
+
+    // Sorted straight into mapped memory, the GPU reads it from there
+    u32 const bytes = num_sprites * sizeof(Instance);
+    Stream_Buffer::Allocation alloc;
+    RK_CHECK(stream_buffer.allocate(bytes, sizeof(Instance), alloc));
+    RK_CHECK(build(static_cast<Instance*>(alloc.data)));
+    stats.stream_bytes += bytes;
+    u32 const base_instance = alloc.offset / sizeof(Instance);
+
+    gl_state.set_blend(true);
+    gl_state.set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl_state.use_program(shader.handle());
+    gl_state.bind_vertex_array(m_vao);
+
+    for (Run const& run : m_runs) {
+        gl_state.bind_texture(0, run.texture_id);
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, vertices_per_sprite, run.count,
+                                          base_instance + run.first);
+        ++stats.gl_calls;
+        ++stats.draw_calls;
+    }
+
+    stats.sprites += static_cast<u32>(num_sprites);
+
+    m_sprites.clear();
+    m_sort_keys.clear();
+    m_texture_slots.clear();
+    return Status::ok;
+}
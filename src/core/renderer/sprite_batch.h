@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core/renderer/gl_state_cache.h"
+#include "core/renderer/opengl/shader_program.h"
+#include "core/renderer/render_stats.h"
+#include "core/renderer/stream_buffer.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <glm/vec2.hpp>
+#include <array>
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief Textured screen space rectangle.
+ */
+struct Sprite {
+    glm::vec2 position = {0.0f, 0.0f}; // bottom left
+    glm::vec2 size = {0.0f, 0.0f};
+    glm::vec2 uv_min = {0.0f, 0.0f}; // texture coordinates at the bottom left
+    glm::vec2 uv_max = {1.0f, 1.0f}; // texture coordinates at the top right
+    std::array<u8, 4> color = {255, 255, 255, 255}; // rgba, multiplied with the texture
+    u32 texture_id = 0;
+    /**
+     * Lower layers are drawn first. Within a layer, sprites are grouped by texture, and only
+     * sprites of the same texture are drawn in the order they were added. Put overlapping
+     * translucent sprites of different textures in different layers.
+     */
+    s16 layer = 0;
+};
+
+/** Textures one sprite batch can hold. */
+constexpr u32 max_sprite_texture_slots = 1 << 16;
+
+/**
+ * \brief Key that orders sprites by \a layer, then by \a texture_slot, then by \a index, the
+ * order they were added.
+ */
+[[nodiscard]] u64 make_sprite_sort_key(s16 layer, u32 texture_slot, u32 index) noexcept;
+
+/**
+ * \brief Index of the sprite a key made by `make_sprite_sort_key` was made for.
+ */
+[[nodiscard]] u32 sprite_sort_key_index(u64 key) noexcept;
+
+/**
+ * \brief Sprites drawn as instanced quads.
+ *
+ * Sprites are accumulated with `add` and drawn with `flush`. The sprites are sorted by layer and
+ * then texture and written straight into the renderer's `Stream_Buffer`, and each run of sprites
+ * with the same texture is one instanced draw. Drawing many sprites costs a draw call per texture
+ * and layer, not per sprite.
+ *
+ * Draw with the "sprite.vert" and "sprite.frag" shaders.
+ *
+ * Requires a current OpenGL context.
+ */
+class Sprite_Batch {
+public:
+    /** Per instance vertex data. */
+    struct Instance {
+        f32 x, y, width, height;
+        f32 u_min, v_min, u_max, v_max;
+        std::array<u8, 4> color;
+    };
+
+    /** Sorted sprites drawn with one instanced call. */
+    struct Run {
+        u32 texture_id;
+        s32 first; // index of the first sprite's instance
+        s32 count;
+    };
+
+    Sprite_Batch() = default;
+
+    /**
+     * \param capacity Sprites to reserve space for. The buffers grow as needed.
+     * \param stream_buffer `Stream_Buffer::buffer_id` of the buffer passed to `flush`.
+     */
+    [[nodiscard]] Status initialize(s32 capacity, u32 stream_buffer) noexcept;
+    Status destroy() noexcept;
+
+    [[nodiscard]] Status add(Sprite const& sprite) noexcept;
+
+    /**
+     * \brief Draw the added sprites with \a shader and remove them from the batch.
+     */
+    [[nodiscard]] Status flush(Shader_Program& shader, Stream_Buffer& stream_buffer,
+                               Gl_State_Cache& gl_state, Render_Stats& stats) noexcept;
+
+    [[nodiscard]] s32 sprite_count() const noexcept { return static_cast<s32>(m_sprites.size()); }
+
+    /**
+     * \brief Write the added sprites to \a instances in sorted order, and split them into `runs`.
+     * Done by `flush`, no GL calls.
+     *
+     * \param instances Space for `sprite_count` instances.
+     */
+    [[nodiscard]] Status build(Instance* RK_RESTRICT instances) noexcept;
+
+    /** Draws of the sprites as of the last `build`. */
+    [[nodiscard]] std::vector<Run> const& runs() const noexcept { return m_runs; }
+
+private:
+    std::vector<Sprite> m_sprites;     // in the order they were added
+    std::vector<u64> m_sort_keys;      // layer, texture slot and index of each sprite
+    std::vector<u32> m_texture_slots;  // textures of the current batch, indexed by slot
+    std::vector<Run> m_runs;
+
+    u32 m_last_texture = 0; // texture of the last added sprite, and its slot
+    u32 m_last_texture_slot = 0;
+
+    u32 m_vao = 0;
+};
+} // namespace rk
@@ -0,0 +1,102 @@
+#include "core/renderer/stream_buffer.h"
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include <glad/glad.h>
+#include <limits>
+
+using namespace rk;
+using namespace sds;
+
+constexpr GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+Status Stream_Buffer::initialize(u32 frame_size) noexcept
+{
+    if (frame_size == 0 || frame_size > std::numeric_limits<u32>::max() / frame_count) {
+        LOG_ERROR("Invalid stream buffer frame size: {}", frame_size);
+        return Status::invalid_value;
+    }
+    m_frame_size = frame_size;
+    GLsizeiptr const size = static_cast<GLsizeiptr>(frame_size) * frame_count;
+
+    glCreateBuffers(1, &m_buffer);
+    glNamedBufferStorage(m_buffer, size, nullptr, map_flags);
+    m_mapped = static_cast<u8*>(glMapNamedBufferRange(m_buffer, 0, size, map_flags));
+    if (!m_mapped) {
+        LOG_ERROR("Failed to map stream buffer of {} bytes", size);
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+        return Status::renderer_error;
+    }
+    return Status::ok;
+}
+
+Status Stream_Buffer::destroy() noexcept
+{
+    for (void*& fence : m_fences) {
+        if (fence) {
+            glDeleteSync(static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+    if (m_buffer) {
+        glUnmapNamedBuffer(m_buffer);
+        glDeleteBuffers(1, &m_buffer);
+    }
+    m_buffer = 0;
+    m_mapped = nullptr;
+    return Status::ok;
+}
+
+Status Stream_Buffer::allocate(u32 size, u32 alignment, Allocation& out) noexcept
+{
+    RK_ASSERT(m_mapped);
+    RK_ASSERT(alignment > 0);
+
+    // Regions start at a multiple of the frame size, so align the absolute offset
+    u32 const region_begin = static_cast<u32>(m_frame) * m_frame_size;
+    u32 const unaligned = region_begin + m_frame_offset;
+    u64 const aligned = (static_cast<u64>(unaligned) + alignment - 1) / alignment * alignment;
+    if (aligned + size > static_cast<u64>(region_begin) + m_frame_size) {
+        LOG_ERROR("Stream buffer frame region of {} bytes is full, {} bytes requested",
+                  m_frame_size, size);
+        return Status::buffer_length_error;
+    }
+
+    out.offset = static_cast<u32>(aligned);
+    out.data = m_mapped + aligned;
+    m_frame_offset = static_cast<u32>(aligned + size - region_begin);
+    return Status::ok;
+}
+
+Status Stream_Buffer::end_frame() noexcept
+{
+    RK_ASSERT(!m_fences[m_frame]);
+    m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_frame = (m_frame + 1) % frame_count;
+    m_frame_offset = 0;
+
+    GLsync fence = static_cast<GLsync>(m_fences[m_frame]);
+    if (!fence) { return Status::ok; }
+    m_fences[m_frame] = nullptr;
+
+    // Poll first. If the GPU is behind, flush so the fence is submitted before blocking on it.
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        ++m_stall_count;
+        constexpr GLuint64 timeout_ns = 1'000'000'000;
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+        while (result == GL_TIMEOUT_EXPIRED) {
+            LOG_WARN("Waited over a second for the GPU to finish a frame");
+            result = glClientWaitSync(fence, 0, timeout_ns);
+        }
+    }
+    glDeleteSync(fence);
+
+    if (result == GL_WAIT_FAILED) {
+        LOG_ERROR("Failed to wait on the stream buffer fence");
+        return Status::renderer_error;
+    }
+    return Status::ok;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/status.h"
+#include "core/types.h"
+#include <array>
+
+namespace rk
+{
+/**
+ * \brief Ring of per frame regions in one persistently mapped buffer, for data written every frame.
+ *
+ * The buffer is created with immutable storage and stays mapped with coherent writes, so data is
+ * written straight into memory the GPU reads, with no buffer upload calls. It's split into
+ * `frame_count` regions. Each frame allocates from its own region, and `end_frame` puts a fence
+ * behind the frame's commands before moving on to the next region. A region is only written again
+ * once its fence has signaled, so the CPU never overwrites data the GPU may still be reading, and
+ * the GPU can be up to `frame_count - 1` frames behind without stalling the CPU.
+ *
+ * Requires a current OpenGL 4.4 context.
+ */
+class Stream_Buffer {
+public:
+    static constexpr s32 frame_count = 3;
+
+    struct Allocation {
+        void* data = nullptr; //!< Write only, coherent. Valid until the region is reused.
+        u32 offset = 0;       //!< From the start of the buffer, in bytes
+    };
+
+    Stream_Buffer() = default;
+
+    /**
+     * \param frame_size Bytes each frame can allocate.
+     */
+    [[nodiscard]] Status initialize(u32 frame_size) noexcept;
+    Status destroy() noexcept;
+
+    /**
+     * \brief Allocate \a size bytes from the current frame's region.
+     *
+     * \param alignment The offset is a multiple of it. Need not be a power of two, so vertex data
+     * can be aligned to its stride and addressed with a base vertex or base instance.
+     * \return `buffer_length_error` if the frame's region is full.
+     */
+    [[nodiscard]] Status allocate(u32 size, u32 alignment, Allocation& out) noexcept;
+
+    /**
+     * \brief Fence the current frame's commands and move to the next region, waiting for the GPU
+     * to finish with it if needed.
+     */
+    [[nodiscard]] Status end_frame() noexcept;
+
+    [[nodiscard]] u32 buffer_id() const noexcept { return m_buffer; }
+    [[nodiscard]] u32 frame_size() const noexcept { return m_frame_size; }
+
+    /** Number of times `end_frame` had to wait for the GPU. */
+    [[nodiscard]] u64 stall_count() const noexcept { return m_stall_count; }
+
+private:
+    u32 m_buffer = 0;
+    u8* m_mapped = nullptr;
+    u32 m_frame_size = 0;
+    s32 m_frame = 0;        // region being written
+    u32 m_frame_offset = 0; // next free byte in the current region
+    std::array<void*, frame_count> m_fences = {}; // GLsync of each region's last use
+    u64 m_stall_count = 0;
+};
+} // namespace rk
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core/renderer/glyph_cache.h"
+#include "core/types.h"
+#include <glm/vec3.hpp>
+#include <string>
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief Text laid out once into its own vertex buffer, for strings that rarely change.
+ *
+ * Created and updated with `Renderer::layout_text`, which only rebuilds the vertices when the
+ * text, position, scale, color or font changed, or the glyph atlas evicted a page. Drawing it with
+ * `Renderer::draw_text_layout` is then a draw call per atlas page, without any per glyph work,
+ * unless other text laid out in between evicted a page and it has to be laid out again.
+ *
+ * Must be destroyed with `Renderer::destroy_text_layout` while the GL context is current.
+ */
+class Text_Layout {
+public:
+    Text_Layout() = default;
+
+    [[nodiscard]] s32 glyph_count() const noexcept { return m_glyph_count; }
+
+private:
+    friend class Renderer;
+
+    /** Consecutive glyphs drawn from the same atlas page. */
+    struct Run {
+        u32 texture_id;
+        s32 first_glyph;
+        s32 glyph_count;
+    };
+
+    // Inputs of the current layout
+    std::string m_text;
+    f32 m_screen_pos_x = 0.0f;
+    f32 m_screen_pos_y = 0.0f;
+    f32 m_scale = 0.0f;
+    glm::vec3 m_color = {0.0f, 0.0f, 0.0f};
+    Glyph_Cache::Font_Id m_font = 0;
+    u64 m_atlas_evictions = 0; // glyph cache eviction count when laid out
+    bool m_laid_out = false;
+
+    std::vector<Run> m_runs;
+    s32 m_glyph_count = 0;
+
+    u32 m_vao = 0;
+    u32 m_vbo = 0;
+    s32 m_vbo_capacity = 0; // in glyphs
+};
+} // namespace rk
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "core/assert.h"
+#include "core/logging/logging.h"
+#include "core/status.h"
+#include "core/types.h"
+#include "core/utility/no_exception.h"
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief Ring of `depth` frames passed from the thread that builds them to the thread that renders
+ * them.
+ *
+ * The producer fills a frame between `begin_write` and `end_write`, and the consumer reads it
+ * between `begin_read` and `end_read`. Frames are read in the order they were written. Each side
+ * owns the frame it holds, so the frame data itself needs no locking.
+ *
+ * The depth bounds how far the producer can run ahead. With a depth of 1 the producer waits for
+ * each frame to be rendered before building the next. With a depth of 2 it builds frame N + 1
+ * while frame N renders. Each extra frame hides more stalls, and adds a frame of input latency.
+ *
+ * One producer and one consumer thread.
+ */
+template <typename Frame>
+class Frame_Pipeline {
+public:
+    Frame_Pipeline() = default;
+    Frame_Pipeline(Frame_Pipeline const&) = delete;
+    Frame_Pipeline& operator=(Frame_Pipeline const&) = delete;
+
+    [[nodiscard]] Status initialize(s32 depth) noexcept
+    {
+        if (depth <= 0) {
+            LOG_ERROR("Frame pipeline depth must be positive, got {}", depth);
+            return Status::invalid_value;
+        }
+        RK_CHECK_EXB(exception_boundary([&]() {
+            m_frames.resize(depth);
+            return Status::ok;
+        }));
+        return Status::ok;
+    }
+
+    /**
+     * \brief Frame to fill, waiting for the consumer to free one if all are in use.
+     *
+     * \return Null once the pipeline is closed.
+     */
+    [[nodiscard]] Frame* begin_write() noexcept
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [&]() { return m_closed || m_filled < depth(); });
+        if (m_closed) { return nullptr; }
+        return &m_frames[(m_read + m_filled) % depth()];
+    }
+
+    /**
+     * \brief Pass the frame from `begin_write` on to the consumer.
+     */
+    void end_write() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            RK_ASSERT(m_filled < depth());
+            ++m_filled;
+        }
+        m_cv.notify_all();
+    }
+
+    /**
+     * \brief Oldest written frame, waiting for the producer if there is none.
+     *
+     * \return Null once the pipeline is closed and every written frame has been read.
+     */
+    [[nodiscard]] Frame* begin_read() noexcept
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [&]() { return m_closed || m_filled > 0; });
+        if (m_filled == 0) { return nullptr; }
+        return &m_frames[m_read];
+    }
+
+    /**
+     * \brief Give the frame from `begin_read` back to the producer.
+     */
+    void end_read() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            RK_ASSERT(m_filled > 0);
+            m_read = (m_read + 1) % depth();
+            --m_filled;
+        }
+        m_cv.notify_all();
+    }
+
+    /**
+     * \brief Stop the pipeline. Wakes both threads. The consumer still gets the frames already
+     * written.
+     */
+    void close() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_cv.notify_all();
+    }
+
+    [[nodiscard]] s32 depth() const noexcept { return static_cast<s32>(m_frames.size()); }
+
+private:
+    std::vector<Frame> m_frames;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    s32 m_read = 0;   // frame the consumer reads next
+    s32 m_filled = 0; // written frames not yet given back by the consumer
+    bool m_closed = false;
+};
+} // namespace rk
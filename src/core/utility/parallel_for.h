@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/assert.h"
+#include "core/types.h"
+#include <algorithm>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace rk
+{
+/**
+ * \brief Number of worker threads to use for data parallel work. Always at least 1.
+ */
+inline s32 worker_thread_count() noexcept
+{
+    return std::max(1, static_cast<s32>(std::thread::hardware_concurrency()));
+}
+
+/**
+ * \brief Split [0, count) into contiguous chunks and call `f(chunk_index, begin, end)` for each,
+ * running the chunks concurrently.
+ *
+ * The calling thread processes the first chunk. Returns once all chunks are complete. The chunk
+ * count is at most \a max_chunks. If a worker thread can't be created its chunk runs on the calling
+ * thread.
+ *
+ * NOTE(sdsmith): @perf: Spawns threads per call. Only worth it for large workloads until there is
+ * a job system.
+ *
+ * \return Number of chunks used.
+ */
+template <typename F>
+s32 parallel_for_chunks(s32 count, s32 max_chunks, F&& f)
+{
+    RK_ASSERT(count >= 0);
+    RK_ASSERT(max_chunks > 0);
+
+    s32 const num_chunks = std::max(1, std::min(max_chunks, count));
+    s32 const chunk_size = (count + num_chunks - 1) / num_chunks;
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_chunks - 1);
+    for (s32 chunk = 1; chunk < num_chunks; ++chunk) {
+        s32 const begin = std::min(count, chunk * chunk_size);
+        s32 const end = std::min(count, begin + chunk_size);
+        try {
+            workers.emplace_back([&f, chunk, begin, end]() { f(chunk, begin, end); });
+        } catch (std::system_error const&) {
+            // Out of threads, do the work here instead
+            f(chunk, begin, end);
+        }
+    }
+
+    f(0, 0, std::min(count, chunk_size));
+
+    for (std::thread& t : workers) { t.join(); }
+    return num_chunks;
+}
+} // namespace rk
@@ -3,10 +3,11 @@
 #include "core/status.h"
 #include "core/utility/no_exception.h"
 #include "core/version.h"
+#include <cstring>
 
-rk::Status rtek_main(rk::unicode::Args& args) {
+rk::Status rtek_main(rk::unicode::Args& args, rk::Rtek_Engine::Config const& config) {
     rk::Rtek_Engine engine;
-    RK_CHECK(engine.initialize());
+    RK_CHECK(engine.initialize(config));
     RK_CHECK(engine.run());
     RK_CHECK(engine.destroy());
     return rk::Status::ok;
@@ -22,7 +23,12 @@ int main(int argc, char* argv[])
     // NOTE(sdsmith): Now when referring to argc and argv, they will be UTF-8 encoded
     rk::unicode::Args args(argc, argv); // TODO(sdsmith): throws
 
-    rk::Status ret = rtek_main(args);
+    rk::Rtek_Engine::Config config;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--render-thread") == 0) { config.render_thread = true; }
+    }
+
+    rk::Status ret = rtek_main(args, config);
     if (ret != rk::Status::ok) {
         LOG_ERROR("exited with status: {}", rk::to_string(ret));
         return 1;
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/baked_font.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+RK_INTERNAL
+std::vector<u8> make_font(std::vector<Baked_Glyph> const& glyphs, u32 atlas_size)
+{
+    Baked_Font_Header header;
+    header.pixel_size = 32;
+    header.render_mode = 1;
+    header.sdf_spread = 8;
+    header.atlas_size = atlas_size;
+
+    std::vector<u8> atlas(static_cast<size_t>(atlas_size) * atlas_size);
+    for (size_t i = 0; i < atlas.size(); ++i) { atlas[i] = static_cast<u8>(i); }
+
+    std::vector<u8> data;
+    EXPECT_EQ(serialize_baked_font(header, glyphs, atlas.data(), data), Status::ok);
+    return data;
+}
+
+TEST(BakedFontTest, round_trip)
+{
+    std::vector<Baked_Glyph> const glyphs = {
+        {0x20, 0, 0, 0, 0, 0, 0, 8 * 64},
+        {'A', 1, 1, 10, 12, -1, 12, 11 * 64},
+        {0x4E2D, 12, 1, 14, 15, 0, 13, 16 * 64},
+    };
+    std::vector<u8> const data = make_font(glyphs, 32);
+
+    Baked_Font font;
+    ASSERT_EQ(parse_baked_font(data.data(), data.size(), font), Status::ok);
+    EXPECT_EQ(font.header->pixel_size, 32u);
+    EXPECT_EQ(font.header->render_mode, 1u);
+    EXPECT_EQ(font.header->sdf_spread, 8u);
+    EXPECT_EQ(font.header->atlas_size, 32u);
+    ASSERT_EQ(font.header->glyph_count, glyphs.size());
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+        EXPECT_EQ(font.glyphs[i].codepoint, glyphs[i].codepoint);
+        EXPECT_EQ(font.glyphs[i].x, glyphs[i].x);
+        EXPECT_EQ(font.glyphs[i].height, glyphs[i].height);
+        EXPECT_EQ(font.glyphs[i].bearing_x, glyphs[i].bearing_x);
+        EXPECT_EQ(font.glyphs[i].advance, glyphs[i].advance);
+    }
+    for (u32 i = 0; i < 32 * 32; ++i) { ASSERT_EQ(font.atlas[i], static_cast<u8>(i)); }
+}
+
+TEST(BakedFontTest, rejects_truncated)
+{
+    std::vector<u8> const data = make_font({{'A', 0, 0, 4, 4, 0, 4, 5 * 64}}, 16);
+
+    Baked_Font font;
+    EXPECT_EQ(parse_baked_font(data.data(), 0, font), Status::invalid_value);
+    EXPECT_EQ(parse_baked_font(data.data(), sizeof(Baked_Font_Header) - 1, font),
+              Status::invalid_value);
+    EXPECT_EQ(parse_baked_font(data.data(), data.size() - 1, font), Status::invalid_value);
+    EXPECT_EQ(font.header, nullptr);
+}
+
+TEST(BakedFontTest, rejects_corrupt)
+{
+    Baked_Font font;
+
+    std::vector<u8> data = make_font({{'A', 0, 0, 4, 4, 0, 4, 5 * 64}}, 16);
+    data[0] = 'X';
+    EXPECT_EQ(parse_baked_font(data.data(), data.size(), font), Status::invalid_value);
+
+    data = make_font({{'A', 0, 0, 4, 4, 0, 4, 5 * 64}}, 16);
+    reinterpret_cast<Baked_Font_Header*>(data.data())->version += 1;
+    EXPECT_EQ(parse_baked_font(data.data(), data.size(), font), Status::invalid_value);
+
+    // Glyph past the edge of the atlas
+    data = make_font({{'A', 10, 0, 7, 4, 0, 4, 5 * 64}}, 16);
+    EXPECT_EQ(parse_baked_font(data.data(), data.size(), font), Status::invalid_value);
+
+    // Not a code point
+    data = make_font({{0x110000, 0, 0, 4, 4, 0, 4, 5 * 64}}, 16);
+    EXPECT_EQ(parse_baked_font(data.data(), data.size(), font), Status::invalid_value);
+
+    // Unsorted glyphs
+    data = make_font({{'B', 0, 0, 4, 4, 0, 4, 5 * 64}, {'A', 4, 0, 4, 4, 0, 4, 5 * 64}}, 16);
+    EXPECT_EQ(parse_baked_font(data.data(), data.size(), font), Status::invalid_value);
+
+    EXPECT_EQ(font.header, nullptr);
+}
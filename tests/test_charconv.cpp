@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include "core/math/charconv.h"
+#include "core/math/matrix.h"
+#include "core/math/quaternion.h"
+#include "core/math/vector.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <fmt/format.h>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <string>
+
+using namespace rk;
+using namespace sds;
+
+TEST(CharconvTest, vector3_to_chars)
+{
+    std::array<char, max_vector3_chars> buf;
+    std::to_chars_result const r =
+        to_chars(buf.data(), buf.data() + buf.size(), Vector3(1.0f, -2.5f, 0.0f));
+    ASSERT_EQ(r.ec, std::errc());
+    EXPECT_EQ(std::string(buf.data(), r.ptr), "1 -2.5 0");
+}
+
+TEST(CharconvTest, vector3_round_trip)
+{
+    Vector3 const values[] = {
+        Vector3(0.1f, 1.0f / 3.0f, -123456.789f),
+        Vector3(std::numeric_limits<f32>::max(), std::numeric_limits<f32>::lowest(),
+                std::numeric_limits<f32>::denorm_min()),
+        Vector3(-std::numeric_limits<f32>::min(), 1e-10f, 3.14159265f),
+    };
+
+    for (Vector3 const& v : values) {
+        std::array<char, max_vector3_chars> buf;
+        std::to_chars_result const w = to_chars(buf.data(), buf.data() + buf.size(), v);
+        ASSERT_EQ(w.ec, std::errc());
+
+        Vector3 parsed;
+        std::from_chars_result const r = from_chars(buf.data(), w.ptr, parsed);
+        ASSERT_EQ(r.ec, std::errc());
+        EXPECT_EQ(r.ptr, w.ptr);
+        EXPECT_EQ(parsed, v); // exact
+    }
+}
+
+TEST(CharconvTest, mat4_round_trip)
+{
+    Mat4 const m = Mat4::from_trs(Vector3(1.1f, -2.2f, 3.3f),
+                                  Quat::from_axis_angle(Vector3(0.0f, 1.0f, 0.0f), 0.3f),
+                                  Vector3(0.7f, 0.7f, 0.7f));
+
+    std::array<char, max_mat4_chars> buf;
+    std::to_chars_result const w = to_chars(buf.data(), buf.data() + buf.size(), m);
+    ASSERT_EQ(w.ec, std::errc());
+
+    Mat4 parsed;
+    ASSERT_EQ(from_chars(buf.data(), w.ptr, parsed).ec, std::errc());
+    EXPECT_EQ(parsed, m);
+}
+
+TEST(CharconvTest, quat_round_trip)
+{
+    Quat const q = normalize(Quat(0.3f, -0.2f, 0.5f, 0.8f));
+
+    std::array<char, max_quat_chars> buf;
+    std::to_chars_result const w = to_chars(buf.data(), buf.data() + buf.size(), q);
+    ASSERT_EQ(w.ec, std::errc());
+
+    Quat parsed;
+    ASSERT_EQ(from_chars(buf.data(), w.ptr, parsed).ec, std::errc());
+    EXPECT_EQ(parsed, q);
+}
+
+TEST(CharconvTest, to_chars_buffer_too_small)
+{
+    std::array<char, 4> buf;
+    std::to_chars_result const r =
+        to_chars(buf.data(), buf.data() + buf.size(), Vector3(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(r.ec, std::errc::value_too_large);
+}
+
+TEST(CharconvTest, from_chars_whitespace)
+{
+    char const* s = "  1.5\t-2\n  3 trailing";
+    Vector3 v;
+    std::from_chars_result const r = from_chars(s, s + std::strlen(s), v);
+    ASSERT_EQ(r.ec, std::errc());
+    EXPECT_EQ(v, Vector3(1.5f, -2.0f, 3.0f));
+    EXPECT_STREQ(r.ptr, " trailing");
+}
+
+TEST(CharconvTest, from_chars_invalid)
+{
+    Vector3 v(7.0f, 7.0f, 7.0f);
+
+    char const* too_few = "1 2";
+    EXPECT_NE(from_chars(too_few, too_few + std::strlen(too_few), v).ec, std::errc());
+
+    char const* not_separated = "1 2-3";
+    EXPECT_NE(from_chars(not_separated, not_separated + std::strlen(not_separated), v).ec,
+              std::errc());
+
+    char const* garbage = "a b c";
+    EXPECT_NE(from_chars(garbage, garbage + std::strlen(garbage), v).ec, std::errc());
+
+    EXPECT_EQ(v, Vector3(7.0f, 7.0f, 7.0f)); // unmodified on failure
+}
+
+TEST(CharconvTest, fmt_formatter)
+{
+    EXPECT_EQ(fmt::format("pos: {}", Vector3(1.0f, 2.0f, 3.5f)), "pos: 1 2 3.5");
+    EXPECT_EQ(fmt::format("{}", Quat()), "0 0 0 1");
+    EXPECT_EQ(Vector3(0.25f, -1.0f, 8.0f).to_string(), "0.25 -1 8");
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "core/math/matrix.h"
+#include "core/renderer/culling.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <random>
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+class CullingTest : public ::testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        // Camera at the origin looking down -z
+        m_frustum = Frustum::from_view_projection(Mat4::perspective(1.5f, 1.0f, 0.1f, 100.0f));
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<f32> pos(-150.0f, 150.0f);
+        std::uniform_real_distribution<f32> size(0.1f, 5.0f);
+        for (s32 i = 0; i < num_volumes; ++i) {
+            m_x.push_back(pos(rng));
+            m_y.push_back(pos(rng));
+            m_z.push_back(pos(rng));
+            m_ex.push_back(size(rng));
+            m_ey.push_back(size(rng));
+            m_ez.push_back(size(rng));
+        }
+    }
+
+    Aabb_Soa boxes() const
+    {
+        return {m_x.data(), m_y.data(), m_z.data(), m_ex.data(), m_ey.data(), m_ez.data(),
+                static_cast<s32>(m_x.size())};
+    }
+
+    Sphere_Soa spheres() const
+    {
+        return {m_x.data(), m_y.data(), m_z.data(), m_ex.data(), static_cast<s32>(m_x.size())};
+    }
+
+    /**
+     * \brief Reference box test, one box at a time.
+     */
+    bool is_box_visible(s32 i) const
+    {
+        Frustum const& f = m_frustum;
+        for (s32 p = 0; p < Frustum::num_planes; ++p) {
+            f32 const dist = f.a[p] * m_x[i] + f.b[p] * m_y[i] + f.c[p] * m_z[i] + f.d[p];
+            f32 const radius =
+                std::abs(f.a[p]) * m_ex[i] + std::abs(f.b[p]) * m_ey[i] + std::abs(f.c[p]) * m_ez[i];
+            if (dist + radius < 0.0f) { return false; }
+        }
+        return true;
+    }
+
+    static constexpr s32 num_volumes = 10007; // not a multiple of the SIMD width
+    Frustum m_frustum;
+    std::vector<f32> m_x, m_y, m_z, m_ex, m_ey, m_ez;
+};
+
+TEST_F(CullingTest, frustum_planes)
+{
+    std::vector<f32> x = {0.0f, 0.0f, 0.0f, 500.0f};
+    std::vector<f32> y = {0.0f, 0.0f, 0.0f, 0.0f};
+    std::vector<f32> z = {-10.0f, 10.0f, -200.0f, -10.0f};
+    std::vector<f32> r = {1.0f, 1.0f, 1.0f, 1.0f};
+    Sphere_Soa const s = {x.data(), y.data(), z.data(), r.data(), 4};
+
+    std::vector<u32> visible(4);
+    ASSERT_EQ(cull_spheres(m_frustum, s, visible.data()), 1);
+    EXPECT_EQ(visible[0], 0U); // in front. Others are behind, past the far plane and off to the side
+}
+
+TEST_F(CullingTest, aabbs_match_reference)
+{
+    std::vector<u32> expected;
+    for (s32 i = 0; i < num_volumes; ++i) {
+        if (is_box_visible(i)) { expected.push_back(static_cast<u32>(i)); }
+    }
+    ASSERT_FALSE(expected.empty());
+    ASSERT_LT(expected.size(), static_cast<size_t>(num_volumes));
+
+    std::vector<u32> visible(num_volumes);
+    s32 const n = cull_aabbs(m_frustum, boxes(), visible.data());
+    visible.resize(n);
+    EXPECT_EQ(visible, expected);
+}
+
+TEST_F(CullingTest, parallel_matches_serial)
+{
+    Cull_Config serial;
+    serial.parallel_threshold = num_volumes + 1;
+
+    Cull_Config parallel;
+    parallel.parallel_threshold = 0;
+    parallel.min_chunk_size = 1000;
+    parallel.max_threads = 4;
+
+    std::vector<u32> a(num_volumes);
+    std::vector<u32> b(num_volumes);
+    s32 const n_serial = cull_aabbs(m_frustum, boxes(), a.data(), serial);
+    s32 const n_parallel = cull_aabbs(m_frustum, boxes(), b.data(), parallel);
+    ASSERT_EQ(n_serial, n_parallel);
+    a.resize(n_serial);
+    b.resize(n_parallel);
+    EXPECT_EQ(a, b);
+
+    // Every volume may be visible, so the outputs need room for all of them
+    std::vector<u32> a_spheres(num_volumes);
+    std::vector<u32> b_spheres(num_volumes);
+    s32 const n_serial_spheres = cull_spheres(m_frustum, spheres(), a_spheres.data(), serial);
+    s32 const n_parallel_spheres = cull_spheres(m_frustum, spheres(), b_spheres.data(), parallel);
+    ASSERT_EQ(n_serial_spheres, n_parallel_spheres);
+    a_spheres.resize(n_serial_spheres);
+    b_spheres.resize(n_parallel_spheres);
+    EXPECT_EQ(a_spheres, b_spheres);
+}
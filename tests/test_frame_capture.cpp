@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/frame_capture.h"
+#include "core/status.h"
+#include "core/types.h"
+#include "core/utility/stb_image.h"
+#include "tests/common.h"
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+TEST(FrameCaptureTest, png_round_trips)
+{
+    // Large enough to need several stored deflate blocks
+    constexpr s32 width = 300;
+    constexpr s32 height = 100;
+    std::vector<u8> rgba(width * height * 4);
+    for (size_t i = 0; i < rgba.size(); ++i) { rgba[i] = static_cast<u8>(i * 7 + i / 1000); }
+
+    std::vector<u8> png;
+    ASSERT_EQ(encode_png(rgba.data(), width, height, png), Status::ok);
+
+    s32 decoded_width = 0;
+    s32 decoded_height = 0;
+    s32 channels = 0;
+    u8* decoded = stbi_load_from_memory(png.data(), static_cast<s32>(png.size()), &decoded_width,
+                                        &decoded_height, &channels, 4);
+    ASSERT_NE(decoded, nullptr) << stbi_failure_reason();
+    EXPECT_EQ(decoded_width, width);
+    EXPECT_EQ(decoded_height, height);
+    EXPECT_EQ(channels, 4);
+    EXPECT_EQ(std::vector<u8>(decoded, decoded + rgba.size()), rgba);
+    stbi_image_free(decoded);
+}
+
+TEST(FrameCaptureTest, rejects_empty_image)
+{
+    u8 const pixel[4] = {};
+    std::vector<u8> png;
+    EXPECT_EQ(encode_png(pixel, 0, 1, png), Status::invalid_value);
+}
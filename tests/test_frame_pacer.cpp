@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/frame_pacer.h"
+#include "core/status.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <chrono>
+
+using namespace rk;
+using namespace sds;
+
+TEST(FramePacerTest, rejects_negative_frame_rate)
+{
+    Frame_Pacer pacer;
+    EXPECT_EQ(pacer.initialize({-1.0f, false}), Status::invalid_value);
+}
+
+TEST(FramePacerTest, rejects_negative_log_interval)
+{
+    Frame_Pacer pacer;
+    EXPECT_EQ(pacer.initialize({0.0f, false, -1}), Status::invalid_value);
+}
+
+TEST(FramePacerTest, limits_frame_rate)
+{
+    constexpr s32 frames = 10;
+    constexpr f32 frame_rate = 200.0f; // 5 ms frames
+    Frame_Pacer pacer;
+    ASSERT_EQ(pacer.initialize({frame_rate, false}), Status::ok);
+    EXPECT_EQ(std::chrono::duration_cast<std::chrono::microseconds>(pacer.frame_period()).count(),
+              5000);
+
+    using Clock = Frame_Pacer::Clock;
+    Clock::time_point const start = Clock::now();
+    for (s32 i = 0; i < frames; ++i) {
+        pacer.wait_for_present();
+        ASSERT_EQ(pacer.end_present(), Status::ok);
+    }
+    f64 const elapsed_ms = std::chrono::duration<f64, std::milli>(Clock::now() - start).count();
+
+    // The first frame isn't held back
+    EXPECT_GE(elapsed_ms, (frames - 1) * 5.0 - 0.1);
+    EXPECT_EQ(pacer.present_interval().sample_count(), frames - 1);
+    EXPECT_EQ(pacer.jitter().sample_count(), frames - 2);
+    EXPECT_GE(pacer.present_interval().average(), 4.9f);
+    ASSERT_EQ(pacer.destroy(), Status::ok);
+}
+
+TEST(FramePacerTest, unlimited_does_not_wait)
+{
+    Frame_Pacer pacer;
+    ASSERT_EQ(pacer.initialize({}), Status::ok);
+    // No period to wait for. Measured intervals aren't checked, they depend on the machine's load.
+    EXPECT_EQ(pacer.frame_period(), Frame_Pacer::Clock::duration::zero());
+    for (s32 i = 0; i < 3; ++i) {
+        pacer.wait_for_present();
+        ASSERT_EQ(pacer.end_present(), Status::ok);
+    }
+    EXPECT_EQ(pacer.present_interval().sample_count(), 2);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "core/status.h"
+#include "core/types.h"
+#include "core/utility/frame_pipeline.h"
+#include "tests/common.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+TEST(FramePipelineTest, rejects_invalid_depth)
+{
+    Frame_Pipeline<s32> pipeline;
+    EXPECT_EQ(pipeline.initialize(0), Status::invalid_value);
+}
+
+TEST(FramePipelineTest, delivers_frames_in_order_within_depth)
+{
+    constexpr s32 depth = 2;
+    constexpr s32 frame_count = 2000;
+    Frame_Pipeline<s32> pipeline;
+    ASSERT_EQ(pipeline.initialize(depth), Status::ok);
+
+    std::atomic<s32> frames_read = 0;
+    std::vector<s32> received;
+    std::thread consumer([&]() {
+        while (s32 const* frame = pipeline.begin_read()) {
+            received.push_back(*frame);
+            pipeline.end_read();
+            ++frames_read;
+        }
+    });
+
+    // Failures don't return before the consumer is joined
+    for (s32 i = 0; i < frame_count; ++i) {
+        s32* frame = pipeline.begin_write();
+        EXPECT_NE(frame, nullptr);
+        if (!frame) { break; }
+        // Never more than depth frames ahead of the consumer
+        EXPECT_LE(i - frames_read.load(), depth);
+        *frame = i;
+        pipeline.end_write();
+    }
+    pipeline.close();
+    consumer.join();
+
+    ASSERT_EQ(static_cast<s32>(received.size()), frame_count);
+    for (s32 i = 0; i < frame_count; ++i) { ASSERT_EQ(received[i], i); }
+}
+
+TEST(FramePipelineTest, close_wakes_both_sides)
+{
+    Frame_Pipeline<s32> pipeline;
+    ASSERT_EQ(pipeline.initialize(1), Status::ok);
+
+    std::atomic<bool> waiting = false;
+    std::atomic<bool> closed = false;
+    std::thread consumer([&]() {
+        waiting = true;
+        // Nothing is written, only close returns this
+        EXPECT_EQ(pipeline.begin_read(), nullptr);
+        EXPECT_TRUE(closed.load());
+    });
+
+    // Give the consumer time to block in begin_read before closing
+    while (!waiting.load()) { std::this_thread::yield(); }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    closed = true;
+    pipeline.close();
+    consumer.join();
+    EXPECT_EQ(pipeline.begin_write(), nullptr);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/glyph_cache.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <limits>
+#include <vector>
+
+#ifndef RK_DATA_BASE_DIR
+#error "RK_DATA_BASE_DIR must be defined"
+#endif
+
+using namespace rk;
+using namespace sds;
+
+constexpr char const* font_path = RK_DATA_BASE_DIR "/assets/fonts/calibri/calibri-regular.ttf";
+constexpr s32 pixel_size = 32;
+constexpr Glyph_Cache::Render_Mode mode = Glyph_Cache::Render_Mode::bitmap;
+
+/**
+ * \brief Cache with an atlas of two small pages, without textures.
+ */
+RK_INTERNAL
+Status make_small_cache(Glyph_Cache& cache, Glyph_Cache::Font_Id& out_font)
+{
+    Glyph_Cache::Config config;
+    config.atlas.page_size = 64;
+    config.atlas.max_pages = 2;
+    config.atlas.textures = false;
+    RK_CHECK(cache.initialize(config));
+    return cache.load_font(font_path, out_font);
+}
+
+TEST(GlyphCacheTest, cached_glyph_is_not_rasterized_again)
+{
+    Glyph_Cache cache;
+    Glyph_Cache::Font_Id font = 0;
+    ASSERT_EQ(make_small_cache(cache, font), Status::ok);
+
+    Glyph_Cache::Glyph first;
+    Glyph_Cache::Glyph again;
+    ASSERT_EQ(cache.get(font, pixel_size, 'A', mode, first), Status::ok);
+    ASSERT_EQ(cache.get(font, pixel_size, 'A', mode, again), Status::ok);
+    EXPECT_EQ(cache.glyph_count(), 1);
+    EXPECT_EQ(again.page, first.page);
+    EXPECT_EQ(again.uv_min.x, first.uv_min.x);
+    EXPECT_EQ(again.uv_min.y, first.uv_min.y);
+    EXPECT_GT(first.size.x, 0);
+
+    // Other sizes are other glyphs
+    ASSERT_EQ(cache.get(font, pixel_size / 2, 'A', mode, again), Status::ok);
+    EXPECT_EQ(cache.glyph_count(), 2);
+    EXPECT_EQ(cache.destroy(), Status::ok);
+}
+
+TEST(GlyphCacheTest, full_atlas_evicts_the_least_recently_used_page)
+{
+    Glyph_Cache cache;
+    Glyph_Cache::Font_Id font = 0;
+    ASSERT_EQ(make_small_cache(cache, font), Status::ok);
+
+    // Fill the atlas in one batch. Its glyphs are in use, so nothing can be evicted.
+    std::vector<Glyph_Cache::Glyph> glyphs;
+    u32 codepoint = 'A';
+    for (;; ++codepoint) {
+        ASSERT_LE(codepoint, u32{'Z'});
+        Glyph_Cache::Glyph glyph;
+        Status const ret = cache.get(font, pixel_size, codepoint, mode, glyph);
+        if (ret == Status::buffer_length_error) { break; }
+        ASSERT_EQ(ret, Status::ok);
+        glyphs.push_back(glyph);
+    }
+    EXPECT_EQ(cache.eviction_count(), 0u);
+    ASSERT_EQ(glyphs.back().page, 1);
+    s32 page_0_glyphs = 0;
+    for (Glyph_Cache::Glyph const& glyph : glyphs) { page_0_glyphs += glyph.page == 0; }
+    ASSERT_GT(page_0_glyphs, 0);
+
+    // Keep page 1 in use in the next batch, page 0 is then the one evicted
+    cache.end_batch();
+    Glyph_Cache::Glyph glyph;
+    ASSERT_EQ(cache.get(font, pixel_size, 'A' + static_cast<u32>(glyphs.size()) - 1, mode, glyph),
+              Status::ok);
+    EXPECT_EQ(glyph.page, 1);
+    ASSERT_EQ(cache.get(font, pixel_size, codepoint, mode, glyph), Status::ok);
+    EXPECT_EQ(cache.eviction_count(), 1u);
+    EXPECT_EQ(glyph.page, 0);
+    // The evicted glyphs are gone from the cache
+    EXPECT_EQ(cache.glyph_count(), static_cast<s32>(glyphs.size()) - page_0_glyphs + 1);
+
+    // and rasterized again when requested
+    ASSERT_EQ(cache.get(font, pixel_size, 'A', mode, glyph), Status::ok);
+    EXPECT_EQ(cache.glyph_count(), static_cast<s32>(glyphs.size()) - page_0_glyphs + 2);
+    EXPECT_EQ(cache.destroy(), Status::ok);
+}
+
+TEST(GlyphCacheTest, full_atlas_in_use_has_no_page_to_evict)
+{
+    std::vector<u64> const last_used = {5, 5, 5, 5};
+    EXPECT_EQ(Glyph_Cache::least_recently_used_page(last_used, 5), -1);
+}
+
+TEST(GlyphCacheTest, full_atlas_evicts_a_page_once_the_batch_ends)
+{
+    // Every page was used by batch 5. Once it ends, the first of them is evicted.
+    std::vector<u64> last_used = {5, 5, 5, 5};
+    EXPECT_EQ(Glyph_Cache::least_recently_used_page(last_used, 6), 0);
+
+    // Evicted pages are reset, then the next evicted is the oldest other page
+    last_used = {6, 3, 5, 1};
+    EXPECT_EQ(Glyph_Cache::least_recently_used_page(last_used, 6), 3);
+    last_used[3] = 6;
+    EXPECT_EQ(Glyph_Cache::least_recently_used_page(last_used, 6), 1);
+}
+
+TEST(GlyphCacheTest, pinned_pages_are_never_evicted)
+{
+    u64 const pinned = std::numeric_limits<u64>::max();
+    std::vector<u64> const last_used = {pinned, 2, pinned};
+    EXPECT_EQ(Glyph_Cache::least_recently_used_page(last_used, 3), 1);
+    EXPECT_EQ(Glyph_Cache::least_recently_used_page({pinned, pinned}, 100), -1);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/indirect_mesh_renderer.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+TEST(IndirectMeshRendererTest, bounding_sphere_of_unit_cube)
+{
+    // clang-format off
+    std::array<f32, 8 * 3> const cube = {
+        -0.5f, -0.5f, -0.5f,   0.5f, -0.5f, -0.5f,   0.5f,  0.5f, -0.5f,  -0.5f,  0.5f, -0.5f,
+        -0.5f, -0.5f,  0.5f,   0.5f, -0.5f,  0.5f,   0.5f,  0.5f,  0.5f,  -0.5f,  0.5f,  0.5f,
+    };
+    // clang-format on
+    std::array<f32, 4> const sphere = mesh_bounding_sphere(cube.data(), 8);
+    EXPECT_FLOAT_EQ(sphere[0], 0.0f);
+    EXPECT_FLOAT_EQ(sphere[1], 0.0f);
+    EXPECT_FLOAT_EQ(sphere[2], 0.0f);
+    EXPECT_FLOAT_EQ(sphere[3], std::sqrt(0.75f));
+}
+
+TEST(IndirectMeshRendererTest, bounding_sphere_is_centered_on_bounding_box)
+{
+    // Most vertices at one end, the center is still the middle of the box
+    std::array<f32, 4 * 3> const positions = {
+        1.0f, 2.0f, 3.0f,  1.0f, 2.0f, 3.0f,  1.0f, 2.0f, 3.0f,  5.0f, 2.0f, 3.0f,
+    };
+    std::array<f32, 4> const sphere = mesh_bounding_sphere(positions.data(), 4);
+    EXPECT_FLOAT_EQ(sphere[0], 3.0f);
+    EXPECT_FLOAT_EQ(sphere[1], 2.0f);
+    EXPECT_FLOAT_EQ(sphere[2], 3.0f);
+    EXPECT_FLOAT_EQ(sphere[3], 2.0f);
+
+    std::array<f32, 3> const point = {-1.0f, 0.5f, 4.0f};
+    std::array<f32, 4> const point_sphere = mesh_bounding_sphere(point.data(), 1);
+    EXPECT_FLOAT_EQ(point_sphere[0], -1.0f);
+    EXPECT_FLOAT_EQ(point_sphere[3], 0.0f);
+}
+
+TEST(IndirectMeshRendererTest, base_instances_are_consecutive_ranges)
+{
+    using Draw_Command = Indirect_Mesh_Renderer::Draw_Command;
+    std::vector<u32> const counts = {3, 0, 5, 1};
+    std::vector<Draw_Command> commands(counts.size(), Draw_Command{6, 0, 0, 0, 99});
+
+    Indirect_Mesh_Renderer::assign_base_instances(counts, commands);
+    EXPECT_EQ(commands[0].base_instance, 0u);
+    EXPECT_EQ(commands[1].base_instance, 3u);
+    EXPECT_EQ(commands[2].base_instance, 3u);
+    EXPECT_EQ(commands[3].base_instance, 8u);
+    // Only the base instance changes
+    for (Draw_Command const& command : commands) {
+        EXPECT_EQ(command.count, 6u);
+        EXPECT_EQ(command.instance_count, 0u);
+    }
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "core/math/matrix.h"
+#include "core/math/quaternion.h"
+#include "core/math/vector.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <cmath>
+
+using namespace rk;
+using namespace sds;
+
+constexpr f32 pi = 3.14159265358979f;
+constexpr f32 epsilon = 1e-4f;
+
+RK_INTERNAL
+void expect_mat4_near(Mat4 const& a, Mat4 const& b)
+{
+    for (s32 i = 0; i < 16; ++i) { EXPECT_NEAR(a.data()[i], b.data()[i], epsilon) << "index " << i; }
+}
+
+RK_INTERNAL
+void expect_vector3_near(Vector3 const& a, Vector3 const& b)
+{
+    EXPECT_NEAR(a.x(), b.x(), epsilon);
+    EXPECT_NEAR(a.y(), b.y(), epsilon);
+    EXPECT_NEAR(a.z(), b.z(), epsilon);
+}
+
+RK_INTERNAL
+Mat4 make_test_matrix()
+{
+    return Mat4::from_trs(Vector3(1.0f, -2.0f, 3.0f),
+                          Quat::from_axis_angle(unit_vector(Vector3(1.0f, 2.0f, 3.0f)), 0.7f),
+                          Vector3(2.0f, 0.5f, 1.5f));
+}
+
+TEST(Mat4Test, layout_is_column_major)
+{
+    Mat4 const t = Mat4::translation(Vector3(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(t.data()[12], 1.0f);
+    EXPECT_EQ(t.data()[13], 2.0f);
+    EXPECT_EQ(t.data()[14], 3.0f);
+    EXPECT_EQ(t(0, 3), 1.0f);
+}
+
+TEST(Mat4Test, multiply_identity)
+{
+    Mat4 const m = make_test_matrix();
+    expect_mat4_near(m * Mat4::identity(), m);
+    expect_mat4_near(Mat4::identity() * m, m);
+}
+
+TEST(Mat4Test, multiply)
+{
+    Mat4 const a = make_test_matrix();
+    Mat4 const b = Mat4::perspective(1.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+    Mat4 const r = a * b;
+
+    for (s32 row = 0; row < 4; ++row) {
+        for (s32 col = 0; col < 4; ++col) {
+            f32 expected = 0.0f;
+            for (s32 k = 0; k < 4; ++k) { expected += a(row, k) * b(k, col); }
+            EXPECT_NEAR(r(row, col), expected, epsilon);
+        }
+    }
+}
+
+TEST(Mat4Test, inverse)
+{
+    Mat4 const m = make_test_matrix();
+    expect_mat4_near(m * m.inverse(), Mat4::identity());
+    expect_mat4_near(m.inverse() * m, Mat4::identity());
+
+    Mat4 const p = Mat4::perspective(1.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+    expect_mat4_near(p * p.inverse(), Mat4::identity());
+}
+
+TEST(Mat4Test, transposed)
+{
+    Mat4 const m = make_test_matrix();
+    Mat4 const t = m.transposed();
+    for (s32 row = 0; row < 4; ++row) {
+        for (s32 col = 0; col < 4; ++col) { EXPECT_EQ(t(row, col), m(col, row)); }
+    }
+}
+
+TEST(Mat4Test, determinant)
+{
+    EXPECT_NEAR(Mat4::identity().determinant(), 1.0f, epsilon);
+    EXPECT_NEAR(Mat4::scaling(Vector3(2.0f, 3.0f, 4.0f)).determinant(), 24.0f, epsilon);
+    EXPECT_NEAR(make_test_matrix().determinant(), 2.0f * 0.5f * 1.5f, epsilon);
+}
+
+TEST(Mat4Test, orthographic)
+{
+    Mat4 const o = Mat4::orthographic(0.0f, 800.0f, 0.0f, 600.0f);
+    expect_vector3_near(transform_point(o, Vector3(0.0f, 0.0f, 0.0f)), Vector3(-1.0f, -1.0f, 0.0f));
+    expect_vector3_near(transform_point(o, Vector3(800.0f, 600.0f, 0.0f)),
+                        Vector3(1.0f, 1.0f, 0.0f));
+}
+
+TEST(Mat4Test, from_trs_matches_composition)
+{
+    Vector3 const t(1.0f, -2.0f, 3.0f);
+    Quat const r = Quat::from_axis_angle(Vector3(0.0f, 1.0f, 0.0f), 0.3f);
+    Vector3 const s(2.0f, 0.5f, 1.5f);
+
+    expect_mat4_near(Mat4::from_trs(t, r, s),
+                     Mat4::translation(t) * Mat4::rotation(r) * Mat4::scaling(s));
+}
+
+TEST(QuatTest, compose)
+{
+    Quat const a = Quat::from_axis_angle(Vector3(0.0f, 0.0f, 1.0f), pi / 2.0f);
+    Quat const b = Quat::from_axis_angle(Vector3(1.0f, 0.0f, 0.0f), pi / 2.0f);
+    Vector3 const v(1.0f, 2.0f, 3.0f);
+
+    // a * b applies b first
+    expect_vector3_near((a * b).rotate(v), a.rotate(b.rotate(v)));
+    expect_mat4_near((a * b).to_mat4(), a.to_mat4() * b.to_mat4());
+}
+
+TEST(QuatTest, rotate)
+{
+    Quat const q = Quat::from_axis_angle(Vector3(0.0f, 0.0f, 1.0f), pi / 2.0f);
+    expect_vector3_near(q.rotate(Vector3(1.0f, 0.0f, 0.0f)), Vector3(0.0f, 1.0f, 0.0f));
+    expect_vector3_near(transform_vector(q.to_mat4(), Vector3(1.0f, 0.0f, 0.0f)),
+                        Vector3(0.0f, 1.0f, 0.0f));
+}
+
+TEST(QuatTest, inverse)
+{
+    Quat const q = normalize(Quat(0.3f, -0.2f, 0.5f, 0.8f));
+    Quat const i = q * q.inverse();
+    EXPECT_NEAR(i.x(), 0.0f, epsilon);
+    EXPECT_NEAR(i.y(), 0.0f, epsilon);
+    EXPECT_NEAR(i.z(), 0.0f, epsilon);
+    EXPECT_NEAR(i.w(), 1.0f, epsilon);
+}
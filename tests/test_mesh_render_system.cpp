@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include "core/ecs/components/transform_component.h"
+#include "core/ecs/systems/mesh_render_system.h"
+#include "core/status.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <array>
+
+using namespace rk;
+using namespace rk::ecs;
+using namespace sds;
+
+RK_INTERNAL
+void expect_dirty(Mesh_Instances const& instances, s32 begin, s32 end)
+{
+    EXPECT_EQ(instances.dirty_begin(), begin);
+    EXPECT_EQ(instances.dirty_end(), end);
+}
+
+TEST(MeshInstancesTest, added_instances_are_dirty)
+{
+    std::array<Transform_Component, 3> transforms;
+    Mesh_Instances instances;
+    for (Transform_Component const& t : transforms) {
+        ASSERT_EQ(instances.add(&t), Status::ok);
+    }
+    EXPECT_EQ(instances.count(), 3);
+    expect_dirty(instances, 0, 3);
+
+    instances.clear_dirty();
+    instances.update();
+    expect_dirty(instances, 0, 0);
+}
+
+TEST(MeshInstancesTest, update_marks_changed_transforms)
+{
+    std::array<Transform_Component, 5> transforms;
+    Mesh_Instances instances;
+    for (Transform_Component const& t : transforms) {
+        ASSERT_EQ(instances.add(&t), Status::ok);
+    }
+    instances.clear_dirty();
+
+    transforms[1].position = {1.0f, 2.0f, 3.0f};
+    transforms[3].scale = {2.0f, 2.0f, 2.0f};
+    instances.update();
+    expect_dirty(instances, 1, 4);
+    EXPECT_EQ(instances.models()[1], Mat4::from_trs(transforms[1].position, transforms[1].rotation,
+                                                    transforms[1].scale));
+
+    // Only changes since the last update count
+    instances.clear_dirty();
+    instances.update();
+    expect_dirty(instances, 0, 0);
+}
+
+TEST(MeshInstancesTest, removing_from_the_middle_moves_the_last_instance)
+{
+    std::array<Transform_Component, 4> transforms;
+    for (s32 i = 0; i < 4; ++i) { transforms[i].position = {static_cast<f32>(i), 0.0f, 0.0f}; }
+    Mesh_Instances instances;
+    for (Transform_Component const& t : transforms) {
+        ASSERT_EQ(instances.add(&t), Status::ok);
+    }
+    instances.clear_dirty();
+
+    EXPECT_TRUE(instances.remove(&transforms[1]));
+    EXPECT_EQ(instances.count(), 3);
+    // Only the moved matrix is uploaded again
+    expect_dirty(instances, 1, 2);
+    EXPECT_EQ(instances.models()[1], Mat4::from_trs(transforms[3].position, transforms[3].rotation,
+                                                    transforms[3].scale));
+
+    // The moved instance still follows its transform
+    instances.clear_dirty();
+    transforms[3].position = {5.0f, 0.0f, 0.0f};
+    instances.update();
+    expect_dirty(instances, 1, 2);
+}
+
+TEST(MeshInstancesTest, removing_the_last_instance_shrinks_the_dirty_range)
+{
+    std::array<Transform_Component, 4> transforms;
+    Mesh_Instances instances;
+    for (Transform_Component const& t : transforms) {
+        ASSERT_EQ(instances.add(&t), Status::ok);
+    }
+    instances.clear_dirty();
+
+    transforms[3].position = {1.0f, 0.0f, 0.0f};
+    instances.update();
+    expect_dirty(instances, 3, 4);
+    // Nothing is left to upload for the removed instance
+    EXPECT_TRUE(instances.remove(&transforms[3]));
+    EXPECT_EQ(instances.count(), 3);
+    expect_dirty(instances, 3, 3);
+
+    transforms[0].position = {1.0f, 0.0f, 0.0f};
+    transforms[2].position = {1.0f, 0.0f, 0.0f};
+    instances.update();
+    expect_dirty(instances, 0, 3);
+    EXPECT_TRUE(instances.remove(&transforms[2]));
+    expect_dirty(instances, 0, 2);
+
+    EXPECT_FALSE(instances.remove(&transforms[2]));
+    EXPECT_EQ(instances.count(), 2);
+}
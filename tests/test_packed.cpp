@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include "core/math/packed.h"
+#include "core/math/vector.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+class PackedTest : public ::testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        std::mt19937 rng(4321);
+        std::uniform_real_distribution<f32> dist(-1.0f, 1.0f);
+        for (s32 i = 0; i < num_values; ++i) {
+            Vector3 const v(dist(rng), dist(rng), dist(rng));
+            m_values.push_back(v * 100.0f);
+            m_units.push_back(v.squared_length() > 0.0f ? unit_vector(v)
+                                                        : Vector3(0.0f, 0.0f, 1.0f));
+        }
+
+        // Axes and octahedron edges, where octahedral folding is most delicate
+        m_units[0] = Vector3(0.0f, 0.0f, -1.0f);
+        m_units[1] = Vector3(-1.0f, 0.0f, 0.0f);
+        m_units[2] = unit_vector(Vector3(1.0f, -1.0f, 0.0f));
+        m_units[3] = unit_vector(Vector3(-1.0f, -1.0f, -1.0f));
+    }
+
+    static constexpr s32 num_values = 1027; // not a multiple of the SIMD width
+    std::vector<Vector3> m_values;
+    std::vector<Vector3> m_units;
+};
+
+TEST(HalfTest, all_halves_round_trip)
+{
+    for (u32 i = 0; i <= 0xffffU; ++i) {
+        u16 const h = static_cast<u16>(i);
+        f32 const f = half_to_f32(h);
+        if (std::isnan(f)) {
+            EXPECT_TRUE(std::isnan(half_to_f32(f32_to_half(f))));
+        } else {
+            ASSERT_EQ(f32_to_half(f), h) << i;
+        }
+    }
+}
+
+TEST(HalfTest, special_values)
+{
+    EXPECT_EQ(f32_to_half(0.0f), 0x0000);
+    EXPECT_EQ(f32_to_half(-0.0f), 0x8000);
+    EXPECT_EQ(f32_to_half(1.0f), 0x3c00);
+    EXPECT_EQ(f32_to_half(-2.0f), 0xc000);
+    EXPECT_EQ(f32_to_half(65504.0f), 0x7bff);                          // max half
+    EXPECT_EQ(f32_to_half(1e6f), 0x7c00);                              // overflow
+    EXPECT_EQ(f32_to_half(std::numeric_limits<f32>::infinity()), 0x7c00);
+    EXPECT_EQ(f32_to_half(std::ldexp(1.0f, -24)), 0x0001);             // min subnormal
+    EXPECT_EQ(f32_to_half(std::ldexp(1.0f, -26)), 0x0000);             // underflow
+    EXPECT_EQ(f32_to_half(1.0f + std::ldexp(1.0f, -11)), 0x3c00);      // tie, to even
+    EXPECT_EQ(f32_to_half(1.0f + 3.0f * std::ldexp(1.0f, -11)), 0x3c02); // tie, to even
+    EXPECT_TRUE(std::isnan(half_to_f32(f32_to_half(std::numeric_limits<f32>::quiet_NaN()))));
+}
+
+TEST_F(PackedTest, half_arrays_match_scalar)
+{
+    std::vector<Half_Vector3> packed(num_values);
+    std::vector<Vector3> unpacked(num_values);
+    pack_half(m_values.data(), packed.data(), num_values);
+    unpack(packed.data(), unpacked.data(), num_values);
+
+    for (s32 i = 0; i < num_values; ++i) {
+        ASSERT_EQ(packed[i].v, pack_half(m_values[i]).v) << i;
+        ASSERT_EQ(unpacked[i], unpack(packed[i])) << i;
+        for (s32 c = 0; c < 3; ++c) {
+            EXPECT_NEAR(unpacked[i][c], m_values[i][c], std::abs(m_values[i][c]) / 1024.0f);
+        }
+    }
+}
+
+TEST_F(PackedTest, snorm16_arrays_match_scalar)
+{
+    std::vector<Snorm16_Vector3> packed(num_values);
+    std::vector<Vector3> unpacked(num_values);
+    pack_snorm16(m_units.data(), packed.data(), num_values);
+    unpack(packed.data(), unpacked.data(), num_values);
+
+    for (s32 i = 0; i < num_values; ++i) {
+        ASSERT_EQ(packed[i].v, pack_snorm16(m_units[i]).v) << i;
+        ASSERT_EQ(unpacked[i], unpack(packed[i])) << i;
+        for (s32 c = 0; c < 3; ++c) {
+            EXPECT_NEAR(unpacked[i][c], m_units[i][c], 0.5f / 32767.0f);
+        }
+    }
+
+    Snorm16_Vector3 const clamped = pack_snorm16(Vector3(2.0f, -2.0f, 0.0f));
+    EXPECT_EQ(clamped.v[0], 32767);
+    EXPECT_EQ(clamped.v[1], -32767);
+}
+
+TEST_F(PackedTest, octahedral_arrays_match_scalar)
+{
+    std::vector<Octahedral_Vector3> packed(num_values);
+    std::vector<Vector3> unpacked(num_values);
+    pack_octahedral(m_units.data(), packed.data(), num_values);
+    unpack(packed.data(), unpacked.data(), num_values);
+
+    for (s32 i = 0; i < num_values; ++i) {
+        ASSERT_EQ(packed[i].v, pack_octahedral(m_units[i]).v) << i;
+        Vector3 const scalar = unpack(packed[i]);
+        for (s32 c = 0; c < 3; ++c) { ASSERT_NEAR(unpacked[i][c], scalar[c], 1e-6f) << i; }
+
+        EXPECT_NEAR(unpacked[i].length(), 1.0f, 1e-5f);
+        // acos is too imprecise near 1, the cross product is not
+        f32 const angle = cross(unpacked[i], m_units[i]).length();
+        EXPECT_LT(angle, 1e-4f) << i;
+    }
+}
+
+TEST_F(PackedTest, fixed16_arrays_match_scalar)
+{
+    Fixed_Point_Cell cell;
+    cell.origin = Vector3(-100.0f, -100.0f, -100.0f);
+    cell.size = 200.0f;
+    f32 const step = cell.size / 65535.0f;
+
+    std::vector<Fixed16_Vector3> packed(num_values);
+    std::vector<Vector3> unpacked(num_values);
+    pack_fixed16(m_values.data(), packed.data(), num_values, cell);
+    unpack(packed.data(), unpacked.data(), num_values, cell);
+
+    for (s32 i = 0; i < num_values; ++i) {
+        ASSERT_EQ(packed[i].v, pack_fixed16(m_values[i], cell).v) << i;
+        Vector3 const scalar = unpack(packed[i], cell);
+        for (s32 c = 0; c < 3; ++c) {
+            ASSERT_NEAR(unpacked[i][c], scalar[c], 1e-5f) << i;
+            EXPECT_NEAR(unpacked[i][c], m_values[i][c], 0.5f * step + 1e-4f);
+        }
+    }
+
+    Fixed16_Vector3 const clamped = pack_fixed16(Vector3(-500.0f, 500.0f, 0.0f), cell);
+    EXPECT_EQ(clamped.v[0], 0);
+    EXPECT_EQ(clamped.v[1], 65535);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/opengl/program_binary.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+constexpr u64 test_key = 0x0123456789ABCDEFull;
+
+RK_INTERNAL
+std::vector<u8> make_test_binary(std::array<u8, 5> const& data)
+{
+    Program_Binary binary;
+    binary.binary_format = 0x8E21;
+    binary.binary = data.data();
+    binary.binary_size = static_cast<u32>(data.size());
+    std::vector<u8> out;
+    EXPECT_EQ(serialize_program_binary(test_key, binary, out), Status::ok);
+    return out;
+}
+
+TEST(ProgramBinaryTest, round_trip)
+{
+    std::array<u8, 5> const data = {1, 2, 3, 4, 5};
+    std::vector<u8> const file = make_test_binary(data);
+    ASSERT_EQ(file.size(), sizeof(Program_Binary_Header) + data.size());
+
+    Program_Binary parsed;
+    ASSERT_EQ(parse_program_binary(file.data(), file.size(), test_key, parsed), Status::ok);
+    EXPECT_EQ(parsed.binary_format, 0x8E21u);
+    ASSERT_EQ(parsed.binary_size, data.size());
+    EXPECT_EQ(std::memcmp(parsed.binary, data.data(), data.size()), 0);
+}
+
+TEST(ProgramBinaryTest, rejects_other_key)
+{
+    std::vector<u8> const file = make_test_binary({1, 2, 3, 4, 5});
+    Program_Binary parsed;
+    EXPECT_EQ(parse_program_binary(file.data(), file.size(), test_key + 1, parsed),
+              Status::invalid_value);
+}
+
+TEST(ProgramBinaryTest, rejects_truncated_and_corrupt_data)
+{
+    std::vector<u8> file = make_test_binary({1, 2, 3, 4, 5});
+    Program_Binary parsed;
+    EXPECT_EQ(parse_program_binary(file.data(), file.size() - 1, test_key, parsed),
+              Status::invalid_value);
+    EXPECT_EQ(parse_program_binary(file.data(), sizeof(Program_Binary_Header) - 1, test_key,
+                                   parsed),
+              Status::invalid_value);
+    EXPECT_EQ(parse_program_binary(nullptr, 0, test_key, parsed), Status::invalid_value);
+
+    std::vector<u8> bad_version = file;
+    bad_version[4] = 99;
+    EXPECT_EQ(parse_program_binary(bad_version.data(), bad_version.size(), test_key, parsed),
+              Status::invalid_value);
+
+    file[0] = 'X';
+    EXPECT_EQ(parse_program_binary(file.data(), file.size(), test_key, parsed),
+              Status::invalid_value);
+}
+
+TEST(ProgramBinaryTest, key_depends_on_every_part)
+{
+    u64 const key = program_binary_key_append(
+        program_binary_key_append(program_binary_key_seed, "vendor"), "void main() {}");
+    EXPECT_EQ(key, program_binary_key_append(
+                       program_binary_key_append(program_binary_key_seed, "vendor"),
+                       "void main() {}"));
+    EXPECT_NE(key, program_binary_key_append(
+                       program_binary_key_append(program_binary_key_seed, "vendor2"),
+                       "void main() {}"));
+    EXPECT_NE(key, program_binary_key_append(
+                       program_binary_key_append(program_binary_key_seed, "vendor"),
+                       "void main() { }"));
+
+    // Text moved between parts changes the key
+    EXPECT_NE(program_binary_key_append(program_binary_key_append(program_binary_key_seed, "ab"),
+                                        "c"),
+              program_binary_key_append(program_binary_key_append(program_binary_key_seed, "a"),
+                                        "bc"));
+}
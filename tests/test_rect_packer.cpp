@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/rect_packer.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <random>
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+RK_INTERNAL
+bool overlaps(Rect const& a, Rect const& b)
+{
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+           b.y < a.y + a.height;
+}
+
+RK_INTERNAL
+bool inside(Rect const& r, s32 width, s32 height)
+{
+    return r.x >= 0 && r.y >= 0 && r.x + r.width <= width && r.y + r.height <= height;
+}
+
+TEST(RectPackerTest, rejects_invalid_sizes)
+{
+    Rect_Packer packer;
+    ASSERT_EQ(packer.initialize(64, 32), Status::ok);
+
+    Rect r;
+    EXPECT_FALSE(packer.pack(0, 4, r));
+    EXPECT_FALSE(packer.pack(4, 0, r));
+    EXPECT_FALSE(packer.pack(65, 4, r));
+    EXPECT_FALSE(packer.pack(4, 33, r));
+    EXPECT_EQ(packer.used_area(), 0);
+}
+
+TEST(RectPackerTest, fills_exactly)
+{
+    Rect_Packer packer;
+    ASSERT_EQ(packer.initialize(64, 64), Status::ok);
+
+    // 16 tiles fill the area with no space left over
+    std::vector<Rect> rects;
+    for (s32 i = 0; i < 16; ++i) {
+        Rect r;
+        ASSERT_TRUE(packer.pack(16, 16, r)) << "tile " << i;
+        rects.push_back(r);
+    }
+    EXPECT_EQ(packer.used_area(), 64 * 64);
+
+    Rect r;
+    EXPECT_FALSE(packer.pack(1, 1, r));
+
+    for (size_t i = 0; i < rects.size(); ++i) {
+        EXPECT_TRUE(inside(rects[i], 64, 64));
+        for (size_t j = i + 1; j < rects.size(); ++j) {
+            EXPECT_FALSE(overlaps(rects[i], rects[j]));
+        }
+    }
+}
+
+TEST(RectPackerTest, bottom_left_placement)
+{
+    Rect_Packer packer;
+    ASSERT_EQ(packer.initialize(100, 100), Status::ok);
+
+    Rect a, b, c;
+    ASSERT_TRUE(packer.pack(60, 20, a));
+    ASSERT_TRUE(packer.pack(30, 10, b));
+    EXPECT_EQ(a.x, 0);
+    EXPECT_EQ(a.y, 0);
+    EXPECT_EQ(b.x, 60);
+    EXPECT_EQ(b.y, 0);
+
+    // Too wide for the gap to the right of `b`, so it rests on top of `a` and `b`
+    ASSERT_TRUE(packer.pack(80, 5, c));
+    EXPECT_EQ(c.x, 0);
+    EXPECT_EQ(c.y, 20);
+}
+
+TEST(RectPackerTest, random_rects_never_overlap)
+{
+    constexpr s32 size = 512;
+    Rect_Packer packer;
+    ASSERT_EQ(packer.initialize(size, size), Status::ok);
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<s32> dim(1, 48);
+    std::vector<Rect> rects;
+    s64 area = 0;
+    for (s32 i = 0; i < 2000; ++i) {
+        Rect r;
+        if (packer.pack(dim(rng), dim(rng), r)) {
+            rects.push_back(r);
+            area += static_cast<s64>(r.width) * r.height;
+        }
+    }
+    EXPECT_EQ(packer.used_area(), area);
+    // Skyline packing of small rects should reach a reasonable occupancy
+    EXPECT_GT(area, size * size / 2);
+
+    for (size_t i = 0; i < rects.size(); ++i) {
+        ASSERT_TRUE(inside(rects[i], size, size));
+        for (size_t j = i + 1; j < rects.size(); ++j) {
+            ASSERT_FALSE(overlaps(rects[i], rects[j])) << i << " and " << j;
+        }
+    }
+}
+
+TEST(RectPackerTest, clear)
+{
+    Rect_Packer packer;
+    ASSERT_EQ(packer.initialize(32, 32), Status::ok);
+
+    Rect r;
+    ASSERT_TRUE(packer.pack(32, 32, r));
+    EXPECT_FALSE(packer.pack(1, 1, r));
+
+    packer.clear();
+    EXPECT_EQ(packer.used_area(), 0);
+    ASSERT_TRUE(packer.pack(32, 32, r));
+    EXPECT_EQ(r.x, 0);
+    EXPECT_EQ(r.y, 0);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/render_queue.h"
+#include "core/status.h"
+#include "core/types.h"
+#include "core/utility/parallel_for.h"
+#include "tests/common.h"
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+RK_INTERNAL
+Draw_Packet make_packet(u32 program, u32 texture)
+{
+    Draw_Packet packet;
+    packet.program = program;
+    packet.vao = 1;
+    packet.texture = texture;
+    packet.count = 6;
+    return packet;
+}
+
+TEST(RenderQueueTest, command_buffer_records_and_clears)
+{
+    Render_Command_Buffer buffer;
+    ASSERT_EQ(buffer.reserve(4), Status::ok);
+    EXPECT_EQ(buffer.packet_count(), 0);
+
+    for (s32 i = 0; i < 10; ++i) {
+        ASSERT_EQ(buffer.submit(make_packet(1, i), 0, 0.5f), Status::ok);
+    }
+    EXPECT_EQ(buffer.packet_count(), 10);
+
+    buffer.clear();
+    EXPECT_EQ(buffer.packet_count(), 0);
+}
+
+TEST(RenderQueueTest, merges_buffers_recorded_concurrently)
+{
+    constexpr s32 packet_count = 10000;
+    constexpr s32 max_chunks = 8;
+    std::vector<Render_Command_Buffer> buffers(max_chunks);
+    std::vector<Status> results(max_chunks, Status::ok);
+
+    // Each packet is told apart by its base instance. Programs alternate so the sort has two
+    // groups, and within a group every key ties.
+    s32 const num_chunks =
+        parallel_for_chunks(packet_count, max_chunks, [&](s32 chunk, s32 begin, s32 end) {
+            for (s32 i = begin; i < end; ++i) {
+                Draw_Packet packet = make_packet(1 + i % 2, 1);
+                packet.base_instance = static_cast<u32>(i);
+                Status const ret = buffers[chunk].submit(packet, 0, 0.5f);
+                if (ret != Status::ok) { results[chunk] = ret; }
+            }
+        });
+    ASSERT_GT(num_chunks, 1);
+
+    Render_Queue queue;
+    ASSERT_EQ(queue.initialize(0), Status::ok);
+    s32 recorded = 0;
+    for (s32 chunk = 0; chunk < num_chunks; ++chunk) {
+        ASSERT_EQ(results[chunk], Status::ok);
+        recorded += buffers[chunk].packet_count();
+        ASSERT_EQ(queue.merge(buffers[chunk]), Status::ok);
+        EXPECT_EQ(buffers[chunk].packet_count(), 0);
+    }
+    EXPECT_EQ(recorded, packet_count);
+    ASSERT_EQ(queue.packet_count(), packet_count);
+
+    // Chunks cover consecutive ranges, so merging in chunk order gives recording order
+    std::vector<u32> merged;
+    for (Draw_Packet const& packet : queue.packets()) { merged.push_back(packet.base_instance); }
+    std::vector<u32> expected_merged(packet_count);
+    for (s32 i = 0; i < packet_count; ++i) { expected_merged[i] = static_cast<u32>(i); }
+    EXPECT_EQ(merged, expected_merged);
+
+    // The first program seen sorts first, and tied keys keep the merged order
+    ASSERT_EQ(queue.sort(), Status::ok);
+    std::vector<u32> sorted;
+    for (u32 index : queue.draw_order()) {
+        sorted.push_back(queue.packets()[index].base_instance);
+    }
+    std::vector<u32> expected_sorted;
+    for (s32 i = 0; i < packet_count; i += 2) { expected_sorted.push_back(static_cast<u32>(i)); }
+    for (s32 i = 1; i < packet_count; i += 2) { expected_sorted.push_back(static_cast<u32>(i)); }
+    EXPECT_EQ(sorted, expected_sorted);
+
+    EXPECT_EQ(queue.destroy(), Status::ok);
+}
+
+TEST(RenderQueueTest, sorting_again_gives_the_same_order)
+{
+    Render_Queue queue;
+    ASSERT_EQ(queue.initialize(0), Status::ok);
+    for (u32 i = 0; i < 6; ++i) {
+        ASSERT_EQ(queue.submit(make_packet(1 + i % 2, 1), 0, 0.5f), Status::ok);
+    }
+
+    std::vector<u32> const expected = {0, 2, 4, 1, 3, 5};
+    ASSERT_EQ(queue.sort(), Status::ok);
+    EXPECT_EQ(queue.draw_order(), expected);
+    ASSERT_EQ(queue.sort(), Status::ok);
+    EXPECT_EQ(queue.draw_order(), expected);
+
+    // A packet submitted after sorting is sorted with its own key
+    ASSERT_EQ(queue.submit(make_packet(1, 1), 0, 0.5f), Status::ok);
+    ASSERT_EQ(queue.sort(), Status::ok);
+    std::vector<u32> const expected_after_submit = {0, 2, 4, 6, 1, 3, 5};
+    EXPECT_EQ(queue.draw_order(), expected_after_submit);
+
+    EXPECT_EQ(queue.destroy(), Status::ok);
+}
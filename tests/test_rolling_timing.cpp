@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/rolling_timing.h"
+#include "core/types.h"
+#include "tests/common.h"
+
+using namespace rk;
+using namespace sds;
+
+TEST(RollingTimingTest, empty_is_zero)
+{
+    Rolling_Timing timing;
+    EXPECT_EQ(timing.sample_count(), 0);
+    EXPECT_EQ(timing.last(), 0.0f);
+    EXPECT_EQ(timing.average(), 0.0f);
+    EXPECT_EQ(timing.max(), 0.0f);
+}
+
+TEST(RollingTimingTest, averages_partial_window)
+{
+    Rolling_Timing timing;
+    timing.add(1.0f);
+    timing.add(4.0f);
+    timing.add(1.0f);
+    EXPECT_EQ(timing.sample_count(), 3);
+    EXPECT_EQ(timing.last(), 1.0f);
+    EXPECT_FLOAT_EQ(timing.average(), 2.0f);
+    EXPECT_EQ(timing.max(), 4.0f);
+}
+
+TEST(RollingTimingTest, forgets_samples_older_than_window)
+{
+    Rolling_Timing timing;
+    timing.add(100.0f);
+    for (s32 i = 0; i < Rolling_Timing::window_size; ++i) { timing.add(2.0f); }
+    EXPECT_EQ(timing.sample_count(), Rolling_Timing::window_size);
+    EXPECT_FLOAT_EQ(timing.average(), 2.0f);
+    EXPECT_EQ(timing.max(), 2.0f);
+}
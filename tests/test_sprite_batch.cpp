@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/sprite_batch.h"
+#include "core/status.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+TEST(SpriteBatchTest, key_orders_layers_first)
+{
+    u64 const low = make_sprite_sort_key(-1, max_sprite_texture_slots - 1, 100);
+    u64 const high = make_sprite_sort_key(0, 0, 0);
+    EXPECT_LT(low, high);
+    EXPECT_LT(make_sprite_sort_key(std::numeric_limits<s16>::min(), 0, 0),
+              make_sprite_sort_key(std::numeric_limits<s16>::max(), 0, 0));
+}
+
+TEST(SpriteBatchTest, key_orders_textures_then_added_order_within_a_layer)
+{
+    EXPECT_LT(make_sprite_sort_key(2, 0, 9), make_sprite_sort_key(2, 1, 0));
+    EXPECT_LT(make_sprite_sort_key(2, 1, 3), make_sprite_sort_key(2, 1, 4));
+}
+
+TEST(SpriteBatchTest, key_keeps_index)
+{
+    EXPECT_EQ(sprite_sort_key_index(make_sprite_sort_key(-5, 7, 0xFFFF'FFFFu)), 0xFFFF'FFFFu);
+    EXPECT_EQ(sprite_sort_key_index(make_sprite_sort_key(5, 0, 42)), 42u);
+}
+
+TEST(SpriteBatchTest, sort_groups_textures_and_keeps_added_order_per_texture)
+{
+    struct Added {
+        s16 layer;
+        u32 slot;
+    };
+    // Index is the position in this list
+    std::vector<Added> const added = {
+        {1, 0}, {0, 1}, {0, 0}, {1, 1}, {0, 1}, {1, 0}, {0, 0},
+    };
+    std::vector<u64> keys;
+    for (size_t i = 0; i < added.size(); ++i) {
+        keys.push_back(make_sprite_sort_key(added[i].layer, added[i].slot, static_cast<u32>(i)));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<u32> order;
+    for (u64 key : keys) { order.push_back(sprite_sort_key_index(key)); }
+    // Layer 0: texture 0 (2, 6), texture 1 (1, 4). Layer 1: texture 0 (0, 5), texture 1 (3).
+    std::vector<u32> const expected = {2, 6, 1, 4, 0, 5, 3};
+    EXPECT_EQ(order, expected);
+}
+
+/**
+ * \brief Sprite at x = \a x, so its instance can be told apart.
+ */
+RK_INTERNAL
+Sprite make_sprite(f32 x, u32 texture_id, s16 layer)
+{
+    Sprite sprite;
+    sprite.position = {x, 0.0f};
+    sprite.size = {1.0f, 1.0f};
+    sprite.texture_id = texture_id;
+    sprite.layer = layer;
+    return sprite;
+}
+
+/**
+ * \brief Build \a batch and return the x positions of its instances, in draw order.
+ */
+RK_INTERNAL
+std::vector<f32> build_positions(Sprite_Batch& batch)
+{
+    std::vector<Sprite_Batch::Instance> instances(batch.sprite_count());
+    EXPECT_EQ(batch.build(instances.data()), Status::ok);
+    std::vector<f32> positions;
+    for (Sprite_Batch::Instance const& instance : instances) { positions.push_back(instance.x); }
+    return positions;
+}
+
+RK_INTERNAL
+void expect_run(Sprite_Batch::Run const& run, u32 texture_id, s32 first, s32 count)
+{
+    EXPECT_EQ(run.texture_id, texture_id);
+    EXPECT_EQ(run.first, first);
+    EXPECT_EQ(run.count, count);
+}
+
+TEST(SpriteBatchTest, merges_consecutive_sprites_with_the_same_texture)
+{
+    Sprite_Batch batch;
+    for (s32 i = 0; i < 4; ++i) {
+        ASSERT_EQ(batch.add(make_sprite(static_cast<f32>(i), 7, 0)), Status::ok);
+    }
+
+    std::vector<f32> const expected = {0.0f, 1.0f, 2.0f, 3.0f};
+    EXPECT_EQ(build_positions(batch), expected);
+    ASSERT_EQ(batch.runs().size(), 1u);
+    expect_run(batch.runs()[0], 7, 0, 4);
+}
+
+TEST(SpriteBatchTest, splits_runs_when_the_texture_changes)
+{
+    Sprite_Batch batch;
+    // Textures alternate within a layer, they're grouped into one run each
+    ASSERT_EQ(batch.add(make_sprite(0.0f, 1, 0)), Status::ok);
+    ASSERT_EQ(batch.add(make_sprite(1.0f, 2, 0)), Status::ok);
+    ASSERT_EQ(batch.add(make_sprite(2.0f, 1, 0)), Status::ok);
+    ASSERT_EQ(batch.add(make_sprite(3.0f, 2, 0)), Status::ok);
+
+    std::vector<f32> const expected = {0.0f, 2.0f, 1.0f, 3.0f};
+    EXPECT_EQ(build_positions(batch), expected);
+    ASSERT_EQ(batch.runs().size(), 2u);
+    expect_run(batch.runs()[0], 1, 0, 2);
+    expect_run(batch.runs()[1], 2, 2, 2);
+}
+
+TEST(SpriteBatchTest, layers_split_runs_unless_the_texture_stays_the_same)
+{
+    Sprite_Batch batch;
+    ASSERT_EQ(batch.add(make_sprite(0.0f, 1, 2)), Status::ok);
+    ASSERT_EQ(batch.add(make_sprite(1.0f, 1, 0)), Status::ok);
+    ASSERT_EQ(batch.add(make_sprite(2.0f, 2, 1)), Status::ok);
+    ASSERT_EQ(batch.add(make_sprite(3.0f, 2, 0)), Status::ok);
+    ASSERT_EQ(batch.add(make_sprite(4.0f, 2, 2)), Status::ok);
+
+    // Layer 0: 1 then 3. Layer 1: 2, same texture as the end of layer 0. Layer 2: 0 then 4.
+    std::vector<f32> const expected = {1.0f, 3.0f, 2.0f, 0.0f, 4.0f};
+    EXPECT_EQ(build_positions(batch), expected);
+    ASSERT_EQ(batch.runs().size(), 4u);
+    expect_run(batch.runs()[0], 1, 0, 1);
+    expect_run(batch.runs()[1], 2, 1, 2);
+    expect_run(batch.runs()[2], 1, 3, 1);
+    expect_run(batch.runs()[3], 2, 4, 1);
+}
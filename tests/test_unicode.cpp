@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "core/platform/unicode.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <string_view>
+#include <vector>
+
+using namespace rk;
+using namespace sds;
+
+RK_INTERNAL
+std::vector<u32> decode_all(std::string_view s)
+{
+    std::vector<u32> cps;
+    size_t pos = 0;
+    while (pos < s.size()) { cps.push_back(unicode::decode_utf8(s, pos)); }
+    return cps;
+}
+
+TEST(UnicodeTest, decode_utf8_valid)
+{
+    EXPECT_EQ(decode_all("abc"), (std::vector<u32>{'a', 'b', 'c'}));
+    // 2, 3 and 4 byte sequences: é, €, 日, 😀
+    EXPECT_EQ(decode_all("\xC3\xA9\xE2\x82\xAC\xE6\x97\xA5\xF0\x9F\x98\x80"),
+              (std::vector<u32>{0xE9, 0x20AC, 0x65E5, 0x1F600}));
+    // Boundaries of each length
+    EXPECT_EQ(decode_all("\x7F\xC2\x80\xDF\xBF\xE0\xA0\x80\xEF\xBF\xBF\xF0\x90\x80\x80"
+                         "\xF4\x8F\xBF\xBF"),
+              (std::vector<u32>{0x7F, 0x80, 0x7FF, 0x800, 0xFFFF, 0x10000, 0x10FFFF}));
+}
+
+TEST(UnicodeTest, decode_utf8_invalid)
+{
+    constexpr u32 r = unicode::replacement_character;
+
+    // Stray continuation byte, then invalid lead bytes
+    EXPECT_EQ(decode_all("\x80" "a"), (std::vector<u32>{r, 'a'}));
+    EXPECT_EQ(decode_all("\xFF\xF8"), (std::vector<u32>{r, r}));
+    // Overlong encodings of '/'
+    EXPECT_EQ(decode_all("\xC0\xAF"), (std::vector<u32>{r, r}));
+    EXPECT_EQ(decode_all("\xE0\x80\xAF"), (std::vector<u32>{r, r, r}));
+    // Surrogate and past U+10FFFF
+    EXPECT_EQ(decode_all("\xED\xA0\x80"), (std::vector<u32>{r, r, r}));
+    EXPECT_EQ(decode_all("\xF4\x90\x80\x80"), (std::vector<u32>{r, r, r, r}));
+    // Truncated and interrupted sequences resume at the next byte
+    EXPECT_EQ(decode_all("\xE2\x82"), (std::vector<u32>{r, r}));
+    EXPECT_EQ(decode_all("\xE2" "a\xC3\xA9"), (std::vector<u32>{r, 'a', 0xE9}));
+}
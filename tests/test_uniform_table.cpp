@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "core/renderer/opengl/uniform_table.h"
+#include "core/types.h"
+#include "tests/common.h"
+#include <string>
+
+using namespace rk;
+using namespace sds;
+
+TEST(UniformTableTest, empty_table_finds_nothing)
+{
+    Uniform_Table table;
+    EXPECT_EQ(table.find("projection"), -1);
+    EXPECT_EQ(table.size(), 0);
+
+    ASSERT_EQ(table.initialize(4), Status::ok);
+    EXPECT_EQ(table.find("projection"), -1);
+}
+
+TEST(UniformTableTest, finds_inserted_names)
+{
+    Uniform_Table table;
+    ASSERT_EQ(table.initialize(3), Status::ok);
+    ASSERT_EQ(table.insert("glyph_bitmap", 0), Status::ok);
+    ASSERT_EQ(table.insert("frustum_planes[0]", 1), Status::ok);
+    ASSERT_EQ(table.insert("frustum_planes", 1), Status::ok);
+
+    EXPECT_EQ(table.size(), 3);
+    EXPECT_EQ(table.find("glyph_bitmap"), 0);
+    EXPECT_EQ(table.find("frustum_planes[0]"), 1);
+    EXPECT_EQ(table.find("frustum_planes"), 1);
+    EXPECT_EQ(table.find("frustum_plane"), -1);
+    EXPECT_EQ(table.find(""), -1);
+}
+
+TEST(UniformTableTest, insert_replaces_location)
+{
+    Uniform_Table table;
+    ASSERT_EQ(table.initialize(1), Status::ok);
+    ASSERT_EQ(table.insert("color", 2), Status::ok);
+    ASSERT_EQ(table.insert("color", 5), Status::ok);
+    EXPECT_EQ(table.size(), 1);
+    EXPECT_EQ(table.find("color"), 5);
+}
+
+TEST(UniformTableTest, grows_past_initial_size)
+{
+    Uniform_Table table;
+    ASSERT_EQ(table.initialize(1), Status::ok);
+    constexpr s32 count = 500;
+    for (s32 i = 0; i < count; ++i) {
+        ASSERT_EQ(table.insert("u_" + std::to_string(i), i), Status::ok);
+    }
+    EXPECT_EQ(table.size(), count);
+    for (s32 i = 0; i < count; ++i) { EXPECT_EQ(table.find("u_" + std::to_string(i)), i); }
+    EXPECT_EQ(table.find("u_" + std::to_string(count)), -1);
+}
+
+TEST(UniformTableTest, initialize_and_clear_empty_the_table)
+{
+    Uniform_Table table;
+    ASSERT_EQ(table.initialize(2), Status::ok);
+    ASSERT_EQ(table.insert("a", 0), Status::ok);
+    ASSERT_EQ(table.initialize(2), Status::ok);
+    EXPECT_EQ(table.find("a"), -1);
+    EXPECT_EQ(table.size(), 0);
+
+    ASSERT_EQ(table.insert("a", 0), Status::ok);
+    table.clear();
+    EXPECT_EQ(table.find("a"), -1);
+    EXPECT_EQ(table.size(), 0);
+}
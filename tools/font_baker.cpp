@@ -0,0 +1,270 @@
+#include "core/logging/logging.h"
+#include "core/platform/stdlib/cstdio.h"
+#include "core/renderer/baked_font.h"
+#include "core/renderer/glyph_cache.h"
+#include "core/renderer/rect_packer.h"
+#include "core/status.h"
+#include "core/types.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+/*
+ * Rasterizes the glyphs of a font ahead of time into a baked font file (see `baked_font.h`), which
+ * the renderer maps at startup instead of running FreeType for every glyph.
+ *
+ * Glyphs are rendered exactly as `Glyph_Cache` renders them at runtime, so glyphs that weren't
+ * baked can be rasterized from the same font file and mixed in.
+ *
+ * usage: rtek_font_baker <font> <output> [--sdf] [--size N] [--spread N] [--atlas N]
+ *                        [--ranges FIRST-LAST,...]
+ *
+ * Ranges are hexadecimal code points, inclusive, in any order. Overlapping ranges are merged.
+ * Defaults to printable ASCII and Latin-1.
+ */
+
+using namespace rk;
+using namespace sds;
+
+/** Empty texels around each glyph, same as `Glyph_Atlas`. */
+constexpr s32 glyph_padding = 1;
+
+struct Code_Point_Range {
+    u32 first;
+    u32 last;
+};
+
+struct Options {
+    char const* font_path = nullptr;
+    char const* output_path = nullptr;
+    Glyph_Cache::Render_Mode mode = Glyph_Cache::Render_Mode::bitmap;
+    s32 pixel_size = 64;
+    s32 sdf_spread = Glyph_Cache::Config{}.sdf_spread;
+    s32 atlas_size = 512;
+    std::vector<Code_Point_Range> ranges;
+};
+
+RK_INTERNAL
+bool parse_int(char const* s, s32 min, s32 max, s32& out)
+{
+    char* end = nullptr;
+    long const value = std::strtol(s, &end, 10);
+    if (end == s || *end != '\0' || value < min || value > max) { return false; }
+    out = static_cast<s32>(value);
+    return true;
+}
+
+RK_INTERNAL
+bool parse_ranges(char const* s, std::vector<Code_Point_Range>& out)
+{
+    while (*s) {
+        char* end = nullptr;
+        u32 const first = static_cast<u32>(std::strtoul(s, &end, 16));
+        if (end == s || *end != '-') { return false; }
+        s = end + 1;
+        u32 const last = static_cast<u32>(std::strtoul(s, &end, 16));
+        if (end == s || first > last || last > 0x10FFFF) { return false; }
+        out.push_back({first, last});
+
+        s = end;
+        if (*s == ',') {
+            ++s;
+        } else if (*s != '\0') {
+            return false;
+        }
+    }
+    return !out.empty();
+}
+
+/**
+ * \brief Sort \a ranges and merge those that overlap or touch, so every code point is baked once
+ * and in order.
+ */
+RK_INTERNAL
+void merge_ranges(std::vector<Code_Point_Range>& ranges)
+{
+    auto const by_first = [](Code_Point_Range const& a, Code_Point_Range const& b) {
+        return a.first < b.first;
+    };
+    std::sort(ranges.begin(), ranges.end(), by_first);
+    size_t merged = 0;
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        Code_Point_Range& last = ranges[merged];
+        if (ranges[i].first <= last.last + 1) {
+            last.last = std::max(last.last, ranges[i].last);
+        } else {
+            ranges[++merged] = ranges[i];
+        }
+    }
+    if (!ranges.empty()) { ranges.resize(merged + 1); }
+}
+
+RK_INTERNAL
+bool parse_options(int argc, char* argv[], Options& opts)
+{
+    for (int i = 1; i < argc; ++i) {
+        char const* arg = argv[i];
+        bool const has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--sdf") == 0) {
+            opts.mode = Glyph_Cache::Render_Mode::sdf;
+        } else if (std::strcmp(arg, "--size") == 0 && has_value) {
+            if (!parse_int(argv[++i], 1, std::numeric_limits<u16>::max(), opts.pixel_size)) {
+                return false;
+            }
+        } else if (std::strcmp(arg, "--spread") == 0 && has_value) {
+            // FreeType's limits
+            if (!parse_int(argv[++i], 2, 32, opts.sdf_spread)) { return false; }
+        } else if (std::strcmp(arg, "--atlas") == 0 && has_value) {
+            if (!parse_int(argv[++i], 1, 8192, opts.atlas_size)) { return false; }
+        } else if (std::strcmp(arg, "--ranges") == 0 && has_value) {
+            if (!parse_ranges(argv[++i], opts.ranges)) { return false; }
+        } else if (arg[0] == '-') {
+            return false;
+        } else if (!opts.font_path) {
+            opts.font_path = arg;
+        } else if (!opts.output_path) {
+            opts.output_path = arg;
+        } else {
+            return false;
+        }
+    }
+
+    if (opts.ranges.empty()) { opts.ranges = {{0x20, 0x7E}, {0xA0, 0xFF}}; }
+    merge_ranges(opts.ranges);
+    return opts.font_path && opts.output_path;
+}
+
+RK_INTERNAL
+Status bake_glyphs(FT_Face face, Options const& opts, std::vector<Baked_Glyph>& glyphs,
+                   std::vector<u8>& atlas)
+{
+    s32 const atlas_size = opts.atlas_size;
+    Rect_Packer packer;
+    RK_CHECK(packer.initialize(atlas_size, atlas_size));
+    atlas.assign(static_cast<size_t>(atlas_size) * atlas_size, 0);
+
+    FT_Render_Mode const ft_mode =
+        (opts.mode == Glyph_Cache::Render_Mode::sdf ? FT_RENDER_MODE_SDF : FT_RENDER_MODE_NORMAL);
+    for (Code_Point_Range const& range : opts.ranges) {
+        for (u32 codepoint = range.first; codepoint <= range.last; ++codepoint) {
+            // Missing glyphs are left to the runtime fallback, which gives the missing glyph
+            if (FT_Get_Char_Index(face, codepoint) == 0) { continue; }
+            if (FT_Load_Char(face, codepoint, FT_LOAD_DEFAULT) ||
+                FT_Render_Glyph(face->glyph, ft_mode)) {
+                LOG_WARN("Failed to render U+{:04X}, skipped", codepoint);
+                continue;
+            }
+
+            FT_GlyphSlot const slot = face->glyph;
+            FT_Bitmap const& bitmap = slot->bitmap;
+            s32 const width = static_cast<s32>(bitmap.width);
+            s32 const height = static_cast<s32>(bitmap.rows);
+
+            Baked_Glyph glyph = {};
+            glyph.codepoint = codepoint;
+            glyph.width = static_cast<u16>(width);
+            glyph.height = static_cast<u16>(height);
+            glyph.bearing_x = static_cast<s16>(slot->bitmap_left);
+            glyph.bearing_y = static_cast<s16>(slot->bitmap_top);
+            glyph.advance = static_cast<s32>(slot->advance.x);
+
+            if (width > 0 && height > 0) {
+                Rect rect;
+                if (!packer.pack(width + 2 * glyph_padding, height + 2 * glyph_padding, rect)) {
+                    LOG_ERROR("Atlas of {}x{} is full at U+{:04X}, use a larger --atlas",
+                              atlas_size, atlas_size, codepoint);
+                    return Status::buffer_length_error;
+                }
+                glyph.x = static_cast<u16>(rect.x + glyph_padding);
+                glyph.y = static_cast<u16>(rect.y + glyph_padding);
+                for (s32 row = 0; row < height; ++row) {
+                    std::memcpy(&atlas[static_cast<size_t>(glyph.y + row) * atlas_size + glyph.x],
+                                bitmap.buffer + row * bitmap.pitch, width);
+                }
+            }
+            glyphs.push_back(glyph);
+        }
+    }
+    return Status::ok;
+}
+
+RK_INTERNAL
+Status bake_font(Options const& opts)
+{
+    FT_Library ft = nullptr;
+    if (FT_Init_FreeType(&ft)) {
+        LOG_ERROR("Failed to initialize FreeType");
+        return Status::api_error;
+    }
+    FT_Face face = nullptr;
+    Status ret = Status::ok;
+    std::vector<Baked_Glyph> glyphs;
+    std::vector<u8> atlas;
+
+    for (char const* module : {"sdf", "bsdf"}) {
+        if (FT_Property_Set(ft, module, "spread", &opts.sdf_spread)) {
+            LOG_ERROR("Failed to set {} spread to {}", module, opts.sdf_spread);
+            ret = Status::invalid_value;
+        }
+    }
+    if (ret == Status::ok && (FT_New_Face(ft, opts.font_path, 0, &face) ||
+                              FT_Select_Charmap(face, FT_ENCODING_UNICODE) ||
+                              FT_Set_Pixel_Sizes(face, 0, opts.pixel_size))) {
+        LOG_ERROR("Failed to load font '{}' at {} pixels", opts.font_path, opts.pixel_size);
+        ret = Status::io_error;
+    }
+    if (ret == Status::ok) { ret = bake_glyphs(face, opts, glyphs, atlas); }
+    if (face) { FT_Done_Face(face); }
+    FT_Done_FreeType(ft);
+    RK_CHECK(ret);
+
+    Baked_Font_Header header;
+    header.pixel_size = static_cast<u32>(opts.pixel_size);
+    header.render_mode = static_cast<u32>(opts.mode);
+    header.sdf_spread = static_cast<u32>(opts.sdf_spread);
+    header.atlas_size = static_cast<u32>(opts.atlas_size);
+    std::vector<u8> data;
+    RK_CHECK(serialize_baked_font(header, glyphs, atlas.data(), data));
+
+    FILE* file = rk::fopen(opts.output_path, "wb");
+    if (!file) {
+        LOG_ERROR("Failed to open '{}' for writing", opts.output_path);
+        return Status::io_error;
+    }
+    size_t const written = std::fwrite(data.data(), 1, data.size(), file);
+    if (std::fclose(file) != 0 || written != data.size()) {
+        LOG_ERROR("Failed to write '{}'", opts.output_path);
+        return Status::io_error;
+    }
+
+    LOG_INFO("Baked {} glyphs of '{}' into '{}' ({} bytes)", glyphs.size(), opts.font_path,
+             opts.output_path, data.size());
+    return Status::ok;
+}
+
+int main(int argc, char* argv[])
+{
+    if (Logger::initialize() != Status::ok) { return 1; }
+
+    Options opts;
+    if (!parse_options(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: rtek_font_baker <font> <output> [--sdf] [--size N] "
+                             "[--spread N] [--atlas N] [--ranges FIRST-LAST,...]\n");
+        return 2;
+    }
+
+    Status const ret = bake_font(opts);
+    if (ret != Status::ok) {
+        LOG_ERROR("exited with status: {}", to_string(ret));
+        return 1;
+    }
+    return 0;
+}